@@ -81,62 +81,229 @@ double AzLoss::getLoss(AzLossType loss_type,
   return loss; 
 }
 
-/*--------------------------------------------------------*/
-AzLosses AzLoss::getLosses(AzLossType loss_type, 
-                           double p, double y, 
-                           double py_adjust)
-{
-  const char *eyec = "AzLoss::getLosses"; 
-
-  AzLosses o; 
-
-  if (loss_type == AzLoss_Square || 
-           loss_type == AzLoss_LS) {
-    double r = y-p; /* residual */
-    o.loss2 = 1; 
-    o._loss1 = r; 
-  }
-  else if (loss_type == AzLoss_Expo) { /* y in {+1,-1} */
+/*------------------------------------------------------------------*/
+/* 
+ * Derivatives for one data point, one class for each loss type. 
+ * deriv() sets -L' and L''.  
+ * The loops in AzLossKernel are instantiated for each of them 
+ * so that the loss type is not checked for each data point. 
+ */
+class AzLossDeriv_Square {
+public: 
+  inline static void deriv(double p, double y, double py_adjust, 
+                           double &nega_d1, double &d2) {
+    nega_d1 = y-p; /* residual */
+    d2 = 1; 
+  }
+}; 
+class AzLossDeriv_Expo { /* y in {+1,-1} */
+public: 
+  inline static void deriv(double p, double y, double py_adjust, 
+                           double &nega_d1, double &d2) {
+    double py = p*y - py_adjust; /* py_adjust for numerical stability */
+    double ee = my_exp(-py); 
+    d2 = ee*y*y; 
+    nega_d1 = y*ee; 
+  }
+}; 
+/*---  the optimizer has always used exp(-py) as L'' (the same as above for y in {+1,-1})  ---*/
+class AzLossDeriv_Expo_forOpt {
+public: 
+  inline static void deriv(double p, double y, double py_adjust, 
+                           double &nega_d1, double &d2) {
     double py = p*y - py_adjust; 
     double ee = my_exp(-py); 
-    o.loss2 = ee*y*y; 
-    o._loss1 = y*ee; 
-  }
-  else if (loss_type == AzLoss_Logistic1) {  
+    d2 = ee; 
+    nega_d1 = y*ee; 
+  }
+}; 
+class AzLossDeriv_Logistic1 {
+public: 
+  inline static void deriv(double p, double y, double py_adjust, 
+                           double &nega_d1, double &d2) {
     double py = p*y; 
     double ee = my_exp(-py);  
-    o.loss2 = y*y*ee/(1+ee)/(1+ee); 
-    o._loss1 = y*ee/(1+ee); 
-  }
-  else if (loss_type == AzLoss_LogRe) {  
+    d2 = y*y*ee/(1+ee)/(1+ee); 
+    nega_d1 = y*ee/(1+ee); 
+  }
+}; 
+class AzLossDeriv_LogRe {
+public: 
+  inline static void deriv(double p, double y, double py_adjust, 
+                           double &nega_d1, double &d2) {
     double ee = my_exp(-p);  
     double q = 1/(1+ee); 
-    o.loss2 = q*(1-q); 
-    o._loss1 = y - q; 
-  }
-  else if (loss_type == AzLoss_LogRe2) {
+    d2 = q*(1-q); 
+    nega_d1 = y - q; 
+  }
+}; 
+class AzLossDeriv_LogRe2 {
+public: 
+  inline static void deriv(double p, double y, double py_adjust, 
+                           double &nega_d1, double &d2) {
     double aa = 1; 
     double ee = my_exp(-aa*(p-y));  
     double q = 1/(1+ee); 
-    o.loss2 = 2*aa*q*(1-q); 
-    o._loss1 = 1 - 2*q; 
-  }
-  else if (loss_type == AzLoss_Logistic2) {
+    d2 = 2*aa*q*(1-q); 
+    nega_d1 = 1 - 2*q; 
+  }
+}; 
+class AzLossDeriv_Logistic2 {
+public: 
+  inline static void deriv(double p, double y, double py_adjust, 
+                           double &nega_d1, double &d2) {
     double py = p*y; 
     double ee = my_exp(-2*py); 
-    o.loss2 = 4*y*y*ee/(1+ee)/(1+ee); 
-    o._loss1 = 2*y*ee/(1+ee); 
+    d2 = 4*y*y*ee/(1+ee)/(1+ee); 
+    nega_d1 = 2*y*ee/(1+ee); 
   }
-  else {
+}; 
+
+/*------------------------------------------------------------------*/
+/* 
+ * The data points are processed in blocks: p and y are gathered 
+ * through the data indexes first, and then the derivatives are 
+ * computed in a loop without indirection.  The sums are taken in 
+ * the order of the data indexes as before.  
+ */
+template<class D>
+class AzLossKernel_ {
+protected:
+  static const int block_size = 256; 
+
+public: 
+  static void sum_deriv(const int *dxs, int dx_num, 
+                        const double *p, const double *y, 
+                        const double *dw, /* may be NULL */
+                        double py_adjust, 
+                        double &nega_dL, double &ddL) {
+    nega_dL = ddL = 0; 
+    double pp[block_size], yy[block_size], ww[block_size]; 
+    int bx; 
+    for (bx = 0; bx < dx_num; bx += block_size) {
+      int num = MIN(block_size, dx_num - bx); 
+      const int *bdxs = dxs + bx; 
+      int ix; 
+      for (ix = 0; ix < num; ++ix) {
+        int dx = bdxs[ix]; 
+        pp[ix] = p[dx]; 
+        yy[ix] = y[dx]; 
+      }
+      if (dw == NULL) {
+        for (ix = 0; ix < num; ++ix) {
+          double d1, d2; 
+          D::deriv(pp[ix], yy[ix], py_adjust, d1, d2); 
+          nega_dL += d1; 
+          ddL += d2; 
+        }
+      }
+      else {
+        for (ix = 0; ix < num; ++ix) ww[ix] = dw[bdxs[ix]]; 
+        for (ix = 0; ix < num; ++ix) {
+          double d1, d2; 
+          D::deriv(pp[ix], yy[ix], py_adjust, d1, d2); 
+          nega_dL += ww[ix]*d1; 
+          ddL += ww[ix]*d2; 
+        }
+      }
+    }
+  }
+
+  static void deriv12(const int *dxs, /* NULL: all */
+                      int dx_num, 
+                      const double *p, const double *y, 
+                      double py_adjust, 
+                      double *out1,  /* -L' */
+                      double *out2) { /* L'': may be NULL */
+    if (dxs == NULL) {
+      int dx; 
+      for (dx = 0; dx < dx_num; ++dx) {
+        double d1, d2; 
+        D::deriv(p[dx], y[dx], py_adjust, d1, d2); 
+        out1[dx] = d1; 
+        if (out2 != NULL) out2[dx] = d2; 
+      }
+      return; 
+    }
+    double pp[block_size], yy[block_size], o1[block_size], o2[block_size]; 
+    int bx; 
+    for (bx = 0; bx < dx_num; bx += block_size) {
+      int num = MIN(block_size, dx_num - bx); 
+      const int *bdxs = dxs + bx; 
+      int ix; 
+      for (ix = 0; ix < num; ++ix) {
+        int dx = bdxs[ix]; 
+        pp[ix] = p[dx]; 
+        yy[ix] = y[dx]; 
+      }
+      for (ix = 0; ix < num; ++ix) {
+        D::deriv(pp[ix], yy[ix], py_adjust, o1[ix], o2[ix]); 
+      }
+      for (ix = 0; ix < num; ++ix) out1[bdxs[ix]] = o1[ix]; 
+      if (out2 != NULL) {
+        for (ix = 0; ix < num; ++ix) out2[bdxs[ix]] = o2[ix]; 
+      }
+    }
+  }
+}; 
+
+/*------------------------------------------------------------------*/
+class AzLossKernel {
+public:
+  void (*sum_deriv)(const int *dxs, int dx_num, 
+                    const double *p, const double *y, const double *dw, 
+                    double py_adjust, double &nega_dL, double &ddL); 
+  void (*deriv12)(const int *dxs, int dx_num, 
+                  const double *p, const double *y, double py_adjust, 
+                  double *out1, double *out2); 
+}; 
+#define AzLossKernel_entry(D) { AzLossKernel_<D>::sum_deriv, AzLossKernel_<D>::deriv12 }
+#define AzLossKernel_entry2(Dsum,D12) { AzLossKernel_<Dsum>::sum_deriv, AzLossKernel_<D12>::deriv12 }
+#define AzLossKernel_none { NULL, NULL }
+
+/*---  indexed by AzLossType  ---*/
+static const AzLossKernel loss_kernels[AzLossType_Num] = {
+  /* ModHuber */  AzLossKernel_none, 
+  /* Log   */     AzLossKernel_entry(AzLossDeriv_Logistic1), 
+  /* Expo  */     AzLossKernel_entry2(AzLossDeriv_Expo_forOpt, AzLossDeriv_Expo), 
+  /* ModLS */     AzLossKernel_none, 
+  /* LS   */      AzLossKernel_entry(AzLossDeriv_Square), 
+  /* Huber */     AzLossKernel_none, 
+  /* DummyLS */   AzLossKernel_entry(AzLossDeriv_Square), 
+  /* Logit */     AzLossKernel_entry(AzLossDeriv_Logistic2), 
+  /* LogRe */     AzLossKernel_entry(AzLossDeriv_LogRe), 
+  /* LogRe2 */    AzLossKernel_entry(AzLossDeriv_LogRe2), 
+  /* L1L2 */      AzLossKernel_none, 
+  /* Xtemp */     AzLossKernel_none, 
+  /* None" */     AzLossKernel_none, 
+}; 
+
+/*------------------------------------------------------------------*/
+static const AzLossKernel *loss_kernel(AzLossType loss_type, 
+                                       const char *eyec)
+{
+  if (loss_type < 0 || loss_type >= AzLossType_Num || 
+      loss_kernels[loss_type].sum_deriv == NULL) {
     throw new AzException(eyec, "unsupported loss type"); 
   }
+  return &loss_kernels[loss_type]; 
+}
+
+/*--------------------------------------------------------*/
+AzLosses AzLoss::getLosses(AzLossType loss_type, 
+                           double p, double y, 
+                           double py_adjust)
+{
+  AzLosses o; 
+  loss_kernel(loss_type, "AzLoss::getLosses")->deriv12(NULL, 1, &p, &y, py_adjust, 
+                                                      &o._loss1, &o.loss2); 
   return o; 
 }
 
 /*------------------------------------------------------------------*/
 /* 
  * This is for speeding up AzOptOntTree.  It's the same as calling 
- * getLosses from the loop but faster especially for square loss. 
+ * getLosses from the loop but faster. 
  *
  */
 void AzLoss::sum_deriv(AzLossType loss_type, 
@@ -149,49 +316,11 @@ void AzLoss::sum_deriv(AzLossType loss_type,
                        double &nega_dL, 
                        double &ddL) 
 {
-  nega_dL = 0; 
-  ddL = 0; 
-  if (loss_type == AzLoss_Square || 
-      loss_type == AzLoss_LS) {
-    /* double r = y-p; */
-    /* o.loss2 = 1; */
-    /* o._loss1 = r; */
-    ddL = (double)dx_num; 
-    int ix; 
-    for (ix = 0; ix < dx_num; ++ix) {
-      int dx = dxs[ix]; 
-      nega_dL += (y[dx]-p[dx]); 
-    }
-  }
-  else if (loss_type == AzLoss_Expo) {
-    int ix; 
-    for (ix = 0; ix < dx_num; ++ix) {
-      int dx = dxs[ix];       
-      double py = p[dx]*y[dx]; 
-      py -= py_avg; /* for numerical stability */
-      double ee = my_exp(-py); 
-      ddL += ee;            /* exp(-py)*y*y */
-      nega_dL += y[dx]*ee;  /* exp(-py)*y */
-    }
-  }
-  else {
-    int ix; 
-    for (ix = 0; ix < dx_num; ++ix) {
-      int dx = dxs[ix]; 
-      AzLosses o = getLosses(loss_type, p[dx], y[dx], py_avg); 
-      ddL += o.loss2; 
-      nega_dL += o._loss1; 
-    }
-    /* throw new AzException("AzLoss::sum_deriv", "unsupported loss type"); */
-  }
+  loss_kernel(loss_type, "AzLoss::sum_deriv")->sum_deriv(dxs, dx_num, p, y, NULL, py_avg, 
+                                                         nega_dL, ddL); 
 }
 
 /*------------------------------------------------------------------*/
-/* 
- * This is for speeding up AzOptOntTree.  It's the same as calling 
- * getLosses from the loop but faster especially for square loss. 
- *
- */
 void AzLoss::sum_deriv_weighted(AzLossType loss_type, 
                        const int *dxs, 
                        int dx_num, 
@@ -203,41 +332,23 @@ void AzLoss::sum_deriv_weighted(AzLossType loss_type,
                        double &nega_dL, 
                        double &ddL) 
 {
-  nega_dL = 0; 
-  ddL = 0; 
-  if (loss_type == AzLoss_Square || 
-      loss_type == AzLoss_LS) {
-    /* double r = y-p; */
-    /* o.loss2 = 1; */
-    /* o._loss1 = r; */
-    int ix; 
-    for (ix = 0; ix < dx_num; ++ix) {
-      int dx = dxs[ix]; 
-      nega_dL += dw[dx]*(y[dx]-p[dx]); 
-      ddL += dw[dx]; 
-    }
-  }
-  else if (loss_type == AzLoss_Expo) {
-    int ix; 
-    for (ix = 0; ix < dx_num; ++ix) {
-      int dx = dxs[ix];       
-      double py = p[dx]*y[dx]; 
-      py -= py_avg; /* for numerical stability */
-      double ee = my_exp(-py); 
-      ddL += (dw[dx]*ee);            /* exp(-py)*y*y */
-      nega_dL += (dw[dx]*y[dx]*ee);  /* exp(-py)*y */
-    }
-  }
-  else {
-    int ix; 
-    for (ix = 0; ix < dx_num; ++ix) {
-      int dx = dxs[ix]; 
-      AzLosses o = getLosses(loss_type, p[dx], y[dx], py_avg); 
-      ddL += (dw[dx]*o.loss2); 
-      nega_dL += (dw[dx]*o._loss1); 
-    }
-    /* throw new AzException("AzLoss::sum_deriv_weighted", "unsupported loss type"); */
-  }
+  loss_kernel(loss_type, "AzLoss::sum_deriv_weighted")->sum_deriv(dxs, dx_num, p, y, dw, py_avg, 
+                                                                  nega_dL, ddL); 
+}
+
+/*------------------------------------------------------------------*/
+void AzLoss::deriv12(AzLossType loss_type, 
+                     const int *dxs, 
+                     int dx_num, 
+                     const double *p, 
+                     const double *y, 
+                     double py_adjust, 
+                     /*---  output  ---*/
+                     double *out1, 
+                     double *out2)
+{
+  loss_kernel(loss_type, "AzLoss::deriv12")->deriv12(dxs, dx_num, p, y, py_adjust, 
+                                                     out1, out2); 
 }
 
 /*------------------------------------------------------------------*/
@@ -349,18 +460,7 @@ double AzLoss::negativeDeriv12(AzLossType loss_type,
   if (ia_dx != NULL) {
     dxs = ia_dx->point(&dx_num); 
   }
-  int ix; 
-  for (ix = 0; ix < dx_num; ++ix) {
-    int dx = ix; 
-    if (dxs != NULL) dx = dxs[ix]; 
-
-    AzLosses o; 
-    o = getLosses(loss_type, p[dx], y[dx], py_adjust); 
-    out1[dx] = o._loss1; 
-    if (out2 != NULL) {
-      out2[dx] = o.loss2; 
-    }
-  }
+  deriv12(loss_type, dxs, dx_num, p, y, py_adjust, out1, out2); 
 
   double lam_scale = 1; 
   if (py_adjust != 0) {
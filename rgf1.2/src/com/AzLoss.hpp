@@ -119,6 +119,17 @@ public:
                        double &nega_dL, 
                        double &ddL); 
 
+  /*---  out1[dx] <- -L', out2[dx] <- L'' for dx in dxs (NULL: 0..dx_num-1)  ---*/
+  static void deriv12(AzLossType loss_type, 
+                       const int *dxs, /* may be NULL */
+                       int dx_num, 
+                       const double *p, 
+                       const double *y, 
+                       double py_adjust, 
+                       /*---  output  ---*/
+                       double *out1, 
+                       double *out2); /* may be NULL */
+
   static AzLosses getLosses(AzLossType loss_type, 
                             double p, double y, 
                             double py_adjust=0); 
@@ -28,10 +28,11 @@
 enum AzPerfType {
   AzPerfType_Acc = 0, 
   AzPerfType_RMSE = 1, 
+  AzPerfType_Loss = 2, 
 }; 
-#define AzPerfType_Num 2
+#define AzPerfType_Num 3
 static const char *perf_str[AzPerfType_Num] = {
-  "acc", "rmse", 
+  "acc", "rmse", "loss", 
 }; 
 
 /*--------------------------------------------------*/
@@ -56,6 +57,7 @@ public:
   double getPerf(AzPerfType p_type) {
     if (p_type == AzPerfType_Acc) return acc; 
     if (p_type == AzPerfType_RMSE) return rmse; 
+    if (p_type == AzPerfType_Loss) return loss; 
     return -1; 
   }
   static const char *getPerfStr(AzPerfType p_type) {
@@ -70,7 +72,7 @@ public:
     if (p < 0) return false; 
     if (comp_p < 0) return true; 
 
-    if (p_type == AzPerfType_RMSE) {
+    if (p_type == AzPerfType_RMSE || p_type == AzPerfType_Loss) {
       if (p < comp_p) return true; 
     }
     else {
@@ -721,15 +721,17 @@ void AzSvect::_swap()
   }
 
   AZI_VECT_ELM dummy; 
-  if (sizeof(dummy.val) != sizeof(double)) {
-    throw new AzException("AzSvect::_swap", "value is not double?!"); 
+  bool isDouble = (sizeof(dummy.val) == sizeof(double)); 
+  if (!isDouble && sizeof(dummy.val) != sizeof(int)) {
+    throw new AzException("AzSvect::_swap", "value is neither double nor float?!"); 
   }
 
   int ex; 
   for (ex = 0; ex < elm_num; ++ex) {
     AZI_VECT_ELM *ep = &elm[ex];  
     AzFile::swap_int4(&ep->no); 
-    AzFile::swap_double(&ep->val); 
+    if (isDouble) AzFile::swap_double((double *)&ep->val); 
+    else          AzFile::swap_int4((int *)&ep->val); /* float */
   }
 }
 
@@ -1747,6 +1749,26 @@ void AzSvect::load(const AzIFarr *ifa_row_val)
   }
 }
 
+/*-------------------------------------------------------------*/
+void AzSvect::load(const AZI_VECT_ELM *inp, int num) 
+{
+  const char *eyec = "AzSvect::load(elm)"; 
+  clear_prepare(num); 
+  int prev_row = -1; 
+  int ix; 
+  for (ix = 0; ix < num; ++ix) {
+    int row = inp[ix].no; 
+    if (row < 0 || row >= row_num || /* out of range */
+        row <= prev_row) { /* out of order */
+      throw new AzException(eyec, "Invalid input"); 
+    }
+    elm[elm_num].no = row; 
+    elm[elm_num].val = inp[ix].val; 
+    ++elm_num; 
+    prev_row = row; 
+  }
+}
+
 /*-------------------------------------------------------------*/
 bool AzSmat::isSame(const AzSmat *inp) const
 {
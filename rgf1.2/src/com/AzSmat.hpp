@@ -25,7 +25,13 @@
 #include "AzReadOnlyMatrix.hpp"
 
 /* Changed AZ_MTX_FLOAT from single-precision to double-precision  */
+/* Define _AZ_FLOAT_MATRIX_ to store the values in single-precision */
+/* to save memory.  Computation is done in double-precision.        */
+#ifdef _AZ_FLOAT_MATRIX_
+typedef float AZ_MTX_FLOAT; 
+#else
 typedef double AZ_MTX_FLOAT; 
+#endif
 #define _checkVal(x) 
 /* static double _too_large_ = 16777216; */
 /* static double _too_small_ = -16777216; */
@@ -53,6 +59,7 @@ public:
   friend class AzDmat; 
   friend class AzDvect; 
   friend class AzPmatSpa; 
+  friend class AzSmatc; 
   
   AzSvect() : row_num(0), elm(NULL), elm_num(0) {}
   AzSvect(int inp_row_num, bool asDense=false) : row_num(0), elm(NULL), elm_num(0) {
@@ -100,6 +107,7 @@ public:
     ifa_row_val->sort_Int(true); 
     load((const AzIFarr *)ifa_row_val); 
   }   
+  void load(const AZI_VECT_ELM *inp, int num); /* must be sorted by row */
   bool isZero() const;
   bool isOneOrZero() const; 
 
@@ -362,6 +370,9 @@ public:
   inline void load(int col, AzIFarr *ifa_row_val) {
     col_u(col)->load(ifa_row_val); 
   }
+  inline void load(int col, const AZI_VECT_ELM *inp, int num) { /* sorted by row */
+    col_u(col)->load(inp, num); 
+  }
 
   void clear(); 
   void zeroOut(); 
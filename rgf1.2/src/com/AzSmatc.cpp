@@ -0,0 +1,347 @@
+/* * * * *
+ *  AzSmatc.cpp
+ *  Copyright (C) 2011, 2012 Rie Johnson
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * */
+
+#include "AzSmatc.hpp"
+
+/*-------------------------------------------------------------*/
+void AzSmatc::reset()
+{
+  a_view.free(&view); 
+  a_be.free(&be); 
+  a_elm.free(&elm); 
+  row_num = col_num = filled_num = 0; 
+  elm_num = 0; 
+}
+
+/*-------------------------------------------------------------*/
+void AzSmatc::reform(int inp_row_num, int inp_col_num, AZint8 elm_num_max)
+{
+  const char *eyec = "AzSmatc::reform"; 
+  if (inp_row_num < 0 || inp_col_num < 0) {
+    throw new AzException(eyec, "#row and #col must be non-negative"); 
+  }
+  reset(); 
+  row_num = inp_row_num; 
+  col_num = inp_col_num; 
+  a_be.alloc(&be, col_num+1, eyec, "be"); 
+  be[0] = 0; 
+  a_view.alloc(&view, col_num, eyec, "view"); 
+  int cx; 
+  for (cx = 0; cx < col_num; ++cx) view[cx].row_num = row_num; 
+  if (elm_num_max > 0) a_elm.alloc(&elm, elm_num_max, eyec, "elm"); 
+}
+
+/*-------------------------------------------------------------*/
+/* mark the columns before cx as loaded (empty if not yet) */
+void AzSmatc::fill_to(int cx)
+{
+  if (cx < filled_num || cx >= col_num) {
+    throw new AzException("AzSmatc::fill_to", "column# is out of order or out of range"); 
+  }
+  for ( ; filled_num < cx; ++filled_num) {
+    be[filled_num+1] = elm_num; 
+    resetView(filled_num); 
+  }
+}
+
+/*-------------------------------------------------------------*/
+void AzSmatc::prepare(AZint8 num)
+{
+  AZint8 elm_num_max = a_elm.size(); 
+  if (elm_num + num <= elm_num_max) return; 
+
+  elm_num_max = MAX(elm_num + num, elm_num_max*2); 
+  a_elm.realloc(&elm, elm_num_max, "AzSmatc::prepare", "elm"); 
+
+  /*---  the array has moved  ---*/
+  int cx; 
+  for (cx = 0; cx < filled_num; ++cx) resetView(cx); 
+}
+
+/*-------------------------------------------------------------*/
+void AzSmatc::trim()
+{
+  if (a_elm.size() == elm_num) return; 
+  a_elm.realloc(&elm, elm_num, "AzSmatc::trim", "elm"); 
+  int cx; 
+  for (cx = 0; cx < filled_num; ++cx) resetView(cx); 
+}
+
+/*-------------------------------------------------------------*/
+void AzSmatc::resetView(int cx)
+{
+  AzSvect *v = &view[cx]; 
+  AZint8 begin = col_begin(cx), end = col_end(cx); 
+  v->elm_num = (int)(end - begin); 
+  v->elm = (v->elm_num > 0) ? elm + begin : NULL; 
+}
+
+/*-------------------------------------------------------------*/
+void AzSmatc::load(int cx, const AzIFarr *ifa_row_val)
+{
+  const char *eyec = "AzSmatc::load"; 
+  fill_to(cx); 
+  int num = ifa_row_val->size(); 
+  prepare(num); 
+  int prev_row = -1; 
+  int ix; 
+  for (ix = 0; ix < num; ++ix) {
+    int row; 
+    double val = ifa_row_val->get(ix, &row); 
+    if (row < 0 || row >= row_num || /* out of range */
+        row <= prev_row) { /* out of order */
+      throw new AzException(eyec, "Invalid input"); 
+    }
+    elm[elm_num].no = row; 
+    elm[elm_num].val = (AZ_MTX_FLOAT)val; 
+    ++elm_num; 
+    prev_row = row; 
+  }
+  be[++filled_num] = elm_num; 
+  resetView(cx); 
+}
+
+/*-------------------------------------------------------------*/
+void AzSmatc::load(int cx, const AzSvect *v)
+{
+  if (v->row_num != row_num) {
+    throw new AzException("AzSmatc::load(AzSvect)", "#row conflict"); 
+  }
+  fill_to(cx); 
+  prepare(v->elm_num); 
+  int ex; 
+  for (ex = 0; ex < v->elm_num; ++ex) {
+    if (v->elm[ex].val != 0) elm[elm_num++] = v->elm[ex]; 
+  }
+  be[++filled_num] = elm_num; 
+  resetView(cx); 
+}
+
+/*-------------------------------------------------------------*/
+void AzSmatc::load(int cx, const AZI_VECT_ELM *inp, int num)
+{
+  const char *eyec = "AzSmatc::load(elm)"; 
+  fill_to(cx); 
+  prepare(num); 
+  int prev_row = -1; 
+  int ix; 
+  for (ix = 0; ix < num; ++ix) {
+    int row = inp[ix].no; 
+    if (row < 0 || row >= row_num || /* out of range */
+        row <= prev_row) { /* out of order */
+      throw new AzException(eyec, "Invalid input"); 
+    }
+    elm[elm_num].no = row; 
+    elm[elm_num].val = inp[ix].val; 
+    ++elm_num; 
+    prev_row = row; 
+  }
+  be[++filled_num] = elm_num; 
+  resetView(cx); 
+}
+
+/*-------------------------------------------------------------*/
+void AzSmatc::set(const AzSmat *inp)
+{
+  AZint8 num = 0; 
+  int cx; 
+  for (cx = 0; cx < inp->colNum(); ++cx) num += inp->col(cx)->nonZeroRowNum(); 
+  reform(inp->rowNum(), inp->colNum(), num); 
+  for (cx = 0; cx < col_num; ++cx) load(cx, inp->col(cx)); 
+}
+
+/*-------------------------------------------------------------*/
+void AzSmatc::copy_to(AzSmat *m_out) const
+{
+  m_out->reform(row_num, col_num); 
+  int cx; 
+  for (cx = 0; cx < col_num; ++cx) {
+    if (view[cx].elm_num > 0) m_out->col_u(cx)->set(&view[cx]); 
+  }
+}
+
+/*-------------------------------------------------------------*/
+/* Two passes: count the elements of each output column and     */
+/* then place them; the rows within a column come out in order. */
+void AzSmatc::transpose_from(const AzSmat *m_inp)
+{
+  const char *eyec = "AzSmatc::transpose_from"; 
+  int inp_col_num = m_inp->colNum(), inp_row_num = m_inp->rowNum(); 
+  AZint8 num = 0; 
+  AzBaseArray<AZint8> a_count; 
+  AZint8 *count = NULL; 
+  a_count.alloc(&count, inp_row_num+1, eyec, "count"); 
+  int rx; 
+  for (rx = 0; rx <= inp_row_num; ++rx) count[rx] = 0; 
+  int cx; 
+  for (cx = 0; cx < inp_col_num; ++cx) {
+    const AzSvect *v = m_inp->col(cx); 
+    int ex; 
+    for (ex = 0; ex < v->elm_num; ++ex) {
+      if (v->elm[ex].val != 0) {
+        ++count[v->elm[ex].no + 1]; 
+        ++num; 
+      }
+    }
+  }
+
+  reform(inp_col_num, inp_row_num, num); 
+  for (rx = 0; rx < inp_row_num; ++rx) count[rx+1] += count[rx]; 
+  for (rx = 0; rx <= inp_row_num; ++rx) be[rx] = count[rx]; 
+  for (cx = 0; cx < inp_col_num; ++cx) {
+    const AzSvect *v = m_inp->col(cx); 
+    int ex; 
+    for (ex = 0; ex < v->elm_num; ++ex) {
+      if (v->elm[ex].val != 0) {
+        AZI_VECT_ELM *e = &elm[count[v->elm[ex].no]++]; 
+        e->no = cx; 
+        e->val = v->elm[ex].val; 
+      }
+    }
+  }
+  elm_num = num; 
+  filled_num = col_num; 
+  for (rx = 0; rx < col_num; ++rx) resetView(rx); 
+}
+
+/*-------------------------------------------------------------*/
+/* Same as above, but the input columns are read in place. */
+void AzSmatc::transpose_from(const AzSmatc *m_inp, 
+                             const AzIntArr *ia_cols) /* may be NULL */
+{
+  const char *eyec = "AzSmatc::transpose_from(AzSmatc)"; 
+  if (m_inp == this) {
+    throw new AzException(eyec, "input must be another matrix"); 
+  }
+  const int *cols = (ia_cols == NULL) ? NULL : ia_cols->point(); 
+  int num = (ia_cols == NULL) ? m_inp->colNum() : ia_cols->size(); 
+  int inp_row_num = m_inp->rowNum(); 
+  AZint8 e_num = 0; 
+  AzBaseArray<AZint8> a_count; 
+  AZint8 *count = NULL; 
+  a_count.alloc(&count, inp_row_num+1, eyec, "count"); 
+  int rx; 
+  for (rx = 0; rx <= inp_row_num; ++rx) count[rx] = 0; 
+  int ix; 
+  for (ix = 0; ix < num; ++ix) {
+    const AzSvect *v = m_inp->col((cols == NULL) ? ix : cols[ix]); 
+    int ex; 
+    for (ex = 0; ex < v->elm_num; ++ex) {
+      if (v->elm[ex].val != 0) {
+        ++count[v->elm[ex].no + 1]; 
+        ++e_num; 
+      }
+    }
+  }
+
+  reform(num, inp_row_num, e_num); 
+  for (rx = 0; rx < inp_row_num; ++rx) count[rx+1] += count[rx]; 
+  for (rx = 0; rx <= inp_row_num; ++rx) be[rx] = count[rx]; 
+  for (ix = 0; ix < num; ++ix) {
+    const AzSvect *v = m_inp->col((cols == NULL) ? ix : cols[ix]); 
+    int ex; 
+    for (ex = 0; ex < v->elm_num; ++ex) {
+      if (v->elm[ex].val != 0) {
+        AZI_VECT_ELM *e = &elm[count[v->elm[ex].no]++]; 
+        e->no = ix; 
+        e->val = v->elm[ex].val; 
+      }
+    }
+  }
+  elm_num = e_num; 
+  filled_num = col_num; 
+  for (rx = 0; rx < col_num; ++rx) resetView(rx); 
+}
+
+/*-------------------------------------------------------------*/
+double AzSmatc::get(int row, int cx) const
+{
+  if (row < 0 || row >= row_num || cx < 0 || cx >= col_num) {
+    throw new AzException("AzSmatc::get", "out of range"); 
+  }
+  AZint8 lo = col_begin(cx), hi = col_end(cx) - 1; 
+  for ( ; lo <= hi; ) {
+    AZint8 mid = (lo + hi) / 2; 
+    int no = elm[mid].no; 
+    if      (no < row) lo = mid + 1; 
+    else if (no > row) hi = mid - 1; 
+    else               return elm[mid].val; 
+  }
+  return 0; 
+}
+
+/*-------------------------------------------------------------*/
+double AzSmatc::nonZeroNum(double *ratio) const
+{
+  double out = 0; 
+  AZint8 ex; 
+  for (ex = 0; ex < elm_num; ++ex) if (elm[ex].val != 0) ++out; 
+  if (ratio != NULL) {
+    *ratio = 0;
+    double total = (double)row_num * (double)col_num; 
+    if (total > 0) *ratio = out / total; 
+  }
+  return out; 
+}
+
+/*-------------------------------------------------------------*/
+double AzSmatc::nonZeroNum(const AzIntArr *ia_cols, 
+                           double *ratio) const
+{
+  const int *cols = ia_cols->point(); 
+  double out = 0; 
+  int ix; 
+  for (ix = 0; ix < ia_cols->size(); ++ix) {
+    const AzSvect *v = col(cols[ix]); 
+    int ex; 
+    for (ex = 0; ex < v->elm_num; ++ex) if (v->elm[ex].val != 0) ++out; 
+  }
+  if (ratio != NULL) {
+    *ratio = 0; 
+    double total = (double)row_num * (double)ia_cols->size(); 
+    if (total > 0) *ratio = out / total; 
+  }
+  return out; 
+}
+
+/*-------------------------------------------------------------*/
+void AzSmatc::write(AzFile *file)
+{
+  file->writeInt(col_num); 
+  file->writeInt(row_num); 
+  int cx; 
+  for (cx = 0; cx < col_num; ++cx) {
+    file->writeInt(1); /* not NULL */
+    view[cx].write(file); 
+  }
+}
+
+/*-------------------------------------------------------------*/
+void AzSmatc::read(AzFile *file)
+{
+  int inp_col_num = file->readInt(); 
+  int inp_row_num = file->readInt(); 
+  reform(inp_row_num, inp_col_num); 
+  int cx; 
+  for (cx = 0; cx < col_num; ++cx) {
+    if (file->readInt() == 0) continue; /* NULL column: zero */
+    AzSvect v(file); 
+    load(cx, &v); 
+  }
+  trim(); 
+}
@@ -0,0 +1,137 @@
+/* * * * *
+ *  AzSmatc.hpp
+ *  Copyright (C) 2011, 2012 Rie Johnson
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * */
+
+#ifndef _AZ_SMATC_HPP_
+#define _AZ_SMATC_HPP_
+
+#include "AzUtil.hpp"
+#include "AzSmat.hpp"
+
+//! packed sparse matrix (compressed sparse column)
+/*-------------------------------------------------------------------
+ *  The elements of all the columns are kept in one array in the
+ *  column order; column#cx is elm[be[cx]] ... elm[be[cx+1]-1].
+ *  Unlike AzSmat, there is no allocation per column, which matters
+ *  for large data that is set once and read many times.
+ *
+ *  col() returns an AzSvect that points into the array (no copy)
+ *  so that it can be given to whatever takes const AzSvect *.
+ *  The view does not own the elements; AzSvect functions that
+ *  would reallocate them fail with "sync-check failed".
+ *
+ *  The columns are loaded in the ascending order by load().
+ *  A subset of the columns (e.g., the training data points of a
+ *  cross-validation fold) is taken by transposing only those
+ *  columns, without copying them first.
+ *  Written and read in the format of AzSmat.
+ *-------------------------------------------------------------------*/
+class AzSmatc {
+protected:
+  int row_num, col_num; 
+  int filled_num;   /* columns [0,filled_num) have been loaded */
+  AZint8 elm_num; 
+  AZI_VECT_ELM *elm; 
+  AzBaseArray<AZI_VECT_ELM,AZint8> a_elm; 
+  AZint8 *be;       /* [col_num+1]: beginning of each column */
+  AzBaseArray<AZint8> a_be; 
+  AzSvect *view;    /* [col_num]: point into elm */
+  AzObjArray<AzSvect> a_view; 
+
+public:
+  AzSmatc() : row_num(0), col_num(0), filled_num(0), elm_num(0),
+              elm(NULL), be(NULL), view(NULL) {}
+  AzSmatc(int inp_row_num, int inp_col_num)
+            : row_num(0), col_num(0), filled_num(0), elm_num(0),
+              elm(NULL), be(NULL), view(NULL) {
+    reform(inp_row_num, inp_col_num); 
+  }
+  AzSmatc(const AzSmat *inp)
+            : row_num(0), col_num(0), filled_num(0), elm_num(0),
+              elm(NULL), be(NULL), view(NULL) {
+    set(inp); 
+  }
+  AzSmatc(AzFile *file)
+            : row_num(0), col_num(0), filled_num(0), elm_num(0),
+              elm(NULL), be(NULL), view(NULL) {
+    read(file); 
+  }
+
+  /*---  prohibit copy  ---*/
+  AzSmatc(const AzSmatc &inp) {
+    throw new AzException("AzSmatc(const &)", "Don't copy"); 
+  }
+  AzSmatc & operator =(const AzSmatc &inp) {
+    if (this == &inp) return *this; 
+    throw new AzException("AzSmatc:=", "Don't use ="); 
+  }
+
+  void reset(); 
+  void reform(int inp_row_num, int inp_col_num, AZint8 elm_num_max=0); /* all zero */
+
+  /*---  column#cx must come after the columns loaded so far  ---*/
+  void load(int cx, const AzIFarr *ifa_row_val); /* must be sorted by row */
+  void load(int cx, AzIFarr *ifa_row_val) {
+    ifa_row_val->sort_Int(true); 
+    load(cx, (const AzIFarr *)ifa_row_val); 
+  }
+  void load(int cx, const AzSvect *v); 
+  void load(int cx, const AZI_VECT_ELM *inp, int num); /* must be sorted by row */
+  void trim(); /* release the unused space after loading */
+
+  void set(const AzSmat *inp); 
+  void copy_to(AzSmat *m_out) const; 
+
+  /*---  O(#non-zero + #row + #column)  ---*/
+  void transpose_from(const AzSmat *m_inp); 
+  /*---  column#ia_cols[ix] becomes row#ix; all the columns if ia_cols is NULL  ---*/
+  void transpose_from(const AzSmatc *m_inp, const AzIntArr *ia_cols=NULL); 
+
+  inline int rowNum() const { return row_num; }
+  inline int colNum() const { return col_num; }
+  inline AZint8 elmNum() const { return elm_num; }
+  inline const AzSvect *col(int cx) const {
+    if (cx < 0 || cx >= col_num) {
+      throw new AzException("AzSmatc::col", "out of range"); 
+    }
+    return &view[cx]; 
+  }
+  inline const AZI_VECT_ELM *rawcol(int cx, int *num) const { /* sorted by row */
+    const AzSvect *v = col(cx); 
+    *num = v->elm_num;
+    return v->elm; 
+  }
+  double get(int row, int cx) const; /* binary search in the column */
+  double nonZeroNum(double *ratio=NULL) const; 
+  double nonZeroNum(const AzIntArr *ia_cols, double *ratio) const; /* in the columns in ia_cols */
+
+  /*---  in the format of AzSmat  ---*/
+  void write(AzFile *file); 
+  void read(AzFile *file); 
+
+  inline static bool isNull(const AzSmatc *inp) {
+    return (inp == NULL || inp->col_num == 0 || inp->row_num == 0); 
+  }
+
+protected:
+  inline AZint8 col_begin(int cx) const { return (cx < filled_num) ? be[cx] : elm_num; }
+  inline AZint8 col_end(int cx) const { return (cx < filled_num) ? be[cx+1] : elm_num; }
+  void fill_to(int cx); 
+  void prepare(AZint8 num); 
+  void resetView(int cx); 
+}; 
+#endif
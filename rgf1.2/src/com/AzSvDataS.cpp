@@ -18,6 +18,29 @@
 
 #include "AzSvDataS.hpp"
 #include "AzTools.hpp"
+#include "AzThreads.hpp"
+
+/*------------------------------------------------------------------*/
+/* Lines read and parsed by one thread in _readData_Large           */
+/*------------------------------------------------------------------*/
+class AzSvDataS_Block {
+public:
+  int line_begin; /* line# (from 0) of the 1st line in the file */
+  int line_num; 
+  int dx_begin;   /* data# of the 1st line */
+  AZint8 offs;    /* file offset of the 1st line */
+  int len;        /* #byte of the lines */
+
+  AzBytArr ba_buff; /* the lines followed by '\0' */
+  AZI_VECT_ELM *elm; /* non-zero values of all the lines */
+  AzBaseArray<AZI_VECT_ELM> a_elm; 
+  AzIntArr ia_num;   /* #non-zero of each line */
+  int err_lx;        /* the 1st line that couldn't be parsed; -1: none */
+  int err_offs;      /* its offset in ba_buff */
+
+  AzSvDataS_Block() : line_begin(0), line_num(0), dx_begin(0), offs(0), len(0), 
+                      elm(NULL), err_lx(-1), err_offs(0) {}
+}; 
 
 /*------------------------------------------------------------------*/
 void AzSvDataS::reset()
@@ -74,8 +97,14 @@ void AzSvDataS::_read(const char *feat_fn,
   read_target(y_fn, &v_y, max_data_num); 
 
   /*---  check the dimensionalty  ---*/
-  int f_data_num = m_feat.colNum(); 
-  int y_data_num = v_y.rowNum(); 
+  check_data_num(feat_fn, m_feat.colNum(), y_fn, v_y.rowNum()); 
+}
+
+/*------------------------------------------------------------------*/
+/* static */
+void AzSvDataS::check_data_num(const char *feat_fn, int f_data_num, 
+                               const char *y_fn, int y_data_num)
+{
   if (f_data_num != y_data_num) {
     AzBytArr s("Data conflict: "); 
     s.c(feat_fn); s.c(" has "); s.cn(f_data_num); s.c(" data points, whereas "); 
@@ -84,6 +113,34 @@ void AzSvDataS::_read(const char *feat_fn,
   }
 }
 
+/*------------------------------------------------------------------*/
+/* static */
+void AzSvDataS::read_packed(const char *feat_fn, 
+                            const char *y_fn, 
+                            const char *fdic_fn, 
+                            /*---  output  ---*/
+                            AzSmatc *m_feat, 
+                            AzDvect *v_y, 
+                            AzStrPool *sp_desc)
+{
+  sp_desc->reset(); 
+  read_feat(feat_fn, fdic_fn, m_feat, sp_desc); 
+  if (y_fn == NULL || strlen(y_fn) == 0) {
+    v_y->reform(m_feat->colNum()); /* fill with dummy value zero */
+  }
+  else {
+    read_target(y_fn, v_y); 
+    check_data_num(feat_fn, m_feat->colNum(), y_fn, v_y->rowNum()); 
+  }
+  if (sp_desc->size() <= 0) {
+    int fx; 
+    for (fx = 0; fx < m_feat->rowNum(); ++fx) {
+      AzBytArr s("T"); s.cn(fx); 
+      sp_desc->put(&s); 
+    }
+  }
+}
+
 /*------------------------------------------------------------------*/
 void AzSvDataS::read_features_only(const char *feat_fn, 
                                    const char *fdic_fn,
@@ -107,10 +164,11 @@ void AzSvDataS::read_targets_only(const char *y_fn,
 
 /*------------------------------------------------------------------*/
 /* static */
+template <class M> /* AzSmat | AzSmatc */
 void AzSvDataS::read_feat(const char *feat_fn, 
                           const char *fdic_fn, 
                           /*---  output  ---*/
-                          AzSmat *m_feat, 
+                          M *m_feat, 
                           AzStrPool *sp_f_dic, 
                           int max_data_num)
 {
@@ -131,7 +189,7 @@ void AzSvDataS::read_feat(const char *feat_fn,
   }
 
   /*---  read feature file  ---*/
-  readData(feat_fn, -1, m_feat, max_data_num); 
+  readData_Large(feat_fn, -1, m_feat, max_data_num); 
 
   if (f_num > 0 && f_num != m_feat->rowNum()) {
     AzBytArr s("Conflict in #feature: "); s.c(feat_fn); s.c(" vs. "); s.c(fdic_fn); 
@@ -323,11 +381,36 @@ void AzSvDataS::readData_Small(const char *data_fn,
 #endif 
 
 /*------------------------------------------------------------------*/
+/* static */
 void AzSvDataS::readData_Large(const char *data_fn, 
                          int expected_f_num, 
                          /*---  output  ---*/
                          AzSmat *m_feat,
                          int max_data_num)
+{
+  _readData_Large(data_fn, expected_f_num, m_feat, max_data_num); 
+}
+
+/*------------------------------------------------------------------*/
+/* static */
+void AzSvDataS::readData_Large(const char *data_fn, 
+                         int expected_f_num, 
+                         /*---  output  ---*/
+                         AzSmatc *m_feat,
+                         int max_data_num)
+{
+  _readData_Large(data_fn, expected_f_num, m_feat, max_data_num); 
+  m_feat->trim(); 
+}
+
+/*------------------------------------------------------------------*/
+/* static */
+template <class M> /* AzSmat | AzSmatc */
+void AzSvDataS::_readData_Large(const char *data_fn, 
+                         int expected_f_num, 
+                         /*---  output  ---*/
+                         M *m_feat,
+                         int max_data_num)
 {
   const char *eyec = "AzSvDataS::readData_Large"; 
 
@@ -371,32 +454,208 @@ void AzSvDataS::readData_Large(const char *data_fn,
     if (f_num <= 0) {
       throw new AzException(AzInputNotValid, eyec, "No feature in the first line"); 
     }
-    file.seek(0);  /* rewind to the beginning */
   }
+  file.close(); /* the blocks are read by each thread */
 
   /*---  read features  ---*/
   if (max_data_num > 0) {
     data_num = MIN(data_num, max_data_num); 
   }
   m_feat->reform(f_num, data_num); 
-  
-  int dx; 
-  for (dx = 0; dx < data_num; ++dx, ++line_no) {
-    int len = ia_line_len.get(line_no); 
-    file.readBytes(buff, len); 
-    buff[len] = '\0';  /* to make it a C string */
-    if (isSparse) {
-      parseDataLine_Sparse(buff, len, f_num, data_fn, line_no+1,
-                    m_feat, dx); 
+
+  const int *line_len = ia_line_len.point(); 
+  AZint8 offs = 0; 
+  int lx; 
+  for (lx = 0; lx < line_no; ++lx) offs += line_len[lx]; 
+
+  int th_num = AzThreads::threadNum(0, data_num); 
+  AzDataArr<AzSvDataS_Block> arr_blk(th_num); 
+  int dx = 0; 
+  for ( ; dx < data_num; ) {
+    /*---  one block per thread  ---*/
+    int blk_num = 0; 
+    for ( ; blk_num < th_num && dx < data_num; ++blk_num) {
+      AzSvDataS_Block *blk = arr_blk.point_u(blk_num); 
+      blk->line_begin = line_no; 
+      blk->dx_begin = dx; 
+      blk->offs = offs; 
+      blk->line_num = blk->len = 0; 
+      for ( ; dx < data_num; ++dx, ++line_no) {
+        int len = line_len[line_no]; 
+        if (blk->line_num > 0 && blk->len + len > block_size) break; 
+        ++blk->line_num; 
+        blk->len += len; 
+      }
+      offs += blk->len; 
     }
-    else {
-      parseDataLine(buff, len, f_num, data_fn, line_no+1, 
-                    m_feat, dx); 
+
+    AzThreadErr th_err; 
+    int bx; 
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(blk_num) schedule(static,1) if(blk_num > 1)
+#endif
+    for (bx = 0; bx < blk_num; ++bx) {
+      try {
+        parseBlock(data_fn, f_num, isSparse, line_len, arr_blk.point_u(bx)); 
+      }
+      catch (AzException *e) {
+        th_err.keep(e); 
+      }
+    }
+    th_err.throw_if(); 
+
+    /*---  load the columns in order  ---*/
+    for (bx = 0; bx < blk_num; ++bx) {
+      const AzSvDataS_Block *blk = arr_blk.point(bx); 
+      if (blk->err_lx >= 0) {
+        throwBlockError(data_fn, f_num, isSparse, line_len, blk); 
+      }
+      const AZI_VECT_ELM *elm = blk->elm; 
+      const int *num = blk->ia_num.point(); 
+      for (lx = 0; lx < blk->line_num; ++lx) {
+        m_feat->load(blk->dx_begin+lx, elm, num[lx]); 
+        elm += num[lx]; 
+      }
     }
   }
-  file.close(); 
 }                            
 
+/*------------------------------------------------------------------*/
+/* static */
+void AzSvDataS::parseBlock(const char *data_fn, 
+                           int f_num, 
+                           bool isSparse, 
+                           const int *line_len, 
+                           AzSvDataS_Block *blk) /* inout */
+{
+  const char *eyec = "AzSvDataS::parseBlock"; 
+  AzByte *buff = blk->ba_buff.reset(blk->len+1, 0); /* '\0' at the end for atof */
+  AzFile file(data_fn); 
+  file.open("rb"); 
+  file.seekReadBytes(blk->offs, blk->len, buff); 
+  file.close(); 
+
+  /*---  a value takes at least 2 bytes with the delimiter  ---*/
+  AZint8 max_num = blk->len/2 + 1; 
+  if (!isSparse) max_num = MIN(max_num, (AZint8)blk->line_num*f_num); 
+  if (blk->a_elm.size() < max_num) {
+    blk->a_elm.free(&blk->elm); 
+    blk->a_elm.alloc(&blk->elm, (int)max_num, eyec, "elm"); 
+  }
+  blk->ia_num.reset(blk->line_num, 0); 
+  int *num = blk->ia_num.point_u(); 
+  blk->err_lx = -1; 
+
+  AzIFarr ifa_work; 
+  const AzByte *wp = buff; 
+  AZI_VECT_ELM *out = blk->elm; 
+  int lx; 
+  for (lx = 0; lx < blk->line_num; ++lx) {
+    int len = line_len[blk->line_begin+lx]; 
+    bool isOk; 
+    if (isSparse) isOk = parseSparseLine(wp, len, f_num, &ifa_work, out, &num[lx]); 
+    else          isOk = parseDenseLine(wp, len, f_num, out, &num[lx]); 
+    if (!isOk) {
+      blk->err_lx = lx; 
+      blk->err_offs = Az64::ptr_diff(wp-buff); 
+      return; 
+    }
+    out += num[lx]; 
+    wp += len; 
+  }
+}
+
+/*------------------------------------------------------------------*/
+/* static */
+/* Parse the line that failed in parseBlock by the line parser so   */
+/* that the error is reported as before.                            */
+void AzSvDataS::throwBlockError(const char *data_fn, 
+                                int f_num, 
+                                bool isSparse, 
+                                const int *line_len, 
+                                const AzSvDataS_Block *blk)
+{
+  const char *eyec = "AzSvDataS::throwBlockError"; 
+  int line_no = blk->line_begin + blk->err_lx; 
+  int len = line_len[line_no]; 
+  AzBytArr s_line(blk->ba_buff.point() + blk->err_offs, len); /* a C string as before */
+  const AzByte *line = s_line.point(); 
+  AzIFarr ifa; 
+  if (isSparse) _parseDataLine_Sparse(line, len, f_num, data_fn, line_no+1, ifa); 
+  else          _parseDataLine(line, len, f_num, data_fn, line_no+1, ifa); 
+  AzBytArr s("Error in "); s.c(data_fn); s.c(": Line#="); s.cn(line_no+1); 
+  throw new AzException(eyec, "the line parsers disagree", s.c_str()); 
+}
+
+/*------------------------------------------------------------------*/
+/* static */
+/* Same as _parseDataLine, but no exception and no temporary array; */
+/* false if too many/few values or an invalid number.               */
+bool AzSvDataS::parseDenseLine(const AzByte *inp, 
+                               int inp_len, 
+                               int f_num, 
+                               /*---  output  ---*/
+                               AZI_VECT_ELM *out, 
+                               int *out_num)
+{
+  const AzByte *wp = inp, *line_end = inp + inp_len; 
+  int ex = 0, num = 0; 
+  for ( ; ; ) {
+    for ( ; wp < line_end && *wp <= ' '; ++wp); 
+    if (wp >= line_end) break; 
+    const AzByte *str = wp; 
+    for ( ; wp < line_end && *wp > ' '; ++wp); 
+
+    if (ex >= f_num) return false; /* too many values */
+    /*---  as in my_atof  ---*/
+    if (!(*str >= '0' && *str <= '9' || *str == '+' || *str == '-')) return false; 
+    double val; 
+    if (!fast_atof(str, Az64::ptr_diff(wp-str), &val)) {
+      val = atof((char *)str); 
+    }
+    if (val != 0) {
+      out[num].no = ex; 
+      out[num].val = (AZ_MTX_FLOAT)val; 
+      ++num; 
+    }
+    ++ex; 
+  }
+  *out_num = num; 
+  return (ex == f_num); /* false if too few values */
+}
+
+/*------------------------------------------------------------------*/
+/* static */
+/* _parseDataLine_Sparse, sorted; false if it fails */
+bool AzSvDataS::parseSparseLine(const AzByte *inp, 
+                                int inp_len, 
+                                int f_num, 
+                                AzIFarr *ifa_work, 
+                                /*---  output  ---*/
+                                AZI_VECT_ELM *out, 
+                                int *out_num)
+{
+  ifa_work->reset(); 
+  try {
+    _parseDataLine_Sparse(inp, inp_len, f_num, "", -1, *ifa_work); 
+  }
+  catch (AzException *e) {
+    delete e; 
+    return false; 
+  }
+  ifa_work->sort_Int(true); 
+  int num = ifa_work->size(); 
+  int ix; 
+  for (ix = 0; ix < num; ++ix) {
+    int ex; 
+    double val = ifa_work->get(ix, &ex); 
+    out[ix].no = ex; 
+    out[ix].val = (AZ_MTX_FLOAT)val; 
+  }
+  *out_num = num; 
+  return true; 
+}
+
 /*------------------------------------------------------------------*/
 void AzSvDataS::_parseDataLine_Sparse(const AzByte *inp, 
                               int inp_len, 
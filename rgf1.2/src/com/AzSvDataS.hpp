@@ -22,13 +22,17 @@
 
 #include "AzUtil.hpp"
 #include "AzSmat.hpp"
+#include "AzSmatc.hpp"
 #include "AzDmat.hpp"
 #include "AzStrPool.hpp"
 #include "AzSvFeatInfo.hpp"
 
+class AzSvDataS_Block; 
+
 /* S for separation of features and targets */
 class AzSvDataS : public virtual AzSvFeatInfo /* feature template */
 {
+  friend class AzSvDataStream; /* to share the parser */
 protected: 
   AzSmat m_feat; 
   AzStrPool sp_f_dic; 
@@ -66,6 +70,16 @@ public:
                                   const char *fdic_fn=NULL,
                                   int max_data_num=-1); 
   virtual void read_targets_only(const char *y_fn, int max_data_num); 
+
+  /*---  read the features into a packed matrix (no allocation per data point)  ---*/
+  /*---  instead of feat(); sp_desc: feature names, "T<feature#>" if no fdic_fn  ---*/
+  static void read_packed(const char *feat_fn, 
+                          const char *y_fn, /* may be NULL: targets are all zero */
+                          const char *fdic_fn, /* may be NULL */
+                          /*---  output  ---*/
+                          AzSmatc *m_feat, 
+                          AzDvect *v_y, 
+                          AzStrPool *sp_desc); 
   void destroy(); 
   
   void append_const(double const_to_add) {
@@ -263,12 +277,15 @@ protected:
   void checkIfReady(const char *msg) const; 
   void reset(); 
 
+  template <class M> /* AzSmat | AzSmatc */
   static void read_feat(const char *feat_fn, 
                           const char *fdic_fn, 
                           /*---  output  ---*/
-                          AzSmat *m_feat, 
+                          M *m_feat, 
                           AzStrPool *sp_f_dic, 
                           int max_data_num=-1); 
+  static void check_data_num(const char *feat_fn, int f_data_num, 
+                             const char *y_fn, int y_data_num); 
   static void read_target(const char *y_fn, 
                           AzDvect *v_y,
                           int max_data_num=-1); 
@@ -292,6 +309,46 @@ protected:
                          AzSmat *m_feat, 
                          /*---  ---*/
                          int max_data_num=-1); 
+  static void readData_Large(const char *data_fn, 
+                         int expected_f_num, 
+                         /*---  output  ---*/
+                         AzSmatc *m_feat, 
+                         /*---  ---*/
+                         int max_data_num=-1); 
+  template <class M> /* AzSmat | AzSmatc */
+  static void _readData_Large(const char *data_fn, 
+                         int expected_f_num, 
+                         /*---  output  ---*/
+                         M *m_feat, 
+                         /*---  ---*/
+                         int max_data_num); 
+
+  /*---  for _readData_Large: the lines are split into blocks, and  ---*/
+  /*---  the blocks are read and parsed concurrently.                 ---*/
+  static const int block_size = 4*1024*1024; /* #byte per block unless one line is longer */
+  static void parseBlock(const char *data_fn, 
+                         int f_num, 
+                         bool isSparse, 
+                         const int *line_len, 
+                         AzSvDataS_Block *blk); /* inout */
+  static void throwBlockError(const char *data_fn, 
+                         int f_num, 
+                         bool isSparse, 
+                         const int *line_len, 
+                         const AzSvDataS_Block *blk); 
+  static bool parseDenseLine(const AzByte *inp, 
+                         int inp_len, 
+                         int f_num, 
+                         /*---  output  ---*/
+                         AZI_VECT_ELM *out, 
+                         int *out_num); 
+  static bool parseSparseLine(const AzByte *inp, 
+                         int inp_len, 
+                         int f_num, 
+                         AzIFarr *ifa_work, 
+                         /*---  output  ---*/
+                         AZI_VECT_ELM *out, 
+                         int *out_num); 
 
   inline static void parseDataLine(const AzByte *inp, 
                               int inp_len, 
@@ -360,6 +417,38 @@ protected:
     throw new AzException(AzInputError, eyec, s.c_str()); 
   }
 
+  /*---  exact (same as atof) for plain decimals such as "-12.345678"  ---*/
+  /*---  with at most 18 digits; false to leave the others to atof.     ---*/
+  inline static bool fast_atof(const AzByte *str, int len, double *val) {
+    static const double ten_to[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 
+      1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18 }; 
+    const AzByte *wp = str, *end = str + len; 
+    bool isNegative = false; 
+    if (wp < end && (*wp == '+' || *wp == '-')) {
+      isNegative = (*wp == '-'); 
+      ++wp; 
+    }
+    AZint8 mant = 0; 
+    int digits = 0, frac_digits = 0; 
+    bool isFrac = false; 
+    for ( ; wp < end; ++wp) {
+      if (*wp >= '0' && *wp <= '9') {
+        if (digits >= 18) return false; 
+        mant = mant*10 + (*wp - '0'); 
+        ++digits; 
+        if (isFrac) ++frac_digits; 
+      }
+      else if (*wp == '.' && !isFrac) isFrac = true; 
+      else return false; 
+    }
+    if (digits == 0 || mant > ((AZint8)1 << 53)) return false; 
+    /*---  both are exact; so the division is rounded correctly as in atof  ---*/
+    double dval = (double)mant; 
+    if (frac_digits > 0) dval /= ten_to[frac_digits]; 
+    *val = (isNegative) ? -dval : dval; 
+    return true; 
+  }
+
   inline static int my_fno(const char *str, 
                            const char *eyec, 
                            int line_no) {
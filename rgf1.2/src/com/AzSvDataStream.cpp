@@ -0,0 +1,130 @@
+/* * * * *
+ *  AzSvDataStream.cpp
+ *  Copyright (C) 2011, 2012 Rie Johnson
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * */
+
+#include "AzSvDataStream.hpp"
+
+/*------------------------------------------------------------------*/
+void AzSvDataStream::reset(const char *fn, 
+                           int expected_f_num)
+{
+  const char *eyec = "AzSvDataStream::reset"; 
+  s_fn.reset(fn); 
+  file.reset(fn); 
+  file.open("rb"); 
+  isEof = false; 
+  line_no = 0; 
+  s_line0.reset(); 
+
+  /*---  1st line indicates sparse/dense  ---*/
+  if (!readLine(&s_line0)) {
+    throw new AzException(AzInputNotValid, eyec, "Empty data"); 
+  }
+  isSparse = false; 
+  f_num = AzSvDataS::if_sparse(s_line0, expected_f_num); 
+  if (f_num > 0) {
+    isSparse = true; 
+    s_line0.reset(); 
+  }
+  else {
+    f_num = expected_f_num; 
+    if (f_num <= 0) {
+      const AzByte *line0 = s_line0.point(); 
+      f_num = AzSvDataS::countFeatures(line0, line0+s_line0.length()); 
+    }
+    if (f_num <= 0) {
+      throw new AzException(AzInputNotValid, eyec, "No feature in the first line"); 
+    }
+    --line_no; /* to be parsed as data */
+  }
+}
+
+/*------------------------------------------------------------------*/
+int AzSvDataStream::read(int max_num, 
+                         AzSmat *m_feat) /* output */
+{
+  const char *eyec = "AzSvDataStream::read"; 
+  if (max_num <= 0) {
+    throw new AzException(eyec, "max_num must be positive"); 
+  }
+  if (arr_ifa.size() < max_num) {
+    arr_ifa.reset(max_num); 
+  }
+  int num = 0; 
+  for ( ; num < max_num; ++num) {
+    const AzBytArr *s = &s_line; 
+    if (s_line0.length() > 0) {
+      s = &s_line0; 
+      ++line_no; 
+    }
+    else if (!readLine(&s_line)) {
+      break; 
+    }
+    parseLine(s->point(), s->length(), f_num, isSparse, 
+              s_fn.c_str(), line_no, arr_ifa.point_u(num)); 
+    s_line0.reset(); 
+  }
+
+  m_feat->reform(f_num, num); 
+  int dx; 
+  for (dx = 0; dx < num; ++dx) {
+    m_feat->load(dx, arr_ifa.point_u(dx)); 
+  }
+  return num; 
+}
+
+/*------------------------------------------------------------------*/
+/* static */
+void AzSvDataStream::parseLine(const AzByte *inp, 
+                               int inp_len, 
+                               int f_num, 
+                               bool isSparse, 
+                               const char *data_fn, 
+                               int line_no, 
+                               /*---  output  ---*/
+                               AzIFarr *ifa_ex_val)
+{
+  ifa_ex_val->reset(); 
+  if (isSparse) {
+    AzSvDataS::_parseDataLine_Sparse(inp, inp_len, f_num, data_fn, line_no, *ifa_ex_val); 
+  }
+  else {
+    AzSvDataS::_parseDataLine(inp, inp_len, f_num, data_fn, line_no, *ifa_ex_val); 
+  }
+}
+
+/*------------------------------------------------------------------*/
+/* one line including the '\n' at the end; false at the end of file */
+bool AzSvDataStream::readLine(AzBytArr *s)
+{
+  s->reset(); 
+  if (isEof) return false; 
+  if (ba_buff.length() != gets_size+1) ba_buff.reset(gets_size+1, 0); 
+  AzByte *buff = ba_buff.point_u(); 
+  for ( ; ; ) {
+    int len = file.gets(buff, gets_size); 
+    if (len <= 0) {
+      isEof = true; 
+      break; 
+    }
+    s->concat(buff, len); 
+    if (buff[len-1] == '\n') break; 
+  }
+  if (s->length() <= 0) return false; 
+  ++line_no; 
+  return true; 
+}
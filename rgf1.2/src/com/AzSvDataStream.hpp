@@ -0,0 +1,76 @@
+/* * * * *
+ *  AzSvDataStream.hpp
+ *  Copyright (C) 2011, 2012 Rie Johnson
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * */
+
+#ifndef _AZ_SV_DATA_STREAM_HPP_
+#define _AZ_SV_DATA_STREAM_HPP_
+
+#include "AzUtil.hpp"
+#include "AzSmat.hpp"
+#include "AzSvDataS.hpp"
+
+//! Read a feature file in the format of AzSvDataS a chunk of data points at a time.
+/*-------------------------------------------------------------------
+ *  Unlike AzSvDataS::read_features_only, the file is read only
+ *  once from the beginning to the end; therefore, the memory usage
+ *  is bounded by the chunk size, and "-" (stdin) can be read.
+ *-------------------------------------------------------------------*/
+class AzSvDataStream {
+protected:
+  AzFile file; 
+  AzBytArr s_fn; 
+  bool isSparse, isEof; 
+  int f_num; 
+  int line_no; /* the number of lines read so far */
+  AzBytArr s_line0; /* the 1st line of dense data; not parsed yet */
+  AzBytArr s_line; 
+  AzBytArr ba_buff; /* for readLine */
+  AzDataArr<AzIFarr> arr_ifa; /* reused for each chunk */
+
+  static const int gets_size = 65536; 
+
+public:
+  AzSvDataStream() : isSparse(false), isEof(true), f_num(0), line_no(0) {}
+
+  /*---  open and read the 1st line to see if sparse or dense  ---*/
+  void reset(const char *fn, int expected_f_num=-1); 
+
+  /*---  read up to max_num data points; 0 at the end of file  ---*/
+  int read(int max_num, 
+           AzSmat *m_feat); /* output: #feat x #data read */
+  void close() {
+    file.close(); 
+    isEof = true; 
+  }
+
+  inline int featNum() const { return f_num; }
+  inline bool isSparseFormat() const { return isSparse; }
+
+  /*---  parse one line of dense or sparse data  ---*/
+  static void parseLine(const AzByte *inp, 
+                        int inp_len, 
+                        int f_num, 
+                        bool isSparse, 
+                        const char *data_fn, /* for printing error */
+                        int line_no, 
+                        /*---  output  ---*/
+                        AzIFarr *ifa_ex_val); 
+
+protected:
+  bool readLine(AzBytArr *s); 
+}; 
+#endif
@@ -0,0 +1,104 @@
+/* * * * *
+ *  AzThreads.hpp
+ *  Copyright (C) 2011, 2012 Rie Johnson
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * */
+
+#ifndef _AZ_THREADS_HPP_
+#define _AZ_THREADS_HPP_
+
+#include "AzUtil.hpp"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*
+ *  Multi-threading is done by OpenMP.  Compile with -fopenmp (g++) or
+ *  /openmp (MSVC); otherwise, everything runs on one thread.
+ */
+
+/*---  the number of threads; 0 means as many as processors  ---*/
+#define kw_num_threads "num_threads="
+#define help_num_threads "Number of threads.  0: as many as the processors."
+
+//! Helpers for splitting work among threads.
+class AzThreads {
+public:
+  static inline int processorNum() {
+#ifdef _OPENMP
+    return MAX(1, omp_get_num_procs()); 
+#else
+    return 1; 
+#endif
+  }
+  static inline bool isAvailable() {
+#ifdef _OPENMP
+    return true; 
+#else
+    return false; 
+#endif
+  }
+
+  /*---  num_threads= -> actual number  ---*/
+  static inline int resolve(int num_threads) {
+    if (!isAvailable()) return 1; 
+    if (num_threads <= 0) return processorNum(); 
+    return num_threads; 
+  }
+
+  /*---  #thread to be used for work_num units of work  ---*/
+  static inline int threadNum(int num_threads, int work_num) {
+    return MAX(1, MIN(resolve(num_threads), work_num)); 
+  }
+
+  /*---  contiguous range of work units for thread#thx: [*begin, *end)  ---*/
+  static inline void range(int th_num, int thx, int work_num,
+                           int *begin, int *end) {
+    *begin = (int)((AZint8)work_num * thx / th_num);
+    *end = (int)((AZint8)work_num * (thx+1) / th_num);
+  }
+}; 
+
+//! Keeps the first exception thrown in a parallel region.
+/*---  exceptions must not escape from a parallel region  ---*/
+class AzThreadErr {
+protected:
+  AzException *err; 
+public:
+  AzThreadErr() : err(NULL) {}
+  ~AzThreadErr() {
+    delete err; 
+  }
+  inline void keep(AzException *e) {
+#ifdef _OPENMP
+#pragma omp critical (AzThreadErr_keep)
+#endif
+    {
+      if (err == NULL) err = e; 
+      else             delete e; 
+    }
+  }
+  inline bool isSet() const { return (err != NULL); }
+
+  /*---  call this after the parallel region  ---*/
+  inline void throw_if() {
+    if (err != NULL) {
+      AzException *e = err; 
+      err = NULL; 
+      throw e; 
+    }
+  }
+}; 
+#endif
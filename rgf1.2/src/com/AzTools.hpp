@@ -169,6 +169,14 @@ public:
   static const AzByte *strip(const AzByte *data, const AzByte *data_end,  
                                int *byte_len); 
 
+  /*---  hash for drawing at random by a key (e.g., seed and draw#)  ---*/
+  /*---  instead of rand(), which is shared by all the threads        ---*/
+  inline static unsigned int mix32(unsigned int h) {
+    h ^= h >> 16; h *= 0x85ebca6bU; 
+    h ^= h >> 13; h *= 0xc2b2ae35U; 
+    h ^= h >> 16; 
+    return h; 
+  }
   inline static int rand_large() {
     int rand_max = RAND_MAX; 
     if (rand_max <= 0x7fff) {
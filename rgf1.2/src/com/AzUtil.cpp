@@ -37,7 +37,7 @@ AzFile::AzFile(const char *fn)
 AzFile::~AzFile()
 {
   if (fp != NULL) {
-    fclose(fp); 
+    if (!isStdio()) fclose(fp); 
     fp = NULL; 
   }
   delete str_fn; str_fn = NULL; 
@@ -47,7 +47,7 @@ AzFile::~AzFile()
 void AzFile::reset(const char *fn)
 {
   if (fp != NULL) {
-    fclose(fp); 
+    if (!isStdio()) fclose(fp); 
     fp = NULL; 
   }
   delete str_fn; str_fn = NULL; 
@@ -68,6 +68,10 @@ void AzFile::open(const char *inp_flags)
   if (strcmp(flags, "X") == 0) { /* for compatibility .. */
     flags = "rb";  
   }
+  if (isStdio(pointFileName())) { /* "-": stdin for reading; stdout for writing */
+    fp = (strchr(flags, 'r') != NULL) ? stdin : stdout; 
+    return; 
+  }
   if ((fp = fopen(pointFileName(), flags)) == NULL) {
     throw new AzException(AzFileIOError, eyec, pointFileName(), "fopen"); 
   }
@@ -98,7 +102,12 @@ void AzFile::close(bool doCheckError)
 {
   const char *eyec = "AzFile::close"; 
   if (fp != NULL) {
-    if (fclose(fp) != 0 && doCheckError) {
+    if (isStdio()) {
+      if (fflush(fp) != 0 && doCheckError) {
+        throw new AzException(AzFileIOError, eyec, pointFileName(), "fflush"); 
+      }
+    }
+    else if (fclose(fp) != 0 && doCheckError) {
       throw new AzException(AzFileIOError, eyec, pointFileName(), "fclose"); 
     }
     fp = NULL; 
@@ -151,6 +151,14 @@ public:
   void open(const char *flags); 
   void close(bool doCheckCloseError=false); 
   static bool isExisting(const char *fn); 
+
+  /*---  "-" stands for stdin/stdout; it cannot seek  ---*/
+  inline static bool isStdio(const char *fn) {
+    return (fn != NULL && strcmp(fn, "-") == 0); 
+  }
+  inline bool isStdio() const {
+    return (fp != NULL && (fp == stdin || fp == stdout)); 
+  }
  
   AZint8 write_c_str(const char *cstr) {
     return writeBytes((AzByte *)cstr, Az64::cstrlen(cstr)); 
@@ -995,6 +1003,11 @@ public:
     iifq.reset(num, int1, AzNone, val); 
   }
   inline void put(int int1, double val) { iifq.put(int1, AzNone, val); }
+  void reset(const float *arr, int num) {
+    reset(); 
+    int ix; 
+    for (ix = 0; ix < num; ++ix) put(ix, arr[ix]); 
+  }
   void reset(const double *arr, int num) {
     reset(); 
     int ix; 
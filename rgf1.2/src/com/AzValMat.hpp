@@ -0,0 +1,245 @@
+/* * * * *
+ *  AzValMat.hpp
+ *  Copyright (C) 2011, 2012 Rie Johnson
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * */
+
+#ifndef _AZ_VAL_MAT_HPP_
+#define _AZ_VAL_MAT_HPP_
+
+#include "AzUtil.hpp"
+#include "AzSmat.hpp"
+#include "AzDmat.hpp"
+#include "AzSmatc.hpp"
+
+//! dense array of feature values stored in AZ_MTX_FLOAT (see AzSmat.hpp)
+/*-------------------------------------------------------------------
+ *  For large data that is set once and read many times such as
+ *  the transposed training data.  Values are read and written as
+ *  double.  The file format is the same as AzDvect's so that files
+ *  can be shared with the builds with double-precision storage.
+ *-------------------------------------------------------------------*/
+class AzValArr {
+protected:
+  int num; 
+  AZ_MTX_FLOAT *elm; 
+  AzBaseArray<AZ_MTX_FLOAT> a; 
+
+public:
+  AzValArr() : num(0), elm(NULL) {}
+  AzValArr(int inp_num) : num(0), elm(NULL) {
+    reform(inp_num); 
+  }
+  AzValArr(AzFile *file) : num(0), elm(NULL) {
+    read(file); 
+  }
+
+  /*---  prohibit copy  ---*/
+  AzValArr(const AzValArr &inp) {
+    throw new AzException("AzValArr(const &)", "Don't copy"); 
+  }
+  AzValArr & operator =(const AzValArr &inp) {
+    if (this == &inp) return *this; 
+    throw new AzException("AzValArr:=", "Don't use ="); 
+  }
+
+  void reset() {
+    a.free(&elm); num = 0; 
+  }
+  void reform(int inp_num) {
+    reset(); 
+    a.alloc(&elm, inp_num, "AzValArr::reform"); 
+    num = inp_num; 
+    zeroOut(); 
+  }
+  void resize(int new_num) {
+    if (new_num == num) return; 
+    if (elm == NULL) {
+      reform(new_num); 
+      return; 
+    }
+    a.realloc(&elm, new_num, "AzValArr::resize"); 
+    int ex; 
+    for (ex = num; ex < new_num; ++ex) elm[ex] = 0; 
+    num = new_num; 
+  }
+  void set(const AzValArr *inp) {
+    reform(inp->num); 
+    if (num > 0) memcpy(elm, inp->elm, sizeof(elm[0])*num); 
+  }
+  void set(const AzDvect *inp) {
+    reform(inp->rowNum()); 
+    const double *val = inp->point(); 
+    int ex; 
+    for (ex = 0; ex < num; ++ex) elm[ex] = (AZ_MTX_FLOAT)val[ex]; 
+  }
+  void zeroOut() {
+    int ex; 
+    for (ex = 0; ex < num; ++ex) elm[ex] = 0; 
+  }
+
+  inline int rowNum() const { return num; }
+  inline double get(int ex) const {
+    checkIndex(ex, "AzValArr::get"); 
+    return elm[ex]; 
+  }
+  inline void set(int ex, double val) {
+    checkIndex(ex, "AzValArr::set"); 
+    elm[ex] = (AZ_MTX_FLOAT)val; 
+  }
+  inline const AZ_MTX_FLOAT *point() const { return elm; }
+  inline AZ_MTX_FLOAT *point_u() { return elm; }
+
+  /*---  in the format of AzDvect  ---*/
+  void write(AzFile *file) const {
+    AzDvect v(num); 
+    int ex; 
+    for (ex = 0; ex < num; ++ex) v.set(ex, elm[ex]); 
+    v.write(file); 
+  }
+  void read(AzFile *file) {
+    AzDvect v(file); 
+    set(&v); 
+  }
+
+protected:
+  inline void checkIndex(int ex, const char *eyec) const {
+    if (ex < 0 || ex >= num) {
+      throw new AzException(eyec, "out of range"); 
+    }
+  }
+}; 
+
+//! dense matrix whose columns are AzValArr
+/*-------------------------------------------------------------------
+ *  Written and read in the format of AzDmat.
+ *  lock() prohibits the actions that would change the pointers
+ *  to the columns, as AzDmat does.
+ *-------------------------------------------------------------------*/
+class AzValMat {
+protected:
+  bool isLocked; 
+  int row_num; 
+  AzDataArr<AzValArr> arr; 
+
+public:
+  AzValMat() : isLocked(false), row_num(0) {}
+  AzValMat(AzFile *file) : isLocked(false), row_num(0) {
+    read(file); 
+  }
+
+  inline void lock() { isLocked = true; }
+  inline void unlock() { isLocked = false; }
+
+  void reset() {
+    checkLock("AzValMat::reset"); 
+    arr.reset(); 
+    row_num = 0; 
+  }
+  void reform(int rnum, int cnum) {
+    checkLock("AzValMat::reform"); 
+    arr.reset(cnum); 
+    row_num = rnum; 
+    int cx; 
+    for (cx = 0; cx < cnum; ++cx) arr.point_u(cx)->reform(row_num); 
+  }
+
+  inline int rowNum() const { return row_num; }
+  inline int colNum() const { return arr.size(); }
+  inline const AzValArr *col(int cx) const {
+    if (cx < 0 || cx >= arr.size()) {
+      throw new AzException("AzValMat::col", "out of range"); 
+    }
+    return arr.point(cx); 
+  }
+  inline double get(int row, int cx) const {
+    return col(cx)->get(row); 
+  }
+
+  /*---  this <- transpose of m_inp  ---*/
+  void transpose_from(const AzSmat *m_inp) {
+    reform(m_inp->colNum(), m_inp->rowNum()); 
+    int rx; 
+    for (rx = 0; rx < m_inp->colNum(); ++rx) {
+      const AzSvect *v_inp = m_inp->col(rx); 
+      AzCursor cursor; 
+      for ( ; ; ) {
+        double val; 
+        int cx = v_inp->next(cursor, val); 
+        if (cx < 0) break; 
+        arr.point_u(cx)->set(rx, val); 
+      }
+    }
+  }
+  /*---  column#ia_cols[rx] of m_inp becomes row#rx; all the columns if NULL  ---*/
+  void transpose_from(const AzSmatc *m_inp, const AzIntArr *ia_cols=NULL) {
+    const int *cols = (ia_cols == NULL) ? NULL : ia_cols->point(); 
+    int num = (ia_cols == NULL) ? m_inp->colNum() : ia_cols->size(); 
+    reform(num, m_inp->rowNum()); 
+    int rx; 
+    for (rx = 0; rx < num; ++rx) {
+      int e_num; 
+      const AZI_VECT_ELM *elm = m_inp->rawcol((cols == NULL) ? rx : cols[rx], &e_num); 
+      int ex; 
+      for (ex = 0; ex < e_num; ++ex) {
+        if (elm[ex].val != 0) arr.point_u(elm[ex].no)->set(rx, elm[ex].val); 
+      }
+    }
+  }
+
+  /*---  in the format of AzDmat  ---*/
+  void write(AzFile *file) const {
+    file->writeInt(colNum()); 
+    file->writeInt(row_num); 
+    int cx; 
+    for (cx = 0; cx < colNum(); ++cx) {
+      file->writeInt(1); /* not NULL */
+      col(cx)->write(file); 
+    }
+  }
+  void read(AzFile *file) {
+    checkLock("AzValMat::read"); 
+    int col_num = file->readInt(); 
+    row_num = file->readInt(); 
+    arr.reset(col_num); 
+    int cx; 
+    for (cx = 0; cx < col_num; ++cx) {
+      AzValArr *v = arr.point_u(cx); 
+      if (file->readInt() != 0) v->read(file); 
+      else                      v->reform(row_num); /* NULL column: zeroes */
+    }
+  }
+
+  double nonZeroRatio() const {
+    double nz = 0, total = (double)row_num*(double)colNum(); 
+    if (total <= 0) return 0; 
+    int cx; 
+    for (cx = 0; cx < colNum(); ++cx) {
+      const AZ_MTX_FLOAT *val = col(cx)->point(); 
+      int rx; 
+      for (rx = 0; rx < row_num; ++rx) if (val[rx] != 0) ++nz; 
+    }
+    return nz/total; 
+  }
+
+protected:
+  inline void checkLock(const char *who) const {
+    if (isLocked) {
+      throw new AzException("AzValMat::checkLock",
+            "Illegal attempt to change the pointers of a locked matrix by", who); 
+    }
+  }
+}; 
+#endif
@@ -0,0 +1,138 @@
+/* * * * *
+ *  AzDataCache.cpp
+ *  Copyright (C) 2011, 2012 Rie Johnson
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * */
+
+#include "AzDataCache.hpp"
+#include "AzPrint.hpp"
+
+/*------------------------------------------------------------------*/
+void AzDataCache::write(const char *fn,
+                        const AzOut &out,
+                        const AzSmatc *m_x,
+                        const AzDvect *v_y,
+                        const AzDvect *v_dw, /* may be empty */
+                        const AzSvFeatInfo *featInfo,
+                        AzParam &p)
+{
+  const char *eyec = "AzDataCache::write"; 
+  int d_num = m_x->colNum(); 
+  if (v_y->rowNum() > 0 && v_y->rowNum() != d_num) {
+    throw new AzException(AzInputError, eyec, "#data conflict: x and y"); 
+  }
+  if (v_dw->rowNum() > 0) {
+    if (v_dw->rowNum() != d_num) {
+      throw new AzException(AzInputError, eyec, "#data conflict: x and weights"); 
+    }
+    if (v_dw->min() <= 0) {
+      throw new AzException(AzInputError, eyec, "Data point weights must be positive"); 
+    }
+  }
+  AzBytArr s_dataproc; 
+  p.vStr(kw_dataproc, &s_dataproc); 
+  if (s_dataproc.compare("Hist") == 0) {
+    throw new AzException(AzInputNotValid, eyec, kw_dataproc,
+          "Hist cannot be pre-sorted.  Prepare data with Auto, Sparse, or Dense and specify Hist for training."); 
+  }
+
+  /*---  transpose and pre-sort  ---*/
+  AzDataForTrTree data; 
+  bool beTight = false; /* this only matters after the data is read */
+  data.reset_data(out, m_x, NULL, p, beTight, featInfo); 
+
+  AzFile file(fn); 
+  file.open("wb"); 
+  file.writeBinMarker(); 
+  file.writeByte(valueType()); 
+  int ix; 
+  for (ix = 1; ix < reserved_length; ++ix) file.writeByte(0); 
+  file.writeInt(version); 
+  file.writeInt(d_num); 
+  file.writeInt(m_x->rowNum()); 
+  AzDvect(v_y).write(&file); 
+  AzDvect(v_dw).write(&file); 
+  const AzSvFeatInfo *fi = data.featInfo(); 
+  int fx; 
+  for (fx = 0; fx < fi->featNum(); ++fx) {
+    AzBytArr s_desc; 
+    fi->desc(fx, &s_desc); 
+    s_desc.write(&file); 
+  }
+  data.write(&file); 
+  file.close(true); 
+}
+
+/*------------------------------------------------------------------*/
+void AzDataCache::reset(const char *fn)
+{
+  const char *eyec = "AzDataCache::reset"; 
+  if (isOpen) done(); 
+  file.reset(fn); 
+  file.open("rb"); 
+  isOpen = true; 
+  file.checkBinMarker(); 
+  if (file.readByte() != valueType()) {
+    throw new AzException(AzInputNotValid, eyec, fn,
+          "Prepared by a build with different precision of feature values (_AZ_FLOAT_MATRIX_).  Prepare the data again."); 
+  }
+  int ix; 
+  for (ix = 1; ix < reserved_length; ++ix) {
+    AzByte byte = file.readByte(); 
+    if (byte != 0) {
+      throw new AzException(AzInputNotValid, eyec, fn,
+            "Error detected in the reserved field.  Broken file or version conflict"); 
+    }
+  }
+  int inp_version = file.readInt(); 
+  if (inp_version != version) {
+    throw new AzException(AzInputNotValid, eyec, fn,
+            "Version conflict.  Prepare the data again."); 
+  }
+  data_num = file.readInt(); 
+  f_num = file.readInt(); 
+  v_y.read(&file); 
+  v_dw.read(&file); 
+  if (v_y.rowNum() > 0 && v_y.rowNum() != data_num ||
+      v_dw.rowNum() > 0 && v_dw.rowNum() != data_num) {
+    throw new AzException(AzInputNotValid, eyec, fn, "Broken file"); 
+  }
+  AzStrPool sp_desc; 
+  int fx; 
+  for (fx = 0; fx < f_num; ++fx) {
+    AzBytArr s_desc(&file); 
+    sp_desc.put(&s_desc); 
+  }
+  feat.reset(&sp_desc); 
+}
+
+/*------------------------------------------------------------------*/
+void AzDataCache::read_data(const AzOut &out,
+                            AzParam &p,
+                            bool beTight,
+                            AzDataForTrTree *data)
+{
+  checkIfOpen("AzDataCache::read_data"); 
+  data->read_data(out, &file, p, beTight, &feat); 
+  done(); 
+}
+
+/*------------------------------------------------------------------*/
+void AzDataCache::read_features(AzSmat *m_x)
+{
+  checkIfOpen("AzDataCache::read_features"); 
+  AzDataForTrTree::read_features(&file, m_x); 
+  done(); 
+}
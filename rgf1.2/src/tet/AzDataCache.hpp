@@ -0,0 +1,92 @@
+/* * * * *
+ *  AzDataCache.hpp
+ *  Copyright (C) 2011, 2012 Rie Johnson
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * */
+
+#ifndef _AZ_DATA_CACHE_HPP_
+#define _AZ_DATA_CACHE_HPP_
+
+#include "AzUtil.hpp"
+#include "AzSmat.hpp"
+#include "AzDmat.hpp"
+#include "AzSvFeatInfoClone.hpp"
+#include "AzDataForTrTree.hpp"
+#include "AzParam.hpp"
+
+//! Binary data file written by "prepare_data" and read via x_bin_fn=.
+/*-------------------------------------------------------------------
+ *  Holds targets, data point weights, feature names, and the data
+ *  transposed and pre-sorted by AzDataForTrTree so that training
+ *  can skip parsing text and sorting.
+ *-------------------------------------------------------------------*/
+class AzDataCache {
+protected:
+  AzFile file; /* kept open between reset() and read_data|read_features */
+  bool isOpen; 
+  int data_num, f_num; 
+  AzDvect v_y, v_dw; /* empty if not given to prepare_data */
+  AzSvFeatInfoClone feat; 
+
+  static const int version = 1; 
+  static const int reserved_length = 64; 
+
+  /*---  the 1st reserved byte: 0 if AZ_MTX_FLOAT is double (as before)  ---*/
+  /*---  as sparse data is written in AZ_MTX_FLOAT                        ---*/
+  static AzByte valueType() {
+    return (sizeof(AZ_MTX_FLOAT) == sizeof(double)) ? 0 : (AzByte)sizeof(AZ_MTX_FLOAT); 
+  }
+
+public:
+  AzDataCache() : isOpen(false), data_num(0), f_num(0) {}
+
+  /*---  for "prepare_data"  ---*/
+  static void write(const char *fn,
+                    const AzOut &out,
+                    const AzSmatc *m_x,
+                    const AzDvect *v_y,
+                    const AzDvect *v_dw, /* may be empty */
+                    const AzSvFeatInfo *featInfo,
+                    AzParam &p); 
+
+  /*---  read the header: targets, weights, and feature names  ---*/
+  void reset(const char *fn); 
+
+  /*---  then, read the data; only once  ---*/
+  void read_data(const AzOut &out,
+                 AzParam &p,
+                 bool beTight,
+                 AzDataForTrTree *data); 
+  void read_features(AzSmat *m_x); /* #feat x #data */
+
+  inline int dataNum() const { return data_num; }
+  inline int featNum() const { return f_num; }
+  inline const AzDvect *targets() const { return &v_y; }
+  inline const AzDvect *weights() const { return &v_dw; }
+  inline const AzSvFeatInfo *featInfo() const { return &feat; }
+  inline const char *pointFileName() const { return file.pointFileName(); }
+
+protected:
+  void checkIfOpen(const char *eyec) const {
+    if (!isOpen) {
+      throw new AzException(eyec, "the data has been read already or not ready"); 
+    }
+  }
+  void done() {
+    file.close(); 
+    isOpen = false; 
+  }
+}; 
+#endif
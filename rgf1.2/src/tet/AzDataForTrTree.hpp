@@ -22,21 +22,26 @@
 
 #include "AzUtil.hpp"
 #include "AzSmat.hpp"
+#include "AzSmatc.hpp"
+#include "AzValMat.hpp"
 #include "AzSvFeatInfoClone.hpp"
 #include "AzSortedFeat.hpp"
+#include "AzHistFeat.hpp"
 #include "AzParam.hpp"
 #include "AzHelp.hpp"
 
 #define kw_dataproc  "data_management="
-#define help_dataproc "Sparse|Dense|Auto.  Data is treated either as \"Sparse\" data (having many zeroes), as \"Dense\" data, or as \"Auto\"matically determined.  It affects speed and memory consumption of training."
+#define help_dataproc "Sparse|Dense|Auto|Hist.  Data is treated either as \"Sparse\" data (having many zeroes), as \"Dense\" data, or as \"Auto\"matically determined.  It affects speed and memory consumption of training.  \"Hist\" quantizes feature values into bins and searches for node splits using histograms, which is faster on large dense data but approximates split points when a feature has more than max_bin distinct values."
+#define kw_max_bin "max_bin="
+#define help_max_bin "Maximum number of bins per feature when data_management=Hist."
 
 /*--------------------------------------------------------*/
 class AzDataForTrTree {
 protected:
   int data_num; 
-  AzSmat m_tran_sparse; 
+  AzSmatc m_tran_sparse; /* packed; no allocation per feature */
   /*-------------------------*/
-  AzDmat m_tran_dense;  
+  AzValMat m_tran_dense;  
   /*
    *  After construction, this matrix is locked so that any operation that 
    *  would change the pointers to column vectors is prohibited, as a safety 
@@ -47,20 +52,25 @@ protected:
 
   AzSvFeatInfoClone feat; 
   AzSortedFeatArr sorted_arr;  /* not set if this is test data */
+  AzBinnedFeat binned;         /* set only with dataproc_Hist */
 
   enum dataproc_Type {
     dataproc_Auto = 0, 
     dataproc_Dense = 1, 
     dataproc_Sparse = 2, 
+    dataproc_Hist = 3, 
   };
 
   #define Az_nz_ratio_threshold 0.4
   #define Az_max_test_entries (1024*1024*16)
   dataproc_Type dataproc; 
   AzBytArr s_dataproc; 
+  int max_bin; 
+
+  static const int max_bin_dflt = 255; 
 
 public:
-  AzDataForTrTree() : dataproc(dataproc_Auto), data_num(0) {}
+  AzDataForTrTree() : dataproc(dataproc_Auto), data_num(0), max_bin(max_bin_dflt) {}
   virtual void reset_data(const AzOut &out, 
                   const AzSmat *m_data, 
                   AzParam &p, 
@@ -69,80 +79,168 @@ public:
   {
     resetParam(p); 
     printParam(out); 
+    _reset_data(out, m_data, beTight, inp_feat); 
+  }
 
-    /*---  count nonzero components  ---*/
+  /*---  the data points (columns) of m_data in ia_dxs, or all of them if NULL;  ---*/
+  /*---  m_data is transposed in place and can be shared (e.g., by xv folds)  ---*/
+  virtual void reset_data(const AzOut &out, 
+                  const AzSmatc *m_data, 
+                  const AzIntArr *ia_dxs, /* may be NULL */
+                  AzParam &p, 
+                  bool beTight, 
+                  const AzSvFeatInfo *inp_feat=NULL)
+  {
+    resetParam(p); 
+    printParam(out); 
     double nz_ratio; 
-    m_data->nonZeroNum(&nz_ratio); 
-    AzBytArr s("Training data: "); 
-    s.cn(m_data->rowNum());s.c("x");s.cn(m_data->colNum()); 
-    s.c(", nonzero_ratio=", nz_ratio, 4); 
+    if (ia_dxs == NULL) m_data->nonZeroNum(&nz_ratio); 
+    else                m_data->nonZeroNum(ia_dxs, &nz_ratio); 
+    int d_num = (ia_dxs == NULL) ? m_data->colNum() : ia_dxs->size(); 
+    bool doSparse = begin_reset(out, m_data->rowNum(), d_num, nz_ratio); 
+    if (doSparse) m_tran_sparse.transpose_from(m_data, ia_dxs); 
+    else          m_tran_dense.transpose_from(m_data, ia_dxs); 
+    end_reset(doSparse, beTight, m_data->rowNum(), inp_feat); 
+  }
 
-    /*---  decide sparse or dense  ---*/
-    AzBytArr s_dp("; managed as dense data"); 
-    bool doSparse = false; 
-    if (dataproc == dataproc_Auto && 
-        nz_ratio < Az_nz_ratio_threshold || 
-        dataproc == dataproc_Sparse) { 
-      doSparse = true; 
-      s_dp.reset("; managed as sparse data"); 
+  /*---  mark the parameters as used when the data is prepared elsewhere  ---*/
+  static void ignoreParam(AzParam &p) {
+    AzBytArr s_dataproc; 
+    int max_bin; 
+    p.vStr(kw_dataproc, &s_dataproc); 
+    p.vInt(kw_max_bin, &max_bin); 
+  }
+
+  /*---  for the binary data cache (prepare_data, x_bin_fn=)  ---*/
+  /*---  to be called after reset_data                        ---*/
+  virtual void write(AzFile *file) {
+    const char *eyec = "AzDataForTrTree::write"; 
+    if (sorted_arr.featNum() != featNum()) {
+      throw new AzException(eyec, "data must be pre-sorted"); 
     }
-    if (dataproc != dataproc_Auto) s_dp.concat(" as requested."); 
-    else                           s_dp.concat("."); 
-    AzPrint::writeln(out, "-------------"); 
-    AzPrint::writeln(out, s, s_dp); 
-    AzPrint::writeln(out, "-------------"); 
+    bool isSparse = !AzSmatc::isNull(&m_tran_sparse); 
+    double nz_ratio = 0; 
+    if (isSparse) m_tran_sparse.nonZeroNum(&nz_ratio); 
+    else          nz_ratio = m_tran_dense.nonZeroRatio(); 
+    file->writeInt(data_num); 
+    file->writeInt(featNum()); 
+    file->writeDouble(nz_ratio); 
+    file->writeBool(isSparse); 
+    if (isSparse) m_tran_sparse.write(file); 
+    else          m_tran_dense.write(file); 
+    sorted_arr.write(file); 
+  }
+
+  /*---  read what was written by write() for training  ---*/
+  virtual void read_data(const AzOut &out, 
+                  AzFile *file, 
+                  AzParam &p, 
+                  bool beTight, 
+                  const AzSvFeatInfo *inp_feat=NULL)
+  {
+    const char *eyec = "AzDataForTrTree::read_data"; 
+    resetParam(p); 
+    printParam(out); 
+
+    int inp_data_num = file->readInt(); 
+    int inp_f_num = file->readInt(); 
+    double nz_ratio = file->readDouble(); 
+    bool isSparse = file->readBool(); 
+
+    if (dataproc == dataproc_Dense && isSparse || 
+        dataproc == dataproc_Sparse && !isSparse) {
+      /*---  pre-sorted in a different way; start over  ---*/
+      AzSmat m_data; 
+      _read_features(file, isSparse, &m_data); 
+      _reset_data(out, &m_data, beTight, inp_feat); 
+      return; 
+    }
+
+    AzBytArr s_dp(" (from "); s_dp.c(file->pointFileName()); s_dp.c(")"); 
+    print_data_info(out, inp_f_num, inp_data_num, nz_ratio, isSparse, s_dp.c_str()); 
 
-   /*---  pre-sort data  ---*/
     m_tran_sparse.reset(); 
     m_tran_dense.unlock(); 
     m_tran_dense.reset(); 
-    data_num = m_data->colNum(); 
-    if (doSparse) {
-      m_data->transpose(&m_tran_sparse); 
-      sorted_arr.reset_sparse(&m_tran_sparse, beTight); 
+    sorted_arr.reset(); 
+    binned.reset(); 
+    data_num = inp_data_num; 
+    if (isSparse) {
+      m_tran_sparse.read(file); 
+      if (dataproc == dataproc_Hist) binned.reset_sparse(&m_tran_sparse, max_bin); 
+      else                           sorted_arr.read_sparse(file, beTight); 
     }
     else {
-      m_tran_dense.transpose_from(m_data); 
-      sorted_arr.reset_dense(&m_tran_dense, beTight); 
+      m_tran_dense.read(file); 
+      if (dataproc == dataproc_Hist) binned.reset_dense(&m_tran_dense, max_bin); 
+      else                           sorted_arr.read_dense(file, &m_tran_dense, beTight); 
       /* prohibit any action to change the pointers to the column vectors */
       m_tran_dense.lock(); 
     }
     if (inp_feat != NULL) {
       feat.reset(inp_feat); 
-      if (feat.featNum() != m_data->rowNum()) {
-        throw new AzException(AzInputError, "AzDataForTrTree::reset", "#feat mismatch"); 
+      if (feat.featNum() != inp_f_num) {
+        throw new AzException(AzInputError, eyec, "#feat mismatch"); 
       }
     }
     else {
-      feat.reset(m_data->rowNum()); 
+      feat.reset(inp_f_num); 
     }
   }
 
+  /*---  read what was written by write() as test data: #feat x #data  ---*/
+  static void read_features(AzFile *file, 
+                            AzSmat *m_data) /* output */
+  {
+    file->readInt(); /* data_num */
+    file->readInt(); /* f_num */
+    file->readDouble(); /* nz_ratio */
+    bool isSparse = file->readBool(); 
+    _read_features(file, isSparse, m_data); 
+  }
+
   virtual void reset_data_for_test(const AzOut &out, 
                      const AzSmat *m_data) {
     bool doSparse = false; 
     if (m_data->rowNum()*m_data->colNum() > Az_max_test_entries) { /* large data */
-      /*---  dense is faster but uses up more memory if data is sparse  ---*/
       double nz_ratio; 
       m_data->nonZeroNum(&nz_ratio); 
-      if (nz_ratio < 0.6) { /* relatively sparse */
-        doSparse = true; 
-        AzBytArr s; s.c("Large and sparse test data (nonzero ratio=", nz_ratio); 
-        s.c("); treated as sparse data.");
-        AzPrint::writeln(out, s); 
-      }
+      doSparse = doSparse_for_test(out, nz_ratio); 
     }
 
     data_num = m_data->colNum(); 
     m_tran_dense.reset(); 
     m_tran_sparse.reset(); 
     if (doSparse) {    
-      m_data->transpose(&m_tran_sparse); 
+      m_tran_sparse.transpose_from(m_data); 
     }
     else {
       m_tran_dense.transpose_from(m_data); 
     }
     sorted_arr.reset(); 
+    binned.reset(); 
+    feat.reset(m_data->rowNum()); 
+  }
+  /*---  the data points (columns) of m_data in ia_dxs, or all of them if NULL  ---*/
+  virtual void reset_data_for_test(const AzOut &out, 
+                     const AzSmatc *m_data, 
+                     const AzIntArr *ia_dxs) { /* may be NULL */
+    int d_num = (ia_dxs == NULL) ? m_data->colNum() : ia_dxs->size(); 
+    bool doSparse = false; 
+    if (m_data->rowNum()*d_num > Az_max_test_entries) { /* large data */
+      double nz_ratio; 
+      if (ia_dxs == NULL) m_data->nonZeroNum(&nz_ratio); 
+      else                m_data->nonZeroNum(ia_dxs, &nz_ratio); 
+      doSparse = doSparse_for_test(out, nz_ratio); 
+    }
+
+    data_num = d_num; 
+    m_tran_dense.reset(); 
+    m_tran_sparse.reset(); 
+    if (doSparse) m_tran_sparse.transpose_from(m_data, ia_dxs); 
+    else          m_tran_dense.transpose_from(m_data, ia_dxs); 
+    sorted_arr.reset(); 
+    binned.reset(); 
     feat.reset(m_data->rowNum()); 
   }
 
@@ -158,7 +256,7 @@ public:
               double border_val) const
   {
     double value; 
-    if (AzSmat::isNull(&m_tran_sparse)) {
+    if (AzSmatc::isNull(&m_tran_sparse)) {
       value = m_tran_dense.get(dx, fx); 
     }
     else {
@@ -168,6 +266,53 @@ public:
     return false; 
   }
 
+  /*---  split data points by one feature at a time  ---*/
+  /*---  (ia_le_dx and ia_gt_dx keep the order of dxs)  ---*/
+  virtual void isLE(const int *dxs,
+                    int dxs_num,
+                    int fx,
+                    double border_val,
+                    /*---  output  ---*/
+                    AzIntArr *ia_le_dx,
+                    AzIntArr *ia_gt_dx) const
+  {
+    ia_le_dx->reset(); ia_le_dx->prepare(dxs_num); 
+    ia_gt_dx->reset(); ia_gt_dx->prepare(dxs_num); 
+    int ix; 
+    if (AzSmatc::isNull(&m_tran_sparse)) {
+      const AZ_MTX_FLOAT *val = m_tran_dense.col(fx)->point(); 
+      for (ix = 0; ix < dxs_num; ++ix) {
+        int dx = dxs[ix]; 
+        if (val[dx] <= border_val) ia_le_dx->put(dx); 
+        else                       ia_gt_dx->put(dx); 
+      }
+      return; 
+    }
+
+    /*---  sparse: scan the column along with dxs if dxs is sorted and  ---*/
+    /*---  the column is not much longer than dxs; binary search otherwise  ---*/
+    int e_num; 
+    const AZI_VECT_ELM *elm = m_tran_sparse.rawcol(fx, &e_num); 
+    bool doScan = (e_num <= dxs_num*8); 
+    for (ix = 1; ix < dxs_num && doScan; ++ix) {
+      if (dxs[ix] <= dxs[ix-1]) doScan = false; 
+    }
+    int ex = 0; 
+    for (ix = 0; ix < dxs_num; ++ix) {
+      int dx = dxs[ix]; 
+      double value; 
+      if (doScan) {
+        for ( ; ex < e_num && elm[ex].no < dx; ++ex); 
+        value = (ex < e_num && elm[ex].no == dx) ? elm[ex].val : 0; 
+      }
+      else {
+        value = m_tran_sparse.get(dx, fx); 
+      }
+      if (value <= border_val) ia_le_dx->put(dx); 
+      else                     ia_gt_dx->put(dx); 
+    }
+  }
+
   inline const AzSvFeatInfo *featInfo() const {
     return &feat; 
   }
@@ -179,13 +324,123 @@ public:
     return sorted_arr.sorted(fx); 
   }
 
+  /*---  NULL unless data_management=Hist  ---*/
+  virtual inline const AzBinnedFeat *binned_feat() const {
+    if (binned.featNum() <= 0) return NULL; 
+    return &binned; 
+  }
+
   /*------------------------------------------------*/
   virtual void printHelp(AzHelp &h) const {
     h.begin("", "AzDataForTrTree", "Data processing"); 
     h.item(kw_dataproc, help_dataproc, "Auto"); 
+    h.item(kw_max_bin, help_max_bin, max_bin_dflt); 
   }
 
 protected: 
+  virtual void _reset_data(const AzOut &out, 
+                  const AzSmat *m_data, 
+                  bool beTight, 
+                  const AzSvFeatInfo *inp_feat)
+  {
+    /*---  count nonzero components  ---*/
+    double nz_ratio; 
+    m_data->nonZeroNum(&nz_ratio); 
+
+    bool doSparse = begin_reset(out, m_data->rowNum(), m_data->colNum(), nz_ratio); 
+    if (doSparse) m_tran_sparse.transpose_from(m_data); 
+    else          m_tran_dense.transpose_from(m_data); 
+    end_reset(doSparse, beTight, m_data->rowNum(), inp_feat); 
+  }
+
+  /*---  decide sparse or dense and clear; returns true if sparse  ---*/
+  bool begin_reset(const AzOut &out, int f_num, int d_num, double nz_ratio) {
+    bool doSparse = false; 
+    if ((dataproc == dataproc_Auto || dataproc == dataproc_Hist) && 
+        nz_ratio < Az_nz_ratio_threshold || 
+        dataproc == dataproc_Sparse) { 
+      doSparse = true; 
+    }
+    print_data_info(out, f_num, d_num, nz_ratio, doSparse); 
+
+    m_tran_sparse.reset(); 
+    m_tran_dense.unlock(); 
+    m_tran_dense.reset(); 
+    sorted_arr.reset(); 
+    binned.reset(); 
+    data_num = d_num; 
+    return doSparse; 
+  }
+
+  /*---  pre-sort the transposed data  ---*/
+  void end_reset(bool doSparse, bool beTight, int f_num, 
+                 const AzSvFeatInfo *inp_feat) {
+    if (doSparse) {
+      if (dataproc == dataproc_Hist) binned.reset_sparse(&m_tran_sparse, max_bin); 
+      else                           sorted_arr.reset_sparse(&m_tran_sparse, beTight); 
+    }
+    else {
+      if (dataproc == dataproc_Hist) binned.reset_dense(&m_tran_dense, max_bin); 
+      else                           sorted_arr.reset_dense(&m_tran_dense, beTight); 
+      /* prohibit any action to change the pointers to the column vectors */
+      m_tran_dense.lock(); 
+    }
+    if (inp_feat != NULL) {
+      feat.reset(inp_feat); 
+      if (feat.featNum() != f_num) {
+        throw new AzException(AzInputError, "AzDataForTrTree::reset", "#feat mismatch"); 
+      }
+    }
+    else {
+      feat.reset(f_num); 
+    }
+  }
+
+  /*---  dense is faster but uses up more memory if large data is sparse  ---*/
+  static bool doSparse_for_test(const AzOut &out, double nz_ratio) {
+    if (nz_ratio >= 0.6) return false; 
+    AzBytArr s; s.c("Large and sparse test data (nonzero ratio=", nz_ratio); 
+    s.c("); treated as sparse data."); 
+    AzPrint::writeln(out, s); 
+    return true; 
+  }
+
+  virtual void print_data_info(const AzOut &out, 
+                               int f_num, int d_num, double nz_ratio, 
+                               bool doSparse, 
+                               const char *note="") const
+  {
+    AzBytArr s("Training data: "); 
+    s.cn(f_num);s.c("x");s.cn(d_num); 
+    s.c(", nonzero_ratio=", nz_ratio, 4); 
+
+    AzBytArr s_dp("; managed as dense data"); 
+    if (doSparse) s_dp.reset("; managed as sparse data"); 
+    if (dataproc == dataproc_Hist) {
+      s_dp.c(" quantized into at most "); s_dp.cn(max_bin); s_dp.c(" bins per feature"); 
+    }
+    s_dp.c(note); 
+    if (dataproc != dataproc_Auto) s_dp.concat(" as requested."); 
+    else                           s_dp.concat("."); 
+    AzPrint::writeln(out, "-------------"); 
+    AzPrint::writeln(out, s, s_dp); 
+    AzPrint::writeln(out, "-------------"); 
+  }
+
+  static void _read_features(AzFile *file, bool isSparse, 
+                             AzSmat *m_data) /* output: #feat x #data */
+  {
+    if (isSparse) {
+      AzSmat m_tran(file); 
+      m_tran.transpose(m_data); 
+    }
+    else {
+      AzDmat m_tran(file), m; 
+      m_tran.transpose(&m); 
+      m.convert(m_data); 
+    }
+  }
+
   /*---  for parameters  ---*/
   virtual void resetParam(AzParam &p) {
     p.vStr(kw_dataproc, &s_dataproc); 
@@ -194,9 +449,14 @@ protected:
         s_dataproc.compare("Auto") == 0); 
     else if (s_dataproc.compare("Sparse") == 0) dataproc = dataproc_Sparse; 
     else if (s_dataproc.compare("Dense") == 0)  dataproc = dataproc_Dense; 
+    else if (s_dataproc.compare("Hist") == 0)   dataproc = dataproc_Hist; 
     else {
       throw new AzException(AzInputNotValid, kw_dataproc, 
-            "must be either \"Auto\", \"Sparse\", or \"Dense\"."); 
+            "must be either \"Auto\", \"Sparse\", \"Dense\", or \"Hist\"."); 
+    }
+    p.vInt(kw_max_bin, &max_bin); 
+    if (dataproc == dataproc_Hist && (max_bin < 2 || max_bin > 65536)) {
+      throw new AzException(AzInputNotValid, kw_max_bin, "must be in [2, 65536]."); 
     }
   }
   virtual void printParam(const AzOut &out) const {
@@ -205,6 +465,7 @@ protected:
     if (s_dataproc.length() > 0) {
       o.ppBegin("AzDataForTrTree", "Data processing"); 
       o.printV(kw_dataproc, s_dataproc); 
+      if (dataproc == dataproc_Hist) o.printV(kw_max_bin, max_bin); 
       o.ppEnd(); 
     }
   }
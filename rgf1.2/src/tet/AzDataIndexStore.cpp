@@ -0,0 +1,181 @@
+/* * * * *
+ *  AzDataIndexStore.cpp
+ *  Copyright (C) 2011, 2012 Rie Johnson
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * */
+
+#include "AzDataIndexStore.hpp"
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+/*--------------------------------------------------------*/
+void AzDataIndexStore::reset()
+{
+#ifdef _WIN32
+  file.close(); 
+#else
+  int sx; 
+  for (sx = 0; sx < seg_num && map != NULL; ++sx) {
+    if (map[sx] != NULL) munmap(map[sx], seg_size); 
+  }
+  a_map.free(&map); 
+  if (fd >= 0) close(fd); 
+  fd = -1; 
+#endif
+  if (s_fn.length() > 0) remove(s_fn.c_str()); 
+  s_fn.reset(); 
+  seg_size = f_size = 0; 
+  seg_num = 0; 
+}
+
+/*--------------------------------------------------------*/
+void AzDataIndexStore::reset(const char *fn,
+                             AZint8 max_put_size)
+{
+  reset(); 
+  seg_size = min_seg_size; 
+  if (max_put_size > seg_size) {
+    AZint8 align = seg_align; 
+    seg_size = (max_put_size + align - 1) / align * align; 
+  }
+  /*---  a unique name so that the trainers running at the same time  ---*/
+  /*---  (sweep, cross validation, multi-class) have their own files   ---*/
+#ifdef _WIN32
+  static int count = 0; 
+  int my_count; 
+#ifdef _OPENMP
+#pragma omp critical (AzDataIndexStore_count)
+#endif
+  my_count = count++; 
+  AzBytArr s(fn); s.c("."); s.cn(_getpid()); s.c("."); s.cn(my_count); 
+  file.reset(s.c_str()); 
+  file.open("w+b"); 
+  s_fn.reset(&s); 
+#else
+  const char *eyec = "AzDataIndexStore::reset(fn,size)"; 
+  AzBytArr s(fn); s.c(".XXXXXX"); 
+  fd = mkstemp((char *)s.point_u()); /* created with 0600 */
+  if (fd < 0) {
+    throw new AzException(AzFileIOError, eyec, s.c_str(), strerror(errno)); 
+  }
+  s_fn.reset(&s); 
+#endif
+}
+
+/*--------------------------------------------------------*/
+AZint8 AzDataIndexStore::put(const int *dxs, int num)
+{
+  const char *eyec = "AzDataIndexStore::put"; 
+  if (!isActive()) {
+    throw new AzException(eyec, "not ready"); 
+  }
+  AZint8 len = (AZint8)num*sizeof(int); 
+  if (len > seg_size) {
+    throw new AzException(eyec, "too large"); 
+  }
+
+  /*---  at a page boundary, and don't straddle two segments  ---*/
+  AZint8 offs = (f_size + page_size - 1) / page_size * page_size; 
+  if (len > 0 && offs / seg_size != (offs + len - 1) / seg_size) {
+    offs = (offs / seg_size + 1) * seg_size; 
+  }
+  extend(offs + len); 
+  write_at(offs, dxs, len); 
+  f_size = offs + len; 
+  return offs; 
+}
+
+/*--------------------------------------------------------*/
+const int *AzDataIndexStore::get(AZint8 offs,
+                                 int num,
+                                 AzIntArr *ia_buff)
+{
+  const char *eyec = "AzDataIndexStore::get"; 
+  AZint8 len = (AZint8)num*sizeof(int); 
+  if (offs < 0 || offs % page_size != 0 || num < 0 || offs + len > f_size) {
+    throw new AzException(eyec, "offset is out of range"); 
+  }
+  if (num == 0) return NULL; 
+#ifdef _WIN32
+  ia_buff->reset(num, 0); 
+  file.seekReadBytes(offs, len, ia_buff->point_u()); 
+  return ia_buff->point(); 
+#else
+  return (const int *)point(offs, len); 
+#endif
+}
+
+/*--------------------------------------------------------*/
+void AzDataIndexStore::extend(AZint8 new_size)
+{
+  if (new_size <= (AZint8)seg_num*seg_size) return; 
+  int new_seg_num = (int)((new_size + seg_size - 1) / seg_size); 
+#ifndef _WIN32
+  if (ftruncate(fd, (off_t)new_seg_num*seg_size) != 0) {
+    throw new AzException(AzFileIOError, "AzDataIndexStore::extend", s_fn.c_str(), strerror(errno)); 
+  }
+  a_map.realloc(&map, new_seg_num, "AzDataIndexStore::extend", "map"); 
+  int sx; 
+  for (sx = seg_num; sx < new_seg_num; ++sx) map[sx] = NULL; 
+#endif
+  seg_num = new_seg_num; 
+}
+
+/*--------------------------------------------------------*/
+void AzDataIndexStore::write_at(AZint8 offs, const void *buff, AZint8 len)
+{
+#ifdef _WIN32
+  file.seek(offs); 
+  file.writeBytes(buff, len); 
+#else
+  const char *ptr = (const char *)buff; 
+  for ( ; len > 0; ) {
+    ssize_t written = pwrite(fd, ptr, (size_t)len, (off_t)offs); 
+    if (written < 0 && errno == EINTR) continue; 
+    if (written <= 0) {
+      throw new AzException(AzFileIOError, "AzDataIndexStore::write_at", s_fn.c_str(), strerror(errno)); 
+    }
+    ptr += written; offs += written; len -= written; 
+  }
+#endif
+}
+
+#ifndef _WIN32
+/*--------------------------------------------------------*/
+const AzByte *AzDataIndexStore::point(AZint8 offs,
+                                      AZint8 len)
+{
+  const char *eyec = "AzDataIndexStore::point"; 
+  int sx = (int)(offs / seg_size); 
+  if (sx >= seg_num || (offs + len - 1) / seg_size != sx) {
+    throw new AzException(eyec, "out of range"); 
+  }
+  if (map[sx] == NULL) {
+    void *ptr = mmap(NULL, (size_t)seg_size, PROT_READ, MAP_SHARED, fd, (off_t)sx*seg_size); 
+    if (ptr == MAP_FAILED) {
+      throw new AzException(AzFileIOError, eyec, s_fn.c_str(), strerror(errno)); 
+    }
+    map[sx] = (AzByte *)ptr; 
+  }
+  return map[sx] + (offs - (AZint8)sx*seg_size); 
+}
+#endif
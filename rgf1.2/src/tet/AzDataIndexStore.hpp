@@ -0,0 +1,97 @@
+/* * * * *
+ *  AzDataIndexStore.hpp
+ *  Copyright (C) 2011, 2012 Rie Johnson
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * */
+
+#ifndef _AZ_DATA_INDEX_STORE_HPP_
+#define _AZ_DATA_INDEX_STORE_HPP_
+
+#include "AzUtil.hpp"
+
+//! Temporary file of the data indexes of trees (temp_disk=), memory-mapped.
+/*-------------------------------------------------------------------
+ *  put() appends an array of data indexes as it is, at a page
+ *  boundary, and returns its offset.  get() returns a pointer into
+ *  the mapped file, so that the optimizer reads the data indexes of
+ *  the nodes in place without copying them; the pages that are not
+ *  used are left to the OS to drop.
+ *
+ *  The file is mapped segment by segment, and the segments are not
+ *  unmapped until reset, so that the pointers returned by get() stay
+ *  valid while more arrays are appended.  No array straddles two
+ *  segments.  Without mmap (_WIN32), get() reads into the buffer.
+ *-------------------------------------------------------------------*/
+class AzDataIndexStore {
+protected:
+  AzBytArr s_fn; 
+  AZint8 seg_size; 
+  AZint8 f_size;  /* bytes used */
+  int seg_num;    /* the file has been extended to seg_num*seg_size bytes */
+#ifdef _WIN32
+  AzFile file; 
+#else
+  int fd; 
+  AzByte **map;   /* [seg_num]: NULL until used */
+  AzBaseArray<AzByte *> a_map; 
+#endif
+
+  static const AZint8 page_size = 4096; /* where each array starts */
+  static const AZint8 min_seg_size = 64*1024*1024; 
+  static const AZint8 seg_align = 1024*1024; 
+
+public:
+#ifdef _WIN32
+  AzDataIndexStore() : seg_size(0), f_size(0), seg_num(0) {}
+#else
+  AzDataIndexStore() : seg_size(0), f_size(0), seg_num(0), fd(-1), map(NULL) {}
+#endif
+  ~AzDataIndexStore() {
+    try {
+      reset(); 
+    }
+    catch (AzException *e) {
+      delete e; /* don't throw from a destructor */
+    }
+  }
+
+  void reset(); /* the file is removed */
+  void reset(const char *fn, /* a unique suffix is attached */
+             AZint8 max_put_size); /* upper bound of the bytes for one array */
+  inline bool isActive() const { return (s_fn.length() > 0); }
+  inline AZint8 size() const { return f_size; }
+
+  AZint8 put(const int *dxs, int num); /* returns the offset */
+  const int *get(AZint8 offs,
+                 int num, /* must be what was put */
+                 AzIntArr *ia_buff); /* used only without mmap */
+
+  /*---  prohibit copy  ---*/
+  AzDataIndexStore(const AzDataIndexStore &inp) {
+    throw new AzException("AzDataIndexStore(const &)", "Don't copy"); 
+  }
+  AzDataIndexStore & operator =(const AzDataIndexStore &inp) {
+    if (this == &inp) return *this; 
+    throw new AzException("AzDataIndexStore:=", "Don't use ="); 
+  }
+
+protected:
+  void extend(AZint8 new_size); 
+  void write_at(AZint8 offs, const void *buff, AZint8 len); 
+#ifndef _WIN32
+  const AzByte *point(AZint8 offs, AZint8 len); 
+#endif
+}; 
+#endif
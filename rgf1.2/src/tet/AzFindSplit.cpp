@@ -18,6 +18,7 @@
  * * * * */
 
 #include "AzFindSplit.hpp"
+#include "AzTools.hpp"
 
 /*--------------------------------------------------------*/
 void AzFindSplit::_begin(const AzTrTree_ReadOnly *inp_tree, 
@@ -45,14 +46,31 @@ void AzFindSplit::_findBestSplit(int nx,
   const int *dxs = tree->node(nx)->data_indexes(); 
   const int dxs_num = tree->node(nx)->dxs_num; 
 
-  const AzSortedFeatArr *sorted_arr = tree->sorted_array(nx, data); 
-  if (sorted_arr == NULL) {
-    throw new AzException(eyec, "No sorted array?!"); 
+  const AzBinnedFeat *binned = data->binned_feat(); 
+  const AzHistFeat *hist = NULL; 
+  const AzSortedFeatArr *sorted_arr = NULL; 
+  if (binned != NULL) {
+    hist = tree->histogram(nx, data, target); 
+  }
+  else {
+    sorted_arr = tree->sorted_array(nx, data); 
+    if (sorted_arr == NULL) {
+      throw new AzException(eyec, "No sorted array?!"); 
+    }
+  }
+
+  /*---  with sample_ratio=, only the sampled rows are counted  ---*/
+  const AzByte *mask = tree->sample_mask(); 
+  AzIntArr ia_sampled; 
+  int search_num; 
+  const int *search_dxs = AzTrTree::sampled_dxs(mask, dxs, dxs_num, &ia_sampled, &search_num); 
+  if (search_num < 2) {
+    return; 
   }
 
   Az_forFindSplit total; 
-  total.wy_sum = target->getTarDwSum(dxs, dxs_num);
-  total.w_sum = target->getDwSum(dxs, dxs_num); 
+  total.wy_sum = target->getTarDwSum(search_dxs, search_num); 
+  total.w_sum = target->getDwSum(search_dxs, search_num); 
 
   /*---  go through features to find the best split  ---*/
   int feat_num = data->featNum(); 
@@ -60,11 +78,81 @@ void AzFindSplit::_findBestSplit(int nx,
   if (ia_fx != NULL) {
     fxs = ia_fx->point(&feat_num); 
   }
+
+  int th_num = 1; 
+  if (thread_num != 1) {
+    AZint8 work = (AZint8)search_num * (AZint8)feat_num; 
+    th_num = AzThreads::threadNum(thread_num, (int)MIN(feat_num, work/min_work_per_thread)); 
+  }
+  if (th_num <= 1) {
+    findBestSplit_feats(0, feat_num, fxs, sorted_arr, binned, hist, 
+                        mask, dxs_num, search_num, &total, best_split); 
+  }
+  else {
+    /*---  each thread takes a contiguous range of features; the results are  ---*/
+    /*---  merged in the order of features so that ties are broken the same  ---*/
+    /*---  way as on a single thread.                                        ---*/
+    AzDataArr<AzTrTsplit> arr_split(th_num); 
+    int thx; 
+    for (thx = 0; thx < th_num; ++thx) {
+      arr_split.point_u(thx)->copy(best_split); 
+    }
+    AzThreadErr th_err; 
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(th_num) schedule(static,1)
+#endif
+    for (thx = 0; thx < th_num; ++thx) {
+      try {
+        int ix_begin, ix_end; 
+        AzThreads::range(th_num, thx, feat_num, &ix_begin, &ix_end); 
+        findBestSplit_feats(ix_begin, ix_end, fxs, sorted_arr, binned, hist, 
+                            mask, dxs_num, search_num, &total, arr_split.point_u(thx)); 
+      }
+      catch (AzException *e) {
+        th_err.keep(e); 
+      }
+    }
+    th_err.throw_if(); 
+
+    for (thx = 0; thx < th_num; ++thx) {
+      const AzTrTsplit *th_split = arr_split.point(thx); 
+      if (th_split->fx >= 0 && th_split->gain > best_split->gain) {
+        best_split->copy(th_split); 
+      }
+    }
+  }
+
+  if (best_split->fx >= 0) {
+    if (!dmp_out.isNull()) {
+      data->featInfo()->desc(best_split->fx, &best_split->str_desc); 
+    }
+  }
+}
+
+/*--------------------------------------------------------*/
+void AzFindSplit::findBestSplit_feats(int ix_begin, int ix_end, 
+                                 const int *fxs, /* may be NULL */
+                                 const AzSortedFeatArr *sorted_arr, 
+                                 const AzBinnedFeat *binned, 
+                                 const AzHistFeat *hist, 
+                                 const AzByte *mask, /* may be NULL */
+                                 int dxs_num, 
+                                 int search_num, /* #sampled */
+                                 const Az_forFindSplit *total, 
+                                 /*---  output  ---*/
+                                 AzTrTsplit *best_split)
+{
+  const char *eyec = "AzFindSplit::findBestSplit_feats"; 
   int ix; 
-  for (ix = 0; ix < feat_num; ++ix) {
+  for (ix = ix_begin; ix < ix_end; ++ix) {
     int fx = ix; 
     if (fxs != NULL) fx = fxs[ix]; 
 
+    if (hist != NULL) {
+      loop_hist(best_split, fx, binned, hist, search_num, total); 
+      continue; 
+    }
+
     AzSortedFeatWork tmp; 
     const AzSortedFeat *sorted = sorted_arr->sorted(fx); 
     if (sorted == NULL) { /* This happens only with Thrift or warm-start */
@@ -72,16 +160,10 @@ void AzFindSplit::_findBestSplit(int nx,
       if (my_sorted->dataNum() != dxs_num) {
         throw new AzException(eyec, "conflict in #data"); 
       }
-      loop(best_split, fx, my_sorted, dxs_num, &total); 
+      loop(best_split, fx, my_sorted, mask, search_num, total); 
     }
     else {
-      loop(best_split, fx, sorted, dxs_num, &total); 
-    }
-  }
-
-  if (best_split->fx >= 0) {
-    if (!dmp_out.isNull()) {
-      data->featInfo()->desc(best_split->fx, &best_split->str_desc); 
+      loop(best_split, fx, sorted, mask, search_num, total); 
     }
   }
 }
@@ -101,6 +183,7 @@ double AzFindSplit::evalSplit(const Az_forFindSplit i[2],
 void AzFindSplit::loop(AzTrTsplit *best_split, 
                        int fx, /* feature# */
                        const AzSortedFeat *sorted, 
+                       const AzByte *mask, /* may be NULL */
                        int total_size, 
                        const Az_forFindSplit *total)
 {
@@ -130,19 +213,35 @@ void AzFindSplit::loop(AzTrTsplit *best_split,
     const int *index = NULL; 
     index = sorted->next(cursor, &value, &index_num); 
     if (index == NULL) break; 
-    dest_size += index_num;  
-    if (dest_size >= total_size) {
-      break; /* don't allow all vs nothing */
-    }
 
     const double *tarDw = target->tarDw_arr(); 
     const double *dw = target->dw_arr(); 
     double wy_sum_move = 0, w_sum_move = 0; 
+    int move_num = index_num; 
     int ix; 
-    for (ix = 0; ix < index_num; ++ix) {
-      int dx = index[ix]; 
-      wy_sum_move += tarDw[dx]; 
-      w_sum_move += dw[dx]; 
+    if (mask == NULL) {
+      for (ix = 0; ix < index_num; ++ix) {
+        int dx = index[ix]; 
+        wy_sum_move += tarDw[dx]; 
+        w_sum_move += dw[dx]; 
+      }
+    }
+    else {
+      /*---  skip the rows that are not sampled  ---*/
+      move_num = 0; 
+      for (ix = 0; ix < index_num; ++ix) {
+        int dx = index[ix]; 
+        if (!mask[dx]) continue; 
+        wy_sum_move += tarDw[dx]; 
+        w_sum_move += dw[dx]; 
+        ++move_num; 
+      }
+      if (move_num == 0) continue; 
+    }
+
+    dest_size += move_num;  
+    if (dest_size >= total_size) {
+      break; /* don't allow all vs nothing */
     }
     dest->wy_sum += wy_sum_move; 
     dest->w_sum += w_sum_move; 
@@ -173,7 +272,63 @@ void AzFindSplit::loop(AzTrTsplit *best_split,
 }
 
 /*--------------------------------------------------------*/
-void AzFindSplit::_pickFeats(int pick_num, int f_num)
+/* Same as loop() but bins play the role of distinct values */
+/*--------------------------------------------------------*/
+void AzFindSplit::loop_hist(AzTrTsplit *best_split, 
+                       int fx, /* feature# */
+                       const AzBinnedFeat *binned, 
+                       const AzHistFeat *hist, 
+                       int total_size, 
+                       const Az_forFindSplit *total)
+{
+  int offs = binned->binOffset(fx); 
+  int bin_num = binned->binNum(fx); 
+  const double *border = binned->borders(fx); 
+  const double *wy = hist->wy_arr() + offs; 
+  const double *w = hist->w_arr() + offs; 
+  const int *num = hist->num_arr() + offs; 
+
+  int dest_size = 0; 
+  Az_forFindSplit i[2]; 
+  Az_forFindSplit *src = &i[1], *dest = &i[0]; /* gt, le */
+  double bestP[2] = {0,0}; 
+  int bx; 
+  for (bx = 0; bx < bin_num; ++bx) {
+    if (num[bx] == 0) continue; 
+    dest_size += num[bx]; 
+    if (dest_size >= total_size) {
+      break; /* don't allow all vs nothing */
+    }
+    dest->wy_sum += wy[bx]; 
+    dest->w_sum += w[bx]; 
+
+    if (min_size > 0) {
+      if (dest_size < min_size) {
+        continue; 
+      }
+      if (total_size - dest_size < min_size) {
+        break; 
+      }
+    }
+
+    src->wy_sum = total->wy_sum - dest->wy_sum; 
+    src->w_sum  = total->w_sum  - dest->w_sum; 
+
+    double gain = evalSplit(i, bestP); 
+    if (gain > best_split->gain) {
+      best_split->reset_values(fx, border[bx], gain, 
+                               bestP[0], bestP[1]); 
+    }
+  }
+}
+
+/*--------------------------------------------------------*/
+/* A hash of the seed, the draw#, and the trial# is used instead of */
+/* rand() so that trainers running at the same time don't affect   */
+/* each other, as in AzTrTree::sample.                              */
+/*--------------------------------------------------------*/
+void AzFindSplit::_pickFeats(int pick_num, int f_num, 
+                             int seed, int draw_no)
 {
   if (pick_num < 1 || pick_num > f_num) {
     throw new AzException("AzFindSplit::pickFeats", "out of range"); 
@@ -187,9 +342,11 @@ void AzFindSplit::_pickFeats(int pick_num, int f_num)
   AzIntArr ia_onOff; 
   ia_onOff.reset(f_num, 0); 
   int *onOff = ia_onOff.point_u(); 
-  for ( ; ; ) {
+  unsigned int key = AzTools::mix32((unsigned int)seed * 0x9e3779b9U + (unsigned int)draw_no); 
+  unsigned int trial; 
+  for (trial = 0; ; ++trial) {
     if (ia_feats.size() >= pick_num) break; 
-    int fx = rand() % f_num; 
+    int fx = (int)(AzTools::mix32(key ^ trial) % (unsigned int)f_num); 
     if (onOff[fx] == 0) {
       onOff[fx] = 1; 
       ia_feats.put(fx); 
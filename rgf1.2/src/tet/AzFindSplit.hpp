@@ -24,6 +24,7 @@
 #include "AzTrTtarget.hpp"
 #include "AzTrTsplit.hpp"
 #include "AzTrTree.hpp"
+#include "AzThreads.hpp"
 
 class Az_forFindSplit {
 public:
@@ -47,9 +48,12 @@ protected:
   AzIntArr ia_feats; 
   const AzIntArr *ia_fx; 
 
+  int thread_num; /* num_threads= */
+  const static int min_work_per_thread = 4096; /* #data x #feature */
+
 public:
   AzFindSplit() : target(NULL), data(NULL), tree(NULL), ia_fx(NULL), 
-                  min_size(-1) {}
+                  min_size(-1), thread_num(1) {}
   ~AzFindSplit() {}
   void reset() {
     target = NULL;
@@ -73,7 +77,8 @@ public:
   //                 AzTrTsplit *best_split); /* output */
   //----------------------------------------------------------------
 
-  virtual void _pickFeats(int pick_num, int f_num); 
+  virtual void _pickFeats(int pick_num, int f_num, 
+                          int seed, int draw_no); /* the same features for the same seed and draw# */
 
 protected: 
   /*----------------------------------------------------------------*/
@@ -89,9 +94,27 @@ protected:
   void _findBestSplit(int nx, 
                       /*---  output  ---*/
                       AzTrTsplit *best_split); 
+  void findBestSplit_feats(int ix_begin, int ix_end, /* index into fxs */
+                      const int *fxs, /* may be NULL */
+                      const AzSortedFeatArr *sorted_arr, 
+                      const AzBinnedFeat *binned, 
+                      const AzHistFeat *hist, 
+                      const AzByte *mask, /* may be NULL */
+                      int dxs_num, 
+                      int search_num, /* #sampled */
+                      const Az_forFindSplit *total, 
+                      /*---  output  ---*/
+                      AzTrTsplit *best_split); 
   void loop(AzTrTsplit *best_split, 
             int fx, /* feature# */
             const AzSortedFeat *sorted, 
+            const AzByte *mask, /* may be NULL */
+            int dxs_num, 
+            const Az_forFindSplit *total); 
+  void loop_hist(AzTrTsplit *best_split, 
+            int fx, /* feature# */
+            const AzBinnedFeat *binned, 
+            const AzHistFeat *hist, 
             int dxs_num, 
             const Az_forFindSplit *total); 
 }; 
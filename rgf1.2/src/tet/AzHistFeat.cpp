@@ -0,0 +1,340 @@
+/* * * * *
+ *  AzHistFeat.cpp 
+ *  Copyright (C) 2011, 2012 Rie Johnson
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * */
+
+#include "AzHistFeat.hpp"
+
+/*------------------------------------------------------*/
+/*------------------------------------------------------*/
+void AzBinnedFeat::_reset(int inp_data_num, int inp_f_num, int inp_max_bin)
+{
+  const char *eyec = "AzBinnedFeat::_reset"; 
+  reset(); 
+  if (inp_max_bin < 2 || inp_max_bin > 65536) {
+    throw new AzException(eyec, "max_bin must be in [2, 65536]"); 
+  }
+  data_num = inp_data_num; 
+  f_num = inp_f_num; 
+  max_bin = inp_max_bin; 
+  ia_bin_offs.reset(); 
+  ia_bin_offs.put(0); 
+}
+
+/*------------------------------------------------------*/
+void AzBinnedFeat::setBorderVect(const AzIFarr *ifa_border)
+{
+  v_border.reform(ifa_border->size()); 
+  int bx; 
+  for (bx = 0; bx < ifa_border->size(); ++bx) {
+    v_border.set(bx, ifa_border->get(bx)); 
+  }
+}
+
+/*------------------------------------------------------*/
+void AzBinnedFeat::reset_dense(const AzValMat *m_tran_dense,
+                               int inp_max_bin)
+{
+  const char *eyec = "AzBinnedFeat::reset_dense"; 
+  _reset(m_tran_dense->rowNum(), m_tran_dense->colNum(), inp_max_bin); 
+  AZint8 sz = (AZint8)data_num * (AZint8)f_num; 
+  if (max_bin <= 256) a_bins8.alloc(&bins8, sz, eyec, "bins8"); 
+  else                a_bins16.alloc(&bins16, sz, eyec, "bins16"); 
+
+  AzIFarr ifa_border; 
+  int fx; 
+  for (fx = 0; fx < f_num; ++fx) {
+    AzIFarr ifa_dx_val; 
+    ifa_dx_val.reset(m_tran_dense->col(fx)->point(), data_num); 
+    ifa_dx_val.sort_Float(true); 
+    setBorders(&ifa_dx_val, 0, &ifa_border); 
+    ia_bin_offs.put(ifa_border.size()); 
+    setBins(fx, &ifa_dx_val, &ifa_border); 
+  }
+  setBorderVect(&ifa_border); 
+}
+
+/*------------------------------------------------------*/
+/* Only the entries not in the bin of zero are kept so  */
+/* that memory is proportional to #nonzero.             */
+/*------------------------------------------------------*/
+void AzBinnedFeat::reset_sparse(const AzSmatc *m_tran_sparse,
+                                int inp_max_bin)
+{
+  const char *eyec = "AzBinnedFeat::reset_sparse"; 
+  _reset(m_tran_sparse->rowNum(), m_tran_sparse->colNum(), inp_max_bin); 
+
+  AzIFarr ifa_border; 
+  int fx; 
+  for (fx = 0; fx < f_num; ++fx) {
+    AzIFarr ifa_dx_val; 
+    m_tran_sparse->col(fx)->nonZero(&ifa_dx_val); 
+    ifa_dx_val.sort_Float(true); 
+    int zero_num = data_num - ifa_dx_val.size(); 
+    setBorders(&ifa_dx_val, zero_num, &ifa_border); 
+    ia_bin_offs.put(ifa_border.size()); 
+  }
+  setBorderVect(&ifa_border); 
+
+  ia_zero_bin.reset(f_num, 0); 
+  ia_bin_feat.reset(totalBinNum(), 0); 
+  for (fx = 0; fx < f_num; ++fx) {
+    ia_zero_bin.update(fx, bin_of(fx, 0)); 
+    int bx; 
+    for (bx = binOffset(fx); bx < binOffset(fx+1); ++bx) ia_bin_feat.update(bx, fx); 
+  }
+
+  /*---  count the entries of each data point, and then fill them  ---*/
+  a_sp_begin.alloc(&sp_begin, data_num+1, eyec, "sp_begin"); 
+  int dx; 
+  for (dx = 0; dx <= data_num; ++dx) sp_begin[dx] = 0; 
+  for (fx = 0; fx < f_num; ++fx) {
+    int num; 
+    const AZI_VECT_ELM *elm = m_tran_sparse->rawcol(fx, &num); 
+    int ix; 
+    for (ix = 0; ix < num; ++ix) {
+      if (bin_of(fx, elm[ix].val) != ia_zero_bin.get(fx)) ++sp_begin[elm[ix].no+1]; 
+    }
+  }
+  for (dx = 0; dx < data_num; ++dx) sp_begin[dx+1] += sp_begin[dx]; 
+  a_sp_bins.alloc(&sp_bins, MAX(1, sp_begin[data_num]), eyec, "sp_bins"); 
+  AzBaseArray<AZint8> a_pos; 
+  AZint8 *pos = NULL; 
+  a_pos.alloc(&pos, data_num, eyec, "pos"); 
+  for (dx = 0; dx < data_num; ++dx) pos[dx] = sp_begin[dx]; 
+  for (fx = 0; fx < f_num; ++fx) {
+    int num; 
+    const AZI_VECT_ELM *elm = m_tran_sparse->rawcol(fx, &num); 
+    int ix; 
+    for (ix = 0; ix < num; ++ix) {
+      int bx = bin_of(fx, elm[ix].val); 
+      if (bx != ia_zero_bin.get(fx)) sp_bins[pos[elm[ix].no]++] = bx; 
+    }
+  }
+}
+
+/*------------------------------------------------------*/
+/* Bin borders are chosen so that each bin has roughly  */
+/* the same number of data points.  A value never       */
+/* straddles two bins.                                  */
+/*------------------------------------------------------*/
+int AzBinnedFeat::setBorders(const AzIFarr *ifa_dx_val, /* sorted by value */
+                             int zero_num, /* #zeroes not in ifa_dx_val */
+                             AzIFarr *ifa_border) /* appended */
+const
+{
+  /*---  distinct values and their counts  ---*/
+  AzIFarr ifa_cnt_val; 
+  bool isZeroDone = (zero_num <= 0); 
+  int ix; 
+  for (ix = 0; ix < ifa_dx_val->size(); ++ix) {
+    double val = ifa_dx_val->get(ix); 
+    if (!isZeroDone && val > 0) {
+      ifa_cnt_val.put(zero_num, 0); 
+      isZeroDone = true; 
+    }
+    int last = ifa_cnt_val.size() - 1; 
+    int cnt; 
+    if (last >= 0 && ifa_cnt_val.get(last, &cnt) == val) {
+      ifa_cnt_val.update(last, cnt+1, val); 
+    }
+    else {
+      ifa_cnt_val.put(1, val); 
+    }
+  }
+  if (!isZeroDone) {
+    ifa_cnt_val.put(zero_num, 0); 
+  }
+
+  int dist_num = ifa_cnt_val.size(); 
+  if (dist_num <= max_bin) { /* one bin for each value */
+    for (ix = 0; ix < dist_num; ++ix) {
+      ifa_border->put(AzNone, ifa_cnt_val.get(ix)); 
+    }
+    return dist_num; 
+  }
+
+  int bin_num = 0; 
+  int rest_num = data_num, rest_bins = max_bin; 
+  int acc = 0; 
+  for (ix = 0; ix < dist_num; ++ix) {
+    int cnt; 
+    double val = ifa_cnt_val.get(ix, &cnt); 
+    acc += cnt; 
+    if (ix == dist_num - 1 ||
+        rest_bins > 1 && acc >= (double)rest_num/(double)rest_bins) {
+      ifa_border->put(AzNone, val); 
+      ++bin_num; 
+      rest_num -= acc; 
+      --rest_bins; 
+      acc = 0; 
+    }
+  }
+  return bin_num; 
+}
+
+/*------------------------------------------------------*/
+void AzBinnedFeat::setBins(int fx,
+                           const AzIFarr *ifa_dx_val,
+                           const AzIFarr *ifa_border)
+{
+  int offs = ia_bin_offs.get(fx); 
+  int bin_num = binNum(fx); 
+  AzDvect v_fborder(bin_num); 
+  int bx; 
+  for (bx = 0; bx < bin_num; ++bx) {
+    v_fborder.set(bx, ifa_border->get(offs+bx)); 
+  }
+  const double *border = v_fborder.point(); 
+
+  /*---  zero first, as sparse data doesn't list zeroes  ---*/
+  int zero_bin = bin_of(border, bin_num, 0); 
+  int dx; 
+  for (dx = 0; dx < data_num; ++dx) {
+    AZint8 pos = (AZint8)dx*f_num + fx; 
+    if (bins8 != NULL) bins8[pos] = (unsigned char)zero_bin; 
+    else               bins16[pos] = (unsigned short)zero_bin; 
+  }
+  int ix; 
+  for (ix = 0; ix < ifa_dx_val->size(); ++ix) {
+    double val = ifa_dx_val->get(ix, &dx); 
+    AZint8 pos = (AZint8)dx*f_num + fx; 
+    int bin = bin_of(border, bin_num, val); 
+    if (bins8 != NULL) bins8[pos] = (unsigned char)bin; 
+    else               bins16[pos] = (unsigned short)bin; 
+  }
+}
+
+/*------------------------------------------------------*/
+/* the first bin whose border is no smaller than val    */
+int AzBinnedFeat::bin_of(const double *border, int bin_num, double val)
+{
+  int lo = 0, hi = bin_num - 1; 
+  while (lo < hi) {
+    int mid = (lo + hi) / 2; 
+    if (border[mid] >= val) hi = mid; 
+    else                    lo = mid + 1; 
+  }
+  return lo; 
+}
+
+/*------------------------------------------------------*/
+void AzBinnedFeat::accumulate(const int *dxs, int dxs_num,
+                              const double *tarDw, const double *dw,
+                              /*---  output  ---*/
+                              double *wy, double *w, int *num) const
+{
+  if (bins8 != NULL) {
+    _accumulate(bins8, f_num, ia_bin_offs.point(), dxs, dxs_num,
+                tarDw, dw, wy, w, num); 
+  }
+  else if (bins16 != NULL) {
+    _accumulate(bins16, f_num, ia_bin_offs.point(), dxs, dxs_num,
+                tarDw, dw, wy, w, num); 
+  }
+  else if (sp_begin != NULL) {
+    _accumulate_sparse(dxs, dxs_num, tarDw, dw, wy, w, num); 
+  }
+}
+
+/*------------------------------------------------------*/
+/* Every data point is first moved out of the bin of    */
+/* zero for the listed features, and then all of them   */
+/* are added to the bin of zero of every feature.       */
+/*------------------------------------------------------*/
+void AzBinnedFeat::_accumulate_sparse(const int *dxs, int dxs_num,
+                              const double *tarDw, const double *dw,
+                              /*---  output  ---*/
+                              double *wy, double *w, int *num) const
+{
+  const int *zero_bin = ia_zero_bin.point(); 
+  const int *bin_feat = ia_bin_feat.point(); 
+  double tdw_sum = 0, dw_sum = 0; 
+  int ix; 
+  for (ix = 0; ix < dxs_num; ++ix) {
+    int dx = dxs[ix]; 
+    double tdw = tarDw[dx], ddw = dw[dx]; 
+    tdw_sum += tdw; 
+    dw_sum += ddw; 
+    AZint8 px; 
+    for (px = sp_begin[dx]; px < sp_begin[dx+1]; ++px) {
+      int bx = sp_bins[px]; 
+      int zx = zero_bin[bin_feat[bx]]; 
+      wy[bx] += tdw; w[bx] += ddw; ++num[bx]; 
+      wy[zx] -= tdw; w[zx] -= ddw; --num[zx]; 
+    }
+  }
+  int fx; 
+  for (fx = 0; fx < f_num; ++fx) {
+    int zx = zero_bin[fx]; 
+    num[zx] += dxs_num; 
+    if (num[zx] == 0) {
+      wy[zx] = w[zx] = 0; /* avoid round-off */
+    }
+    else {
+      wy[zx] += tdw_sum; 
+      w[zx] += dw_sum; 
+    }
+  }
+}
+
+/*------------------------------------------------------*/
+/*------------------------------------------------------*/
+void AzHistFeat::reset(const AzBinnedFeat *binned,
+                       const int *dxs, int dxs_num,
+                       const AzTrTtarget *target)
+{
+  int bin_num = binned->totalBinNum(); 
+  v_wy.reform(bin_num); 
+  v_w.reform(bin_num); 
+  ia_num.reset(bin_num, 0); 
+  binned->accumulate(dxs, dxs_num, target->tarDw_arr(), target->dw_arr(),
+                     v_wy.point_u(), v_w.point_u(), ia_num.point_u()); 
+  isParent = false; 
+  isFresh = false; 
+}
+
+/*------------------------------------------------------*/
+void AzHistFeat::reset_by_subtraction(const AzHistFeat *parent,
+                                      const AzHistFeat *sibling,
+                                      double sibling_shift,
+                                      double my_shift)
+{
+  int bin_num = parent->v_wy.rowNum(); 
+  if (sibling->v_wy.rowNum() != bin_num) {
+    throw new AzException("AzHistFeat::reset_by_subtraction", "#bin mismatch"); 
+  }
+  v_wy.reform(bin_num); 
+  v_w.reform(bin_num); 
+  ia_num.reset(bin_num, 0); 
+
+  const double *p_wy = parent->v_wy.point(), *s_wy = sibling->v_wy.point(); 
+  const double *p_w = parent->v_w.point(), *s_w = sibling->v_w.point(); 
+  const int *p_num = parent->ia_num.point(), *s_num = sibling->ia_num.point(); 
+  double *wy = v_wy.point_u(), *w = v_w.point_u(); 
+  int *num = ia_num.point_u(); 
+  int bx; 
+  for (bx = 0; bx < bin_num; ++bx) {
+    num[bx] = p_num[bx] - s_num[bx]; 
+    if (num[bx] <= 0) continue; /* avoid round-off */
+    w[bx] = p_w[bx] - s_w[bx]; 
+    /*---  the sibling's sum before its targets were lowered  ---*/
+    double s_wy_org = s_wy[bx] + sibling_shift*s_w[bx]; 
+    wy[bx] = p_wy[bx] - s_wy_org - my_shift*w[bx]; 
+  }
+  isParent = false; 
+  isFresh = false; 
+}
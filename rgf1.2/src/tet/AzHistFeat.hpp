@@ -0,0 +1,169 @@
+/* * * * *
+ *  AzHistFeat.hpp 
+ *  Copyright (C) 2011, 2012 Rie Johnson
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * */
+
+#ifndef _AZ_HIST_FEAT_HPP_
+#define _AZ_HIST_FEAT_HPP_
+
+#include "AzUtil.hpp"
+#include "AzSmat.hpp"
+#include "AzSmatc.hpp"
+#include "AzDmat.hpp"
+#include "AzValMat.hpp"
+#include "AzTrTtarget.hpp"
+
+//! Feature values quantized into bins.  Alternative to AzSortedFeatArr.
+/*--------------------------------------------------------*/
+class AzBinnedFeat {
+protected:
+  int data_num, f_num; 
+  int max_bin; 
+  AzIntArr ia_bin_offs; /* feature# -> first bin# of the feature; size: #feat+1 */
+  AzDvect v_border;     /* bin# -> largest value that falls into the bin */
+
+  /*---  dense: bin matrix: [dx*f_num+fx] -> bin# within the feature  ---*/
+  /*---  only one of them is used depending on max_bin                 ---*/
+  unsigned char *bins8; 
+  AzBaseArray<unsigned char, AZint8> a_bins8; 
+  unsigned short *bins16; 
+  AzBaseArray<unsigned short, AZint8> a_bins16; 
+
+  /*---  sparse: only the features not in the bin of zero are listed  ---*/
+  /*---  for each data point, as bin# (not within the feature)        ---*/
+  AZint8 *sp_begin;   /* [data_num+1]: dx -> first position in sp_bins */
+  AzBaseArray<AZint8> a_sp_begin; 
+  int *sp_bins; 
+  AzBaseArray<int, AZint8> a_sp_bins; 
+  AzIntArr ia_zero_bin; /* feature# -> bin# of zero */
+  AzIntArr ia_bin_feat; /* bin# -> feature# */
+
+public:
+  AzBinnedFeat() : data_num(0), f_num(0), max_bin(0),
+                   bins8(NULL), bins16(NULL), sp_begin(NULL), sp_bins(NULL) {}
+  void reset() {
+    data_num = f_num = max_bin = 0; 
+    ia_bin_offs.reset(); 
+    v_border.reset(); 
+    a_bins8.free(&bins8); 
+    a_bins16.free(&bins16); 
+    a_sp_begin.free(&sp_begin); 
+    a_sp_bins.free(&sp_bins); 
+    ia_zero_bin.reset(); 
+    ia_bin_feat.reset(); 
+  }
+  void reset_dense(const AzValMat *m_tran_dense, int max_bin); 
+  void reset_sparse(const AzSmatc *m_tran_sparse, int max_bin); 
+
+  inline int dataNum() const { return data_num; }
+  inline int featNum() const { return f_num; }
+  inline int totalBinNum() const { return v_border.rowNum(); }
+  inline int binOffset(int fx) const { return ia_bin_offs.get(fx); }
+  inline int binNum(int fx) const {
+    return ia_bin_offs.get(fx+1) - ia_bin_offs.get(fx); 
+  }
+  inline const double *borders(int fx) const {
+    return v_border.point() + ia_bin_offs.get(fx); 
+  }
+
+  /*---  add up tarDw and dw of the given data points for every bin  ---*/
+  void accumulate(const int *dxs, int dxs_num,
+                  const double *tarDw, const double *dw,
+                  /*---  output  ---*/
+                  double *wy, double *w, int *num) const; 
+
+protected:
+  void _reset(int inp_data_num, int inp_f_num, int inp_max_bin); 
+  void setBorderVect(const AzIFarr *ifa_border); 
+  int setBorders(const AzIFarr *ifa_dx_val, int zero_num,
+                 AzIFarr *ifa_border) const; /* appended */
+  void setBins(int fx, const AzIFarr *ifa_dx_val,
+               const AzIFarr *ifa_border); 
+
+  static int bin_of(const double *border, int bin_num, double val); 
+  inline int bin_of(int fx, double val) const {
+    return ia_bin_offs.get(fx) + bin_of(borders(fx), binNum(fx), val); 
+  }
+
+  void _accumulate_sparse(const int *dxs, int dxs_num,
+                          const double *tarDw, const double *dw,
+                          double *wy, double *w, int *num) const; 
+
+  template<class T>
+  static void _accumulate(const T *bins, int f_num, const int *offs,
+                          const int *dxs, int dxs_num,
+                          const double *tarDw, const double *dw,
+                          double *wy, double *w, int *num) {
+    int ix; 
+    for (ix = 0; ix < dxs_num; ++ix) {
+      int dx = dxs[ix]; 
+      const T *row = bins + (AZint8)dx*f_num; 
+      double tdw = tarDw[dx], ddw = dw[dx]; 
+      int fx; 
+      for (fx = 0; fx < f_num; ++fx) {
+        int bx = offs[fx] + row[fx]; 
+        wy[bx] += tdw; 
+        w[bx] += ddw; 
+        ++num[bx]; 
+      }
+    }
+  }
+}; 
+
+//! Per-node histograms of weighted targets over the bins of all features.
+/*--------------------------------------------------------*/
+class AzHistFeat {
+protected:
+  AzDvect v_wy, v_w; /* bin# -> sum of tarDw, sum of dw */
+  AzIntArr ia_num;   /* bin# -> #data */
+
+  /*---  set when the node is split so that children can be derived  ---*/
+  bool isParent; 
+  double shift[2]; /* le, gt: how much targets of the children are lowered */
+
+  bool isFresh;    /* derived and not used yet */
+
+public:
+  AzHistFeat() : isParent(false), isFresh(false) {
+    shift[0] = shift[1] = 0; 
+  }
+  void reset(const AzBinnedFeat *binned,
+             const int *dxs, int dxs_num,
+             const AzTrTtarget *target); 
+
+  /*---  this <- parent - sibling, where the targets of the sibling  ---*/
+  /*---  and this node were lowered after the parent was evaluated  ---*/
+  void reset_by_subtraction(const AzHistFeat *parent,
+                            const AzHistFeat *sibling,
+                            double sibling_shift,
+                            double my_shift); 
+
+  inline void keep_for_children(double le_shift, double gt_shift) {
+    isParent = true; 
+    shift[0] = le_shift; 
+    shift[1] = gt_shift; 
+  }
+  inline bool canDerive() const { return isParent; }
+  inline double childShift(int index) const { return shift[index]; }
+
+  inline void set_fresh(bool inp) { isFresh = inp; }
+  inline bool is_fresh() const { return isFresh; }
+
+  inline const double *wy_arr() const { return v_wy.point(); }
+  inline const double *w_arr() const { return v_w.point(); }
+  inline const int *num_arr() const { return ia_num.point(); }
+}; 
+#endif
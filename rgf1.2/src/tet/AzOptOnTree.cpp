@@ -95,6 +95,28 @@ AzOptOnTree::_warmup(const AzTrTreeEnsemble_ReadOnly *inp_ens,
   v_p.set(inp_v_p); 
 }
 
+/*--------------------------------------------------------*/
+void AzOptOnTree::write_checkpoint(AzFile *file)
+{
+  v_w.write(file); 
+  v_p.write(file); 
+  file->writeDouble(var_const); 
+  file->writeDouble(fixed_const); 
+}
+
+/*--------------------------------------------------------*/
+void AzOptOnTree::read_checkpoint(AzFile *file)
+{
+  v_w.read(file); 
+  v_p.read(file); 
+  if (v_p.rowNum() != v_y.rowNum()) {
+    throw new AzException(AzInputError, "AzOptOnTree::read_checkpoint", 
+                          "#data conflict"); 
+  }
+  var_const = file->readDouble(); 
+  fixed_const = file->readDouble(); 
+}
+
 /*--------------------------------------------------------*/
 void AzOptOnTree::copy_from(const AzOptOnTree *inp)
 {
@@ -120,6 +142,8 @@ void AzOptOnTree::copy_from(const AzOptOnTree *inp)
   doIntercept = inp->doIntercept; 
   doUnregIntercept = inp->doUnregIntercept; 
   doUseAvg = inp->doUseAvg; 
+  doParallel = inp->doParallel; 
+  thread_num = inp->thread_num; 
 
   ens = NULL; 
   tree_feat = NULL; 
@@ -299,17 +323,87 @@ void AzOptOnTree::_update_with_features(
 {
   int fx; 
   int f_num = tree_feat->featNum(); 
-  for (fx = 0; fx < f_num; ++fx) {
+  for (fx = fx_begin; fx < f_num; ++fx) {
     if (tree_feat->featInfo(fx)->isRemoved) continue; 
+    update_feature(fx, nlam, nsig, py_avg, for_del); 
+  }
+}
 
-    double w = v_w.get(fx); 
-    int dxs_num; 
-    const int *dxs = data_points(fx, &dxs_num); 
-    double my_nlam = reg_depth->apply(nlam, node(fx)->depth); 
-    double my_nsig = reg_depth->apply(nsig, node(fx)->depth); 
-    double delta = getDelta(dxs, dxs_num, w, my_nlam, my_nsig, py_avg, for_del); 
-    v_w.set(fx, w+delta); 
-    updatePred(dxs, dxs_num, delta, &v_p); 
+/*--------------------------------------------------------*/
+void AzOptOnTree::update_feature(int fx, 
+                      double nlam, 
+                      double nsig, 
+                      double py_avg, 
+                      AzRgf_forDelta *for_del) /* updated */
+{
+  double w = v_w.get(fx); 
+  int dxs_num; 
+  const int *dxs = data_points(fx, &dxs_num); 
+  double my_nlam = reg_depth->apply(nlam, node(fx)->depth); 
+  double my_nsig = reg_depth->apply(nsig, node(fx)->depth); 
+  double delta = getDelta(dxs, dxs_num, w, my_nlam, my_nsig, py_avg, for_del); 
+  v_w.set(fx, w+delta); 
+  updatePred(dxs, dxs_num, delta, &v_p); 
+}
+
+/*--------------------------------------------------------*/
+/* 
+ * Tree by tree.  Leaves of a tree share no data points, so updating one 
+ * leaf doesn't affect the others in the same tree, and they can be 
+ * updated concurrently.  The result is the same as updating them one 
+ * by one in the order of node#, regardless of the number of threads.  
+ */
+void AzOptOnTree::_update_with_features_Parallel(
+                      double nlam, 
+                      double nsig, 
+                      double py_avg, 
+                      AzRgf_forDelta *for_del) /* updated */
+{
+  int tree_num = ens->size(); 
+  int tx; 
+  for (tx = 0; tx < tree_num; ++tx) {
+    ens->tree_u(tx)->restoreDataIndexes(); 
+    AzIIarr iia_nx_fx; 
+    tree_feat->featIds(tx, &iia_nx_fx); 
+    int num = iia_nx_fx.size(); 
+    AzIntArr ia_leaf_fx; 
+    int leaf_dxs_num = 0; 
+    int ix; 
+    for (ix = 0; ix < num; ++ix) {
+      int nx, fx; 
+      iia_nx_fx.get(ix, &nx, &fx); 
+      if (tree_feat->featInfo(fx)->isRemoved) continue; /* shouldn't happen though */
+      if (fx < fx_begin) continue; 
+      if (!node(fx)->isLeaf()) { /* internal nodes overlap with others */
+        update_feature(fx, nlam, nsig, py_avg, for_del); 
+        continue; 
+      }
+      ia_leaf_fx.put(fx); 
+      leaf_dxs_num += node(fx)->dxs_num; 
+    }
+
+    const int *leaf_fx = ia_leaf_fx.point(); 
+    int leaf_num = ia_leaf_fx.size(); 
+    AzDataArr<AzRgf_forDelta> arr_del(leaf_num); 
+    int th_num = AzThreads::threadNum(thread_num, MIN(leaf_num, leaf_dxs_num/min_dxs_per_thread)); 
+    AzThreadErr th_err; 
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(th_num) schedule(dynamic,1) if(th_num > 1)
+#endif
+    for (ix = 0; ix < leaf_num; ++ix) {
+      try {
+        update_feature(leaf_fx[ix], nlam, nsig, py_avg, arr_del.point_u(ix)); 
+      }
+      catch (AzException *e) {
+        th_err.keep(e); 
+      }
+    }
+    th_err.throw_if(); 
+    for (ix = 0; ix < leaf_num; ++ix) {
+      for_del->add(arr_del.point(ix)); 
+    }
+
+    ens->tree_u(tx)->releaseDataIndexes(); 
   }
 }
 
@@ -332,6 +426,7 @@ void AzOptOnTree::_update_with_features_TempFile(
       int nx, fx; 
       iia_nx_fx.get(ix, &nx, &fx); 
       if (tree_feat->featInfo(fx)->isRemoved) continue; /* shouldn't happen though */
+      if (fx < fx_begin) continue; 
 
       double w = v_w.get(fx); 
       int dxs_num; 
@@ -353,7 +448,10 @@ void AzOptOnTree::update_with_features(
                       double py_avg, 
                       AzRgf_forDelta *for_del) /* updated */
 {
-  if (ens->usingTempFile()) {
+  if (doParallel) {
+    _update_with_features_Parallel(nlam, nsig, py_avg, for_del); 
+  }
+  else if (ens->usingTempFile()) {
     _update_with_features_TempFile(nlam, nsig, py_avg, for_del); 
   }
   else {
@@ -447,6 +545,9 @@ void AzOptOnTree::checkParam() const
   if (eta <= 0) {
     throw new AzException(AzInputNotValid, eyec, kw_eta, "must be positive"); 
   }
+  if (thread_num < 0) {
+    throw new AzException(AzInputNotValid, eyec, kw_num_threads, "must be non-negative"); 
+  }
 }
 
 /*--------------------------------------------------------*/
@@ -575,10 +676,16 @@ void AzOptOnTree::refreshPred()
 
 /*--------------------------------------------------------*/
 void AzOptOnTree::resetPred(const AzBmat *b_tran, 
-                                AzDvect *out_v_p) /* output */
+                                AzDvect *out_v_p, /* output */
+                                const AzBmat *b_tran_new) /* may be NULL */
 const
 {
   int data_num = b_tran->rowNum(); 
+  int old_f_num = v_w.rowNum(); 
+  if (b_tran_new != NULL) {
+    data_num = b_tran_new->rowNum(); 
+    old_f_num = b_tran->colNum(); 
+  }
   out_v_p->reform(data_num); 
   out_v_p->set(var_const+fixed_const); 
   AzCursor cursor; 
@@ -586,7 +693,8 @@ const
     double val; 
     int fx = v_w.next(cursor, val); 
     if (fx < 0) break; 
-    const AzIntArr *ia_dx = b_tran->on_rows(fx); 
+    const AzIntArr *ia_dx = (fx < old_f_num) ? b_tran->on_rows(fx) 
+                                             : b_tran_new->on_rows(fx-old_f_num); 
     updatePred(ia_dx->point(), ia_dx->size(), val, out_v_p); 
   }  
 }
@@ -633,6 +741,7 @@ void AzOptOnTree::printHelp(AzHelp &h) const
   h.item_experimental(kw_doIntercept, help_doIntercept); 
   h.item(kw_eta, help_eta, eta_dflt); 
   h.item_experimental(kw_exit_delta, help_exit_delta, exit_delta_dflt); 
+  h.item(kw_doParallelOpt, help_doParallelOpt); 
   h.end(); 
 }
 
@@ -648,6 +757,8 @@ void AzOptOnTree::resetParam(AzParam &p)
   p.swOn(&doUseAvg, kw_doUseAvg); 
   p.swOff(&doIntercept, kw_not_doIntercept); /* useless but keep this for compatibility */
   p.swOn(&doIntercept, kw_doIntercept); 
+  p.swOn(&doParallel, kw_doParallelOpt); 
+  p.vInt(kw_num_threads, &thread_num); 
 
   if (max_ite_num <= 0) {
     max_ite_num = max_ite_num_dflt_oth; 
@@ -677,6 +788,10 @@ void AzOptOnTree::printParam(const AzOut &out,
 
   o.printSw(kw_doUseAvg, doUseAvg); 
   o.printSw(kw_doIntercept, doIntercept); 
+  o.printSw(kw_doParallelOpt, doParallel); 
+  if (doParallel) {
+    o.printV(kw_num_threads, AzThreads::resolve(thread_num)); 
+  }
 
   o.printSw(kw_opt_beVerbose, beVerbose); 
 
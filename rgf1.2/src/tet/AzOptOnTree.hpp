@@ -30,6 +30,7 @@
 #include "AzOptimizerT.hpp"
 #include "AzRegDepth.hpp"
 #include "AzParam.hpp"
+#include "AzThreads.hpp"
 
 class AzRgf_forDelta {
 public:
@@ -39,6 +40,12 @@ public:
 
   void check_delta(double *delta, //<! inout 
                    double max_delta); 
+  void add(const AzRgf_forDelta *inp) {
+    changed += inp->changed; 
+    truncated += inp->truncated; 
+    sum_delta += inp->sum_delta; 
+    my_max = MAX(my_max, inp->my_max); 
+  }
   double avg_delta() const; 
 }; 
 
@@ -62,6 +69,9 @@ protected:
   AzLossType loss_type; 
   int max_ite_num; 
   bool doRefreshP, doIntercept, doUnregIntercept, doUseAvg; 
+  bool doParallel; 
+  int thread_num; 
+  int fx_begin; /* the weights of the features before this are fixed */
   AzOut out, my_dmp_out; 
 
   /*---  just pointing  ---*/
@@ -74,6 +84,7 @@ protected:
   /*---  default values  ---*/
   static const int max_ite_num_dflt_oth = 10; 
   static const int max_ite_num_dflt_expo = 5; 
+  static const int min_dxs_per_thread = 4096; /* for ParallelOpt */
   static const AzLossType loss_type_dflt = AzLoss_Square; 
   #define eta_dflt 0.5
   #define exit_delta_dflt -1
@@ -87,6 +98,7 @@ public:
     loss_type(loss_type_dflt), max_ite_num(-1),
     doIntercept(false), /* changed on 12/09/2011 */
     doRefreshP(false), doUnregIntercept(false), doUseAvg(false),  
+    doParallel(false), thread_num(1), fx_begin(0), 
     ens(NULL), tree_feat(NULL)
     {}
 
@@ -141,16 +153,28 @@ public:
     out_v_p->set(&v_p); 
   }
 
+  /*---  for checkpoints  ---*/
+  virtual void write_checkpoint(AzFile *file); 
+  virtual void read_checkpoint(AzFile *file); 
+
   /*---  ---*/
   void copy_from(const AzOptOnTree *inp); 
   void reset(const AzOptOnTree *inp) {
     copy_from(inp); 
   }
 
+  /*---  if m_tran_new is given, it has the columns for the features  ---*/
+  /*---  after the last column of m_tran                             ---*/
   void resetPred(const AzBmat *m_tran, 
-                 AzDvect *v_p) /* output */
+                 AzDvect *v_p, /* output */
+                 const AzBmat *m_tran_new=NULL) 
                  const; 
 
+  /*---  optimize only the weights of feature#fx_begin and after  ---*/
+  void resetFirstFeat(int inp_fx_begin) {
+    fx_begin = inp_fx_begin; 
+  }
+
   /*---*/
   void resetDw(const AzDvect *inp_v_dw) {
     if (!AzDvect::isNull(inp_v_dw)) {
@@ -185,6 +209,11 @@ protected:
                             AzRgf_forDelta *for_delta);
   virtual void _update_with_features_TempFile(double nlam, double nsig, double py_avg, 
                             AzRgf_forDelta *for_delta);
+  virtual void _update_with_features_Parallel(double nlam, double nsig, double py_avg, 
+                            AzRgf_forDelta *for_delta); 
+  void update_feature(int fx, 
+                      double nlam, double nsig, double py_avg, 
+                      AzRgf_forDelta *for_delta); 
   void update_intercept(double nlam, double nsig, double py_avg, 
                         AzRgf_forDelta *for_delta); /* updated */
 
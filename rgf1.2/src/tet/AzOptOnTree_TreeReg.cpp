@@ -73,6 +73,7 @@ void AzOptOnTree_TreeReg::update_with_features(
     for (ix = 0; ix < num; ++ix) {
       int nx, fx; 
       iia_nx_fx.get(ix, &nx, &fx); 
+      if (fx < fx_begin) continue; 
 
       double delta = bestDelta(nx, fx, reg, nlam, nsig, py_avg, for_delta); 
       update_weight(nx, fx, delta, reg);
@@ -51,6 +51,15 @@ public:
   }
 
 protected: 
+  //! override 
+  virtual void checkParam() const {
+    AzOptOnTree::checkParam(); 
+    if (doParallel) { /* weights of one tree are coupled by the regularizer */
+      throw new AzException(AzInputNotValid, "AzOptOnTree_TreeReg", kw_doParallelOpt, 
+                            "cannot be used with tree-structured regularization"); 
+    }
+  }
+
   //! override 
   virtual void update_with_features(double nlam, double nsig, double py_avg, 
                             AzRgf_forDelta *for_delta); 
@@ -50,8 +50,10 @@ public:
   virtual void copyPred_to(AzDvect *out_v_p) const = 0; 
 
   virtual void resetPred(const AzBmat *m_tran, 
-                         AzDvect *v_p) /* output */
+                         AzDvect *v_p, /* output */
+                         const AzBmat *m_tran_new=NULL) 
                          const = 0; 
+  virtual void resetFirstFeat(int fx_begin) = 0; 
   virtual void optimize(AzRgfTreeEnsemble *ens, 
                        const AzTrTreeFeat *tree_feat, 
                        int inp_ite_num=-1, 
@@ -65,6 +67,13 @@ public:
                        double sig=-1) {
     throw new AzException("AzOptimizerT::optimize(...,doRefreshP,...)", "No support"); 
   }
+  /*---  for checkpoints; read_checkpoint follows reset  ---*/
+  virtual void write_checkpoint(AzFile *file) {
+    throw new AzException(AzInputNotValid, "AzOptimizerT::write_checkpoint", "No support"); 
+  }
+  virtual void read_checkpoint(AzFile *file) {
+    throw new AzException(AzInputNotValid, "AzOptimizerT::read_checkpoint", "No support"); 
+  }
   virtual const AzDvect *weights() const = 0; 
   virtual double constant() const = 0; 
   virtual void printHelp(AzHelp &h) const = 0; 
@@ -100,6 +100,19 @@ public:
     }
     return trainer; 
   }
+
+  virtual AzTETrainer *newTrainer(const char *alg_name) const
+  {
+    AzBytArr s_name(alg_name); 
+    AzTETrainer *trainer = NULL; 
+    if      (s_name.compare(kw_rgf) == 0)     trainer = new AzRgforest(); 
+    else if (s_name.compare(kw_rgf_sib) == 0) trainer = new AzRgforest_TreeReg<AzReg_TsrSib>(); 
+    else if (s_name.compare(kw_rgf_opt) == 0) trainer = new AzRgforest_TreeReg<AzReg_TsrOpt>(); 
+    else {
+      throw new AzException(AzInputNotValid, "algorithm name", alg_name); 
+    }
+    return trainer; 
+  }
 }; 
 
 #endif 
@@ -47,10 +47,11 @@ void AzRgfTree::findSplit(AzRgf_FindSplit *fs,
     if (!nodes[nx].isLeaf()) continue; 
 
     /*---  ---*/
-    if (max_depth > 0 && nodes[nx].depth >= max_depth) {
-      continue; 
-    }
-    if (min_size > 0 && nodes[nx].dxs_num < min_size*2) {
+    if (max_depth > 0 && nodes[nx].depth >= max_depth || 
+        min_size > 0 && nodes[nx].dxs_num < min_size*2) {
+      if (hist != NULL) {
+        delete hist[nx]; hist[nx] = NULL; /* never needed */
+      }
       continue; 
     }
 
@@ -73,6 +74,7 @@ void AzRgfTree::removeSplitAssessment()
       delete split[nx]; split[nx] = NULL; 
     }
   }
+  AzTrTree::_releaseHist(); /* since targets changed */
 }
 
 /*--------------------------------------------------------*/
@@ -112,33 +114,15 @@ void AzRgfTree::storeDataIndexes()
     return; 
   }
 
-  AzIntArr ia_dxs_num; 
-  int nx; 
-  for (nx = 0; nx < nodes_used; ++nx) {
-    ia_dxs_num.put(nodes[nx].dxs_num); 
-  }
-
-#if 0 
-  wk.file->open("ab"); 
-#endif 
-
-  int fsize = wk.file->size_under2G("AzRgfTree::storeDataIndexes tempfile"); 
-  wk.set(fsize, nodes_used); 
-  wk.file->seek(fsize); 
-  ia_root_dx.write(wk.file); 
-  ia_dxs_num.write(wk.file); 
-
-#if 0 
-  wk.file->close(true); 
-#endif 
-
+  AZint8 offset = wk.store->put(ia_root_dx.point(), ia_root_dx.size()); 
+  wk.set(offset, nodes_used, ia_root_dx.size()); 
   releaseDataIndexes(); 
 }
 
 /*--------------------------------------------------------*/
-int AzRgfTree::estimateSizeofDataIndexes(int data_num) const
+AZint8 AzRgfTree::estimateSizeofDataIndexes(int data_num) const
 {
-  return (data_num+1) * sizeof(int) * 2; 
+  return (AZint8)data_num * sizeof(int); 
 }
 
 /*--------------------------------------------------------*/
@@ -151,41 +135,53 @@ void AzRgfTree::releaseDataIndexes()
   for (nx = 0; nx < nodes_used; ++nx) {
     nodes[nx].reset_data_indexes(NULL); 
   }
+  wk.isRestored = false; 
 }
 
+/*--------------------------------------------------------*/
+/* The nodes point into the mapped file without copying */
+/* unless mmap is unavailable (_WIN32).                 */
 /*--------------------------------------------------------*/
 void AzRgfTree::restoreDataIndexes()
 {
   if (!wk.isStored()) return; 
 
   const char *eyec = "AzRgfTree::restoreDataIndexes"; 
-  if (ia_root_dx.size() > 0) {
+  if (wk.isRestored) {
     throw new AzException(eyec, "no need to restore?!"); 
   }
-  AzIntArr ia_dxs_num; 
-#if 0 
-  wk.file->open("rb"); 
-#endif 
-  wk.file->seek(wk.offset); 
-  ia_root_dx.read(wk.file); 
-  ia_dxs_num.read(wk.file); 
-#if 0 
-  wk.file->close(); 
-#endif 
-  if (ia_dxs_num.size() != nodes_used) {
+  if (wk.node_num != nodes_used) {
     throw new AzException(eyec, "conflict in #node"); 
   }
-  const int *dxs_num = ia_dxs_num.point(); 
+  const int *root_dxs = wk.store->get(wk.offset, wk.dxs_num, &ia_root_dx); 
   int nx; 
   for (nx = 0; nx < nodes_used; ++nx) {
-    if (nodes[nx].dxs_num != dxs_num[nx]) {
-      throw new AzException(eyec, "conflict in #data"); 
-    }
-    if (nodes[nx].dxs_offset+nodes[nx].dxs_num > ia_root_dx.size()) {
+    if (nodes[nx].dxs_offset+nodes[nx].dxs_num > wk.dxs_num) {
       throw new AzException(eyec, "conflict in offset"); 
     }
-    nodes[nx].reset_data_indexes(ia_root_dx.point() + nodes[nx].dxs_offset); 
+    nodes[nx].reset_data_indexes(root_dxs + nodes[nx].dxs_offset); 
+  }
+  wk.isRestored = true; 
+}
+
+/*--------------------------------------------------------*/
+void AzRgfTree::write_checkpoint(AzFile *file)
+{
+  bool doRestore = (wk.isStored() && !wk.isRestored); 
+  if (doRestore) restoreDataIndexes(); 
+  AzTrTree::write_checkpoint(file); 
+  if (doRestore) releaseDataIndexes(); 
+}
 
+/*--------------------------------------------------------*/
+/* Trees that are no longer searched go back to the disk. */
+/*--------------------------------------------------------*/
+void AzRgfTree::read_checkpoint(AzFile *file, 
+                                const AzDataForTrTree *data)
+{
+  AzTrTree::read_checkpoint(file, data); 
+  if (split == NULL) {
+    storeDataIndexes(); 
   }
 }
 
@@ -28,17 +28,20 @@
 
 class AzRgfTreeTemp {
 public:
-  AzFile *file;  
-  int offset; 
+  AzDataIndexStore *store;  
+  AZint8 offset; 
   int node_num; 
-  AzRgfTreeTemp() : offset(-1), node_num(0), file(NULL) {}
-  inline void reset(AzFile *inp_file) {
-    file = inp_file; 
+  int dxs_num; 
+  bool isRestored; 
+  AzRgfTreeTemp() : store(NULL), offset(-1), node_num(0), dxs_num(0), isRestored(false) {}
+  inline void reset(AzDataIndexStore *inp_store) {
+    store = inp_store; 
     offset = -1; 
-    node_num = 0; 
+    node_num = dxs_num = 0; 
+    isRestored = false; 
   }
   inline bool canStore() {
-    if (file == NULL) return false; 
+    if (store == NULL) return false; 
     return true; 
   }
   inline bool isStored() {
@@ -47,9 +50,10 @@ public:
     }
     return false; 
   }
-  void set(int inp_offset, int inp_node_num) {
+  void set(AZint8 inp_offset, int inp_node_num, int inp_dxs_num) {
     offset = inp_offset; 
     node_num = inp_node_num; 
+    dxs_num = inp_dxs_num; 
   }
 };
 
@@ -88,13 +92,18 @@ public:
   }
 
   /*---  to store data indexes to disk  ---*/
-  virtual void forStoringDataIndexes(AzFile *file) {
-    wk.reset(file); 
+  virtual void forStoringDataIndexes(AzDataIndexStore *store) {
+    wk.reset(store); 
   }
   virtual void storeDataIndexes(); 
   virtual void releaseDataIndexes(); 
   virtual void restoreDataIndexes(); 
-  virtual int estimateSizeofDataIndexes(int data_num) const; 
+  virtual AZint8 estimateSizeofDataIndexes(int data_num) const; 
+
+  /*---  for checkpoints  ---*/
+  virtual void write_checkpoint(AzFile *file); 
+  virtual void read_checkpoint(AzFile *file, 
+                               const AzDataForTrTree *data); 
 
   /*---  ---*/
   virtual void resetParam(AzParam &param); 
@@ -114,11 +123,13 @@ public:
     return root_nx; 
   }
 
+  /*---  doKeepHist: targets of the new leaves will be lowered by their weights  ---*/
   inline virtual void splitNode(const AzDataForTrTree *data, 
-                                const AzTrTsplit *split) {
+                                const AzTrTsplit *split, 
+                                bool doKeepHist=false) {
     AzTrTree::_splitNode(data, max_leaf_num, 
                          doUseInternalNodes, 
-                         split->nx, split, my_dmp_out); 
+                         split->nx, split, my_dmp_out, doKeepHist); 
   }
 
   virtual void removeSplitAssessment(); 
@@ -144,8 +155,9 @@ public:
   }
 
   //! copy only nodes.  no split.  
-  void copy_nodes_from(const AzTrTree_ReadOnly *inp) {
-    AzTrTree::copy_nodes_from(inp); 
+  void copy_nodes_from(const AzTrTree_ReadOnly *inp, 
+                       bool doShareDataIndexes=false) {
+    AzTrTree::copy_nodes_from(inp, doShareDataIndexes); 
     doUseInternalNodes = inp->usingInternalNodes(); 
   }
   virtual inline void releaseWork() {
@@ -96,8 +96,9 @@ public:
                       const char *config, const char *sign) const {
     ens.copy_to(out_ens, config, sign); 
   }
-  inline void copy_nodes_from(const AzTrTreeEnsemble_ReadOnly *inp) {
-    ens.copy_nodes_from(inp); 
+  inline void copy_nodes_from(const AzTrTreeEnsemble_ReadOnly *inp, 
+                              bool doShareDataIndexes=false) {
+    ens.copy_nodes_from(inp, doShareDataIndexes); 
   }
   inline void show(const AzSvFeatInfo *feat, 
                    const AzOut &out, const char *header="") const {
@@ -125,5 +126,12 @@ public:
     ens.warm_start(inp_ens, data, param, s_temp_prefix, out, max_t_num, search_t_num, 
                    v_p, inp_ia_tr_dx); 
   }
+  inline virtual void write_checkpoint(AzFile *file) {
+    ens.write_checkpoint(file); 
+  }
+  inline virtual void read_checkpoint(AzFile *file, 
+                                      const AzDataForTrTree *data) {
+    ens.read_checkpoint(file, data); 
+  }
 }; 
 #endif 
@@ -38,7 +38,8 @@ public:
   virtual int nextIndex() const = 0; 
   virtual bool isFull() const = 0; 
 
-  virtual void copy_nodes_from(const AzTrTreeEnsemble_ReadOnly *inp) = 0; 
+  virtual void copy_nodes_from(const AzTrTreeEnsemble_ReadOnly *inp, 
+                               bool doShareDataIndexes=false) = 0; 
   virtual void printHelp(AzHelp &h) const = 0; 
 
   virtual void cold_start(AzParam &param, 
@@ -56,5 +57,8 @@ public:
               int search_t_num, 
               AzDvect *v_p, /* inout */
               const AzIntArr *inp_ia_tr_dx=NULL) = 0; 
+  virtual void write_checkpoint(AzFile *file) = 0; 
+  virtual void read_checkpoint(AzFile *file, /* after cold_start */
+                               const AzDataForTrTree *data) = 0; 
 }; 
 #endif 
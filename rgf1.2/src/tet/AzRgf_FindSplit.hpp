@@ -72,7 +72,7 @@ public:
                           "no appropriate override"); 
   }
 
-  virtual void pickFeats(int f_num, int data_num) = 0; 
+  virtual void pickFeats(int pick_num, int f_num, int seed, int draw_no) = 0; 
 
   virtual void end() = 0; 
   virtual 
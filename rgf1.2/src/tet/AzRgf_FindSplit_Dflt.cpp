@@ -91,6 +91,12 @@ void AzRgf_FindSplit_Dflt::resetParam(AzParam &p)
     throw new AzException(AzInputNotValid, "AzRgf_FindSplit_Dflt", 
                kw_sigma, "must be non-negative"); 
   }
+
+  p.vInt(kw_num_threads, &thread_num); 
+  if (thread_num < 0) {
+    throw new AzException(AzInputNotValid, "AzRgf_FindSplit_Dflt", 
+               kw_num_threads, "must be non-negative"); 
+  }
 }
 
 /*--------------------------------------------------------*/
@@ -104,6 +110,9 @@ void AzRgf_FindSplit_Dflt::printParam(const AzOut &out) const
   o.ppBegin("AzRgf_FindSplit_Dflt", "Node split", ", "); 
   o.printV(kw_lambda, lambda); 
   o.printV_posiOnly(kw_sigma, sigma); 
+  if (thread_num != 1) {
+    o.printV(kw_num_threads, AzThreads::resolve(thread_num)); 
+  }
   o.ppEnd(); 
 }
 
@@ -115,5 +124,6 @@ void AzRgf_FindSplit_Dflt::printHelp(AzHelp &h) const
   h.item_experimental(kw_sigma, help_sigma, sigma_dflt); 
   h.item(kw_s_lambda, help_s_lambda);  
   h.item_experimental(kw_s_sigma, help_s_sigma); 
+  h.item(kw_num_threads, help_num_threads, 1); 
   h.end(); 
 }
@@ -75,8 +75,8 @@ public:
     printParam(out); 
   }
 
-  virtual void pickFeats(int pick_num, int f_num) {
-    AzFindSplit::_pickFeats(pick_num, f_num); 
+  virtual void pickFeats(int pick_num, int f_num, int seed, int draw_no) {
+    AzFindSplit::_pickFeats(pick_num, f_num, seed, draw_no); 
   }
 
   virtual void printParam(const AzOut &out) const; 
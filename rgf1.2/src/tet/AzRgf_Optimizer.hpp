@@ -82,8 +82,19 @@ public:
   virtual void temp_update_apply(const AzDataForTrTree *tr_data, 
                           AzRgfTreeEnsemble *temp_ens, 
                           const AzDataForTrTree *test_data, 
-                          AzBmat *temp_b, AzDvect *v_test_p, 
-                          int *f_num, int *nz_f_num) const = 0; 
+                          const AzBmat *b_test_tran, /*!< not changed */
+                          AzDvect *v_test_p, 
+                          int *f_num, int *nz_f_num, 
+                          /*! optimize only the weights added since the last update */
+                          bool doNewOnly=false) const = 0; 
+
+  /*! Write/read the state for resuming training; read_checkpoint follows cold_start */
+  virtual void write_checkpoint(AzFile *file) {
+    throw new AzException(AzInputNotValid, "AzRgf_Optimizer::write_checkpoint", "No support"); 
+  }
+  virtual void read_checkpoint(AzFile *file) {
+    throw new AzException(AzInputNotValid, "AzRgf_Optimizer::read_checkpoint", "No support"); 
+  }
 
   virtual void printHelp(AzHelp &h) const = 0; 
 }; 
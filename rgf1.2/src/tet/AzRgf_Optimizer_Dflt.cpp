@@ -89,6 +89,34 @@ AzRgf_Optimizer_Dflt::update(const AzDataForTrTree *data,
   }
 }
 
+/*------------------------------------------------------------------*/
+/* 
+ * The nodes of temp_ens point the data indexes of the ensemble in training. 
+ * b_test_tran is shared instead of copied; only the columns for the features 
+ * added after it was last updated are generated. 
+ */
+void AzRgf_Optimizer_Dflt::_temp_update_apply(AzRgf_Optimizer_Dflt *temp_opt, 
+                          const AzDataForTrTree *tr_data, 
+                          AzRgfTreeEnsemble *temp_ens, 
+                          const AzDataForTrTree *test_data, 
+                          const AzBmat *b_test_tran, 
+                          AzDvect *v_test_p, 
+                          int *f_num, int *nz_f_num, 
+                          bool doNewOnly) const 
+{
+  if (doNewOnly) {
+    /*---  warm-start from the current weights; fix the old ones  ---*/
+    temp_opt->trainer->resetFirstFeat(feat1.featNum()); 
+  }
+  temp_opt->update(tr_data, temp_ens); 
+  if (test_data == NULL) return; 
+
+  AzBmat b_new; 
+  temp_opt->feat1.newMatrix(test_data, temp_ens, b_test_tran, &b_new); 
+  temp_opt->trainer->resetPred(b_test_tran, v_test_p, &b_new); 
+  _info(temp_ens, temp_opt->trainer, &temp_opt->feat1, f_num, nz_f_num); 
+}
+
 /*------------------------------------------------------------------*/
 /*------------------------------------------------------------------*/
 /* static */
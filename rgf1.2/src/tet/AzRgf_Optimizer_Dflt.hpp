@@ -67,12 +67,12 @@ public:
   virtual void temp_update_apply(const AzDataForTrTree *tr_data, 
                           AzRgfTreeEnsemble *temp_ens, 
                           const AzDataForTrTree *test_data, 
-                          AzBmat *temp_b, AzDvect *v_test_p, 
-                          int *f_num, int *nz_f_num) const {   
+                          const AzBmat *b_test_tran, AzDvect *v_test_p, 
+                          int *f_num, int *nz_f_num, 
+                          bool doNewOnly=false) const {   
     AzRgf_Optimizer_Dflt temp_opt(this);   
-    temp_opt.update(tr_data, temp_ens); 
-    if (test_data != NULL) temp_opt.apply(test_data, temp_b, temp_ens, 
-                                          v_test_p, f_num, nz_f_num); 
+    _temp_update_apply(&temp_opt, tr_data, temp_ens, test_data, b_test_tran, 
+                       v_test_p, f_num, nz_f_num, doNewOnly); 
   }
   /*--------------------------------------------------------*/
 
@@ -108,10 +108,28 @@ public:
              AzDvect *v_p, 
              int *f_num, int *nz_f_num) const; 
 
+  virtual void write_checkpoint(AzFile *file) {
+    feat1.write_checkpoint(file); 
+    trainer->write_checkpoint(file); 
+  }
+  virtual void read_checkpoint(AzFile *file) {
+    feat1.read_checkpoint(file); 
+    trainer->read_checkpoint(file); 
+  }
+
   virtual void printHelp(AzHelp &h) const; 
 
 protected:
   virtual bool resetParam(AzParam &param); 
+
+  /*---  temp_opt: a copy of this  ---*/
+  void _temp_update_apply(AzRgf_Optimizer_Dflt *temp_opt, 
+                          const AzDataForTrTree *tr_data, 
+                          AzRgfTreeEnsemble *temp_ens, 
+                          const AzDataForTrTree *test_data, 
+                          const AzBmat *b_test_tran, AzDvect *v_test_p, 
+                          int *f_num, int *nz_f_num, 
+                          bool doNewOnly) const; 
   static void _info(const AzTrTreeEnsemble_ReadOnly *ens, 
                     const AzOptimizerT *my_trainer, 
                     const AzTrTreeFeat *my_feat, 
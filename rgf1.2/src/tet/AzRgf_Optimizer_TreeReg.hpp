@@ -58,12 +58,12 @@ public:
   virtual void temp_update_apply(const AzDataForTrTree *tr_data, 
                           AzRgfTreeEnsemble *temp_ens, 
                           const AzDataForTrTree *test_data, 
-                          AzBmat *temp_b, AzDvect *v_test_p, 
-                          int *f_num, int *nz_f_num) const {   
+                          const AzBmat *b_test_tran, AzDvect *v_test_p, 
+                          int *f_num, int *nz_f_num, 
+                          bool doNewOnly=false) const {   
     AzRgf_Optimizer_TreeReg temp_opt(this);   
-    temp_opt.update(tr_data, temp_ens); 
-    if (test_data != NULL) temp_opt.apply(test_data, temp_b, temp_ens, 
-                                          v_test_p, f_num, nz_f_num); 
+    _temp_update_apply(&temp_opt, tr_data, temp_ens, test_data, b_test_tran, 
+                       v_test_p, f_num, nz_f_num, doNewOnly); 
   }
   /*--------------------------------------------------------*/
 }; 
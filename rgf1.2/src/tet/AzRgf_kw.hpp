@@ -40,7 +40,9 @@
 #define kw_temp_for_trees "temp_disk="
 #define kw_f_ratio "f_ratio="
 #define kw_random_seed "random_seed="
+#define kw_sample_ratio "sample_ratio="
 #define kw_doPassiveRoot "PassiveRoot"
+#define kw_doQuickTest "QuickTest"
 
 #define help_loss           "Loss function"
 #define help_max_tree_num   "Stop training when the number of trees exceeds this number."
@@ -54,10 +56,12 @@
 #define help_doTime          "Measure elapsed time for node search and weight optimization."
 #define help_mem_policy "Conservative|Generous."
 
-#define help_temp_for_trees "To reduce memory consumption, path names to the temporary files are generated by attaching serial numbers to this."
+#define help_temp_for_trees "To reduce memory consumption, the data indexes of the trees are kept in a memory-mapped temporary file whose path name is generated by attaching \"--dxs--\" and a unique suffix to this.  The file is removed at the end."
 #define help_f_ratio "For feature sampling."
 #define help_random_seed "Random seed."
+#define help_sample_ratio "Row sampling for node search: each tree searches for splits using only this fraction of the training data, drawn at random when the tree is started.  The nodes are split and the weights are optimized using all the data.  Must be in (0,1]."
 #define help_doPassiveRoot "Consider to split the root (to start a new tree) only if there is no other choice."
+#define help_doQuickTest "When testing between weight optimizations, optimize only the weights of the leaves added since the last optimization, starting from the current weights.  Faster, but the test results and the models saved at those points are approximate.  The final model is not affected."
 
 /*--- AzRgforest_Sim ---*/
 #define kw_s "shrink="
@@ -92,6 +96,7 @@
 #define kw_opt_beVerbose "Verbose_opt"
 #define kw_not_doIntercept "DontUseIntercept"
 #define kw_doIntercept     "UseIntercept"
+#define kw_doParallelOpt   "ParallelOpt"
 
 #define help_lambda "lambda.  Regularization coefficient."        
 #define help_sigma  "L1 regularization coefficient." 
@@ -106,6 +111,7 @@
 #define help_opt_beVerbose "Print information on weight optimization."
 #define help_not_doIntercept "Do not include intercept in the weight optimization."
 #define help_doIntercept     "Include intercept in the weight optimization."
+#define help_doParallelOpt   "Update the weights tree by tree, updating the leaves of each tree concurrently with num_threads= threads.  The order of updates differs from the default, which may change the results slightly."
 
 /*--- AzRgf_FindSplit_Dflt ---*/
 /* #define kw_lambda "reg_L2="  shared with opt */
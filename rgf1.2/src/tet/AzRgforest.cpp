@@ -39,6 +39,7 @@ void AzRgforest::cold_start(const char *param,
   opt->cold_start(loss_type, data, reg_depth, /* initialize optimizer */
                   az_param, v_y, v_fixed_dw, out, &v_p); 
   initTarget(v_y, v_fixed_dw);    
+  sample_no = 0; 
   initEnsemble(az_param, max_tree_num); /* initialize tree ensemble */
   fs->reset(az_param, reg_depth, out); /* initialize node search */
   az_param.check(out); 
@@ -63,10 +64,14 @@ void AzRgforest::warm_start(const char *param,
 {
   const char *eyec = "AzRgforest::warm_start"; 
   out = out_req; 
+  int f_num = m_x->rowNum(); 
+  if      (data_cache != NULL)  f_num = data_cache->featNum(); 
+  else if (shared_data != NULL) f_num = shared_data->featNum(); 
+  else if (packed_x != NULL)    f_num = packed_x->rowNum(); 
   if (inp_ens->orgdim() > 0 && 
-      inp_ens->orgdim() != m_x->rowNum()) {
+      inp_ens->orgdim() != f_num) {
     AzBytArr s("Mismatch in feature dimensionality.  "); 
-    s.cn(inp_ens->orgdim());s.c(" (tree ensemeble), ");s.cn(m_x->rowNum());s.c(" (dataset)."); 
+    s.cn(inp_ens->orgdim());s.c(" (tree ensemeble), ");s.cn(f_num);s.c(" (dataset)."); 
     throw new AzException(AzInputError, eyec, s.c_str()); 
   }
   s_config.reset(param); 
@@ -103,6 +108,99 @@ void AzRgforest::warm_start(const char *param,
   AzTimeLog::print("End of warming-up ... ", log_out); 
 }
 
+/*-------------------------------------------------------------------*/
+/* Everything that changes during training, so that training resumes  */
+/* where the checkpoint was written without warming up the trees.     */
+/*-------------------------------------------------------------------*/
+void AzRgforest::write_checkpoint(AzFile *file)
+{
+  if (data == NULL) {
+    throw new AzException("AzRgforest::write_checkpoint", "training hasn't started"); 
+  }
+  AzBytArr s_sign(signature()); 
+  s_sign.write(file); 
+  file->writeInt((int)loss_type); 
+  file->writeInt(data->dataNum()); 
+  file->writeInt(data->featNum()); 
+  file->writeInt(l_num); 
+  file->writeBool(isOpt); 
+  file->writeDouble(py_adjust); 
+  file->writeDouble(lam_scale); 
+  file->writeInt(test_timer.chk); 
+  file->writeInt(opt_timer.chk); 
+  file->writeInt(sample_no); 
+  v_p.write(file); 
+  target.write_checkpoint(file); 
+  opt->write_checkpoint(file); 
+  ens->write_checkpoint(file); 
+}
+
+/*-------------------------------------------------------------------*/
+void AzRgforest::read_checkpoint(const char *param, 
+                        const AzSmat *m_x, 
+                        const AzDvect *v_y, 
+                        const AzSvFeatInfo *featInfo, 
+                        const AzDvect *v_fixed_dw, 
+                        AzFile *file, 
+                        const AzOut &out_req)
+{
+  const char *eyec = "AzRgforest::read_checkpoint"; 
+  out = out_req; 
+  AzBytArr s_sign; 
+  s_sign.read(file); 
+  if (strcmp(s_sign.c_str(), signature()) != 0) {
+    throw new AzException(AzInputError, eyec, 
+              "The checkpoint was written by another algorithm: ", s_sign.c_str()); 
+  }
+  s_config.reset(param); 
+
+  AzParam az_param(param); 
+  int max_tree_num = resetParam(az_param); 
+  if ((AzLossType)file->readInt() != loss_type) {
+    throw new AzException(AzInputError, eyec, 
+              "The loss function differs from the one in the checkpoint"); 
+  }
+  int data_num = file->readInt(); 
+  int feat_num = file->readInt(); 
+  setInput(az_param, m_x, featInfo); 
+  if (data->dataNum() != data_num || data->featNum() != feat_num) {
+    throw new AzException(AzInputError, eyec, 
+              "The training data differs from the one in the checkpoint"); 
+  }
+  reg_depth->reset(az_param, out);  /* init regularizer on node depth */
+
+  l_num = file->readInt(); 
+  isOpt = file->readBool(); 
+  py_adjust = file->readDouble(); 
+  lam_scale = file->readDouble(); 
+  test_timer.chk = file->readInt(); 
+  opt_timer.chk = file->readInt(); 
+  sample_no = file->readInt(); 
+  v_p.read(file); 
+
+  target.reset(v_y, v_fixed_dw); 
+  target.read_checkpoint(file); 
+
+  AzDvect v_init_p; /* overwritten by the checkpoint */
+  opt->cold_start(loss_type, data, reg_depth, 
+                  az_param, v_y, v_fixed_dw, out, &v_init_p); 
+  opt->read_checkpoint(file); 
+
+  initEnsemble(az_param, max_tree_num); 
+  ens->read_checkpoint(file, data); 
+
+  fs->reset(az_param, reg_depth, out); /* initialize node search */
+  az_param.check(out); 
+
+  if (!beVerbose) { 
+    out.deactivate(); /* shut up after printing everyone's config */
+  }
+
+  time_init(); /* initialize time measure ment */
+  end_of_initialization(); 
+  AzTimeLog::print("Resumed from the checkpoint: #leaf=", l_num, log_out); 
+}
+
 /*------------------------------------------------------------------*/
 /* Update test_timer, opt_timer */
 void AzRgforest::warmup_timer(const AzTreeEnsemble *inp_ens, 
@@ -139,6 +237,8 @@ void AzRgforest::warmupEnsemble(AzParam &az_param, int max_tree_num,
   /*---  always have one unsplit root: represent the next tree  ---*/
   rootonly_tree->reset(az_param); 
   rootonly_tree->makeRoot(data); 
+  sample_no = inp_ens->size(); /* not to repeat the draws of the run that made inp_ens */
+  rootonly_tree->sample(sample_ratio, data->dataNum(), sample_seed, sample_no); 
 
   rootonly_tx = max_tree_num + 1;  /* any number that doesn't overlap other trees */
 }
@@ -157,8 +257,23 @@ void AzRgforest::setInput(AzParam &p,
                           const AzSmat *m_x, 
                           const AzSvFeatInfo *featInfo)
 {
-  dflt_data.reset_data(out, m_x, p, beTight, featInfo); 
-  data = &dflt_data; 
+  if (shared_data != NULL) {
+    /*---  sorted by the caller with its own parameters  ---*/
+    AzDataForTrTree::ignoreParam(p); 
+    data = shared_data; 
+  }
+  else {
+    if (data_cache != NULL) {
+      data_cache->read_data(out, p, beTight, &dflt_data); 
+    }
+    else if (packed_x != NULL) {
+      dflt_data.reset_data(out, packed_x, packed_dxs, p, beTight, featInfo); 
+    }
+    else {
+      dflt_data.reset_data(out, m_x, p, beTight, featInfo); 
+    }
+    data = &dflt_data; 
+  }
 
   f_pick = -1; 
   if (f_ratio > 0) {
@@ -184,6 +299,7 @@ void AzRgforest::initEnsemble(AzParam &az_param, int max_tree_num)
   /*---  always have one unsplit root: represent the next tree  ---*/
   rootonly_tree->reset(az_param); 
   rootonly_tree->makeRoot(data); 
+  rootonly_tree->sample(sample_ratio, data->dataNum(), sample_seed, sample_no); 
 
   rootonly_tx = max_tree_num + 1;  /* any number that doesn't overlap other trees */
 }
@@ -202,6 +318,12 @@ AzRgfTree *AzRgforest::tree_to_grow(int &best_tx,  /* inout */
     tree->reset(out); 
     best_nx = tree->makeRoot(data); 
     *isNewTree = true; 
+    if (sample_ratio < 1) {
+      /*---  the new tree keeps the rows it was searched with  ---*/
+      tree->copy_sample_from(rootonly_tree); 
+      ++sample_no; 
+      rootonly_tree->sample(sample_ratio, data->dataNum(), sample_seed, sample_no); 
+    }
     return tree; 
   }
 }
@@ -294,7 +416,9 @@ const AzRgfTree *AzRgforest::splitNode(AzTrTsplit *best_split, /* (tx,nx) may be
   bool isNewTree = false; 
   AzRgfTree *tree = tree_to_grow(best_split->tx, best_split->nx, &isNewTree); 
   double old_w = tree->node(best_split->nx)->weight; 
-  tree->splitNode(data, best_split); 
+  /*---  with square loss, targets are shifted uniformly within each new leaf,  ---*/
+  /*---  so that their histograms can be derived from the parent's            ---*/
+  tree->splitNode(data, best_split, (loss_type == AzLoss_Square)); 
   double new_w = tree->node(best_split->nx)->weight; 
   isOpt = false; 
 
@@ -364,8 +488,9 @@ void AzRgforest::searchBestSplit(AzTrTsplit *best_split) /* must be initialize b
   }
 
   if (f_pick > 0) {
-    fs->pickFeats(f_pick, data->featNum()); 
+    fs->pickFeats(f_pick, data->featNum(), sample_seed, l_num); /* l_num: a new draw for each search */
   }
+  nn *= sample_ratio; /* the sums in node search are over the sampled rows */
 
   AzRgf_FindSplit_input input(-1, data, tar, lam_scale, nn); 
   int tx; 
@@ -460,14 +585,11 @@ void AzRgforest::_updateTarget_OtherLoss(const AzRgfTree *tree,
     double new_w = np->weight; 
     int ix; 
     for (ix = 0; ix < num; ++ix) {
-      int dx = dxs[ix]; 
-
-      p[dx] += (new_w + w_inc); 
-
-      AzLosses o = AzLoss::getLosses(loss_type, p[dx], y[dx], py_adjust); 
-      dw[dx] = o.loss2; 
-      tar_dw[dx] = o._loss1;  
+      p[dxs[ix]] += (new_w + w_inc); 
     }
+    AzLoss::deriv12(loss_type, dxs, num, p, y, py_adjust, 
+                    tar_dw, /* -L' */
+                    dw);    /* L'' */
   }
 }
 
@@ -557,10 +679,10 @@ AzRgforest::apply(AzTETrainer_TestData *td,
   int f_num = -1, nz_f_num = -1; 
   AzBmat *b_test_tran = AzTETrainer::_b(td); 
   if (!isOpt) { /* weights have not been corrected */
-    AzTimeLog::print("Testing (branch-off for end-of-training optimization)", out); 
-    AzBmat temp_b(b_test_tran); 
-    temp_apply_copy_to(out_ens, test_data, &temp_b, v_test_p,  
-                       &f_num, &nz_f_num); 
+    if (doQuickTest) AzTimeLog::print("Testing (branch-off optimizing the new leaves only)", out); 
+    else             AzTimeLog::print("Testing (branch-off for end-of-training optimization)", out); 
+    temp_apply_copy_to(out_ens, test_data, b_test_tran, v_test_p,  
+                       &f_num, &nz_f_num, doQuickTest); 
   }
   else {
     AzTimeLog::print("Testing ... ", out); 
@@ -694,15 +816,18 @@ int AzRgforest::resetParam(AzParam &p)
   if (f_ratio > 1) {
     throw new AzException(AzInputNotValid, kw_f_ratio, "must be between 0 and 1."); 
   }
+  p.vFloat(kw_sample_ratio, &sample_ratio); 
+  if (sample_ratio <= 0 || sample_ratio > 1) {
+    throw new AzException(AzInputNotValid, kw_sample_ratio, "must be in (0,1]."); 
+  }
   int random_seed = -1; 
-  if (f_ratio > 0 && f_ratio < 1) {
+  if (f_ratio > 0 && f_ratio < 1 || sample_ratio < 1) {
     p.vInt(kw_random_seed, &random_seed); 
-    if (random_seed > 0) {
-      srand(random_seed); 
-    }
   }
+  sample_seed = MAX(random_seed, 0); 
 
   p.swOn(&doPassiveRoot, kw_doPassiveRoot); 
+  p.swOn(&doQuickTest, kw_doQuickTest); 
 
   /*---  for maintenance purposes  ---*/
   p.swOn(&doForceToRefreshAll, kw_doForceToRefreshAll); 
@@ -727,8 +852,10 @@ int AzRgforest::resetParam(AzParam &p)
     o.printV_if_not_empty(kw_mem_policy, s_mem_policy); 
     o.printV_if_not_empty(kw_temp_for_trees, &s_temp_for_trees); 
     o.printV(kw_f_ratio, f_ratio); 
+    o.printV(kw_sample_ratio, sample_ratio); 
     o.printV(kw_random_seed, random_seed); 
     o.printSw(kw_doPassiveRoot, doPassiveRoot); 
+    o.printSw(kw_doQuickTest, doQuickTest); 
     o.ppEnd(); 
   }
 
@@ -760,7 +887,9 @@ void AzRgforest::printHelp(AzHelp &h) const
 
   h.item_experimental(kw_temp_for_trees, help_temp_for_trees); 
   h.item_experimental(kw_f_ratio, help_f_ratio); 
+  h.item(kw_sample_ratio, help_sample_ratio, 1); 
   h.item_experimental(kw_doPassiveRoot, help_doPassiveRoot); 
+  h.item(kw_doQuickTest, help_doQuickTest); 
   h.end(); 
 
   reg_depth->printHelp(h);  
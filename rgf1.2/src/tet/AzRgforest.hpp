@@ -52,6 +52,11 @@ protected:
 
   AzDataForTrTree dflt_data; 
   const AzDataForTrTree *data; /* This should be set in setInput */
+  AzDataCache *data_cache; /* used only in the next startup if not NULL */
+  const AzDataForTrTree *shared_data; /* used only in the next startup if not NULL */
+  const AzSmatc *packed_x; /* used only in the next startup if not NULL */
+  const AzIntArr *packed_dxs; /* the data points of packed_x to use; all if NULL */
+  AzSmatc *packed_x_to_release; /* packed_x if it is to be destroyed in startup */
   
   AzTrTtarget target; 
 
@@ -71,10 +76,14 @@ protected:
   AzBytArr s_temp_for_trees; 
   double f_ratio; 
   int f_pick; 
+  double sample_ratio; 
+  int sample_seed; /* random_seed= for drawing the rows (sample_ratio) and the features (f_ratio) */
   bool doPassiveRoot; 
+  bool doQuickTest; 
 
   /*---  work area  ---*/
   int l_num; 
+  int sample_no; /* #draw of the rows for node search */
   double py_adjust, lam_scale; /* for numerical stability for exp loss */
   AzDvect v_p; /* prediction */
   AzTimer test_timer, opt_timer, lmax_timer; 
@@ -91,15 +100,16 @@ protected:
 
 public:
   AzRgforest() : 
-    rootonly_tx(-1), data(NULL),   
+    rootonly_tx(-1), data(NULL), data_cache(NULL), shared_data(NULL), 
+    packed_x(NULL), packed_dxs(NULL), packed_x_to_release(NULL), 
     s_tree_num(s_tree_num_dflt), 
     loss_type(loss_type_dflt), 
     doForceToRefreshAll(false), beVerbose(false),  
     l_num(0), isOpt(false), out(log_out), py_adjust(0), lam_scale(1), 
     opt_time(0), search_time(0), doTime(false), 
     beTight(false), s_mem_policy(mp_not_beTight), 
-    f_ratio(-1), f_pick(-1), 
-    doPassiveRoot(false) 
+    f_ratio(-1), f_pick(-1), sample_ratio(1), sample_seed(0), sample_no(0), 
+    doPassiveRoot(false), doQuickTest(false) 
   {
     opt = &dflt_opt; 
     ens = &dflt_ens; 
@@ -123,15 +133,42 @@ public:
               AzDvect *v_fixed_dw=NULL, 
               AzTreeEnsemble *inp_ens=NULL) /* may be NULL */
   {
-    check_data_consistency(m_x, v_y, v_fixed_dw, featInfo, "AzRgforest::startup"); 
-
+    check_input(m_x, v_y, v_fixed_dw, featInfo, "AzRgforest::startup"); 
     if (inp_ens == NULL) cold_start(param, m_x, v_y, featInfo, v_fixed_dw, out); 
     else                 warm_start(param, m_x, v_y, featInfo, v_fixed_dw, inp_ens, out); 
-    m_x->destroy(); 
-    v_y->destroy(); 
-    if (v_fixed_dw != NULL) v_fixed_dw->destroy(); 
+    release_input(m_x, v_y, v_fixed_dw); 
     if (inp_ens != NULL) inp_ens->destroy(); 
   }
+  virtual 
+  void resume(const AzOut &out, 
+              const char *param, 
+              AzSmat *m_x, 
+              AzDvect *v_y, 
+              const AzSvFeatInfo *featInfo, 
+              AzDvect *v_fixed_dw, 
+              AzFile *file) 
+  {
+    check_input(m_x, v_y, v_fixed_dw, featInfo, "AzRgforest::resume"); 
+    read_checkpoint(param, m_x, v_y, featInfo, v_fixed_dw, file, out); 
+    release_input(m_x, v_y, v_fixed_dw); 
+  }
+  virtual bool canCheckpoint() const { return true; }
+  virtual void write_checkpoint(AzFile *file); 
+  virtual void reset_data_cache(AzDataCache *cache) {
+    data_cache = cache; 
+  }
+  virtual void reset_shared_data(const AzDataForTrTree *shared) {
+    shared_data = shared; 
+  }
+  virtual void reset_packed_data(AzSmatc *m_x) {
+    packed_x = packed_x_to_release = m_x; 
+    packed_dxs = NULL; 
+  }
+  virtual void reset_packed_data(const AzSmatc *m_x, const AzIntArr *ia_dxs) {
+    packed_x = m_x; 
+    packed_x_to_release = NULL; 
+    packed_dxs = ia_dxs; 
+  }
   virtual AzTETrainer_Ret proceed_until(); 
 
   virtual void  
@@ -159,12 +196,14 @@ protected:
   /*----------------------------------------------------------------*/
   virtual void temp_apply_copy_to(AzTreeEnsemble *out_ens, 
                           const AzDataForTrTree *test_data, 
-                          AzBmat *temp_b, AzDvect *v_test_p, 
-                          int *f_num, int *nz_f_num) const {
+                          const AzBmat *b_test_tran, AzDvect *v_test_p, 
+                          int *f_num, int *nz_f_num, 
+                          bool doNewOnly=false) const {
     AzRgfTreeEnsImp<AzRgfTree> temp_ens; 
-    temp_ens.copy_nodes_from(ens);
-    opt->temp_update_apply(data, &temp_ens, test_data, temp_b, 
-                           v_test_p, f_num, nz_f_num); 
+    bool doShareDataIndexes = true; /* ens doesn't change while temp_ens is alive */
+    temp_ens.copy_nodes_from(ens, doShareDataIndexes); 
+    opt->temp_update_apply(data, &temp_ens, test_data, b_test_tran, 
+                           v_test_p, f_num, nz_f_num, doNewOnly); 
     if (out_ens != NULL) temp_ens.copy_to(out_ens, s_config.c_str(), signature()); 
   }
   /*----------------------------------------------------------------*/
@@ -264,6 +303,49 @@ protected:
               const AzTreeEnsemble *inp_ens, 
               const AzOut &out); 
 
+  virtual void read_checkpoint(const char *param, 
+              const AzSmat *m_x, 
+              const AzDvect *v_y, 
+              const AzSvFeatInfo *featInfo, 
+              const AzDvect *v_fixed_dw, 
+              AzFile *file, 
+              const AzOut &out); 
+
+  void check_input(const AzSmat *m_x, 
+                   const AzDvect *v_y, 
+                   const AzDvect *v_fixed_dw, 
+                   const AzSvFeatInfo *featInfo, 
+                   const char *eyec) const {
+    if (data_cache != NULL) {
+      check_data_consistency(data_cache->dataNum(), data_cache->featNum(), 
+                             v_y, v_fixed_dw, featInfo, eyec); 
+    }
+    else if (shared_data != NULL) {
+      check_data_consistency(shared_data->dataNum(), shared_data->featNum(), 
+                             v_y, v_fixed_dw, featInfo, eyec); 
+    }
+    else if (packed_x != NULL) {
+      int d_num = (packed_dxs != NULL) ? packed_dxs->size() : packed_x->colNum(); 
+      check_data_consistency(d_num, packed_x->rowNum(), 
+                             v_y, v_fixed_dw, featInfo, eyec); 
+    }
+    else {
+      check_data_consistency(m_x, v_y, v_fixed_dw, featInfo, eyec); 
+    }
+  }
+  void release_input(AzSmat *m_x, 
+                     AzDvect *v_y, 
+                     AzDvect *v_fixed_dw) {
+    m_x->destroy(); 
+    v_y->destroy(); 
+    if (v_fixed_dw != NULL) v_fixed_dw->destroy(); 
+    if (packed_x_to_release != NULL) packed_x_to_release->reset(); 
+    data_cache = NULL; 
+    shared_data = NULL; 
+    packed_x = packed_x_to_release = NULL; 
+    packed_dxs = NULL; 
+  }
+
   virtual void warmup_timer(const AzTreeEnsemble *inp_ens, 
                             int max_tree_num); 
 
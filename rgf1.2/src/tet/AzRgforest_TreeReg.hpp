@@ -54,6 +54,19 @@ public:
     return s_desc.c_str(); 
   }
 
+  /*---  the regularizers keep their own state per tree  ---*/
+  virtual bool canCheckpoint() const { return false; }
+  virtual void write_checkpoint(AzFile *file) {
+    throw new AzException(AzInputNotValid, "AzRgforest_TreeReg::write_checkpoint", 
+              "Checkpoints are not supported with min-penalty regularization"); 
+  }
+  virtual void resume(const AzOut &out, const char *param, 
+              AzSmat *m_x, AzDvect *v_y, const AzSvFeatInfo *featInfo, 
+              AzDvect *v_fixed_dw, AzFile *file) {
+    throw new AzException(AzInputNotValid, "AzRgforest_TreeReg::resume", 
+              "Checkpoints are not supported with min-penalty regularization"); 
+  }
+
   virtual void printHelp(AzHelp &h) const {
     AzRgforest::printHelp(h); 
     reg_arr.tmpl()->printHelp(h); 
@@ -23,11 +23,11 @@
 
 /*------------------------------------------------------*/
 /*------------------------------------------------------*/
-void AzSortedFeat_Dense::reset(const AzDvect *v_data_transpose, 
+void AzSortedFeat_Dense::reset(const AzValArr *v_data_transpose, 
                                    const AzIntArr *ia_dx) 
 {
   v_dx2v = v_data_transpose; 
-  const double *dx2value = v_dx2v->point(); 
+  const AZ_MTX_FLOAT *dx2value = v_dx2v->point(); 
 
   const int *dxs = ia_dx->point(); 
   AzIFarr ifa_dx_val; 
@@ -52,6 +52,30 @@ void AzSortedFeat_Dense::reset(const AzDvect *v_data_transpose,
   isOriginal = true; /* This is the original one.  Don't change. */
 }
 
+/*------------------------------------------------------*/
+void AzSortedFeat_Dense::write(AzFile *file)
+{
+  if (!isOriginal) {
+    throw new AzException("AzSortedFeat_Dense::write", "not the original"); 
+  }
+  ia_index.write(file); 
+}
+
+/*------------------------------------------------------*/
+void AzSortedFeat_Dense::read(AzFile *file, 
+                              const AzValArr *v_data_transpose)
+{
+  v_dx2v = v_data_transpose; 
+  ia_index.read(file); 
+  if (ia_index.size() != v_dx2v->rowNum()) {
+    throw new AzException(AzInputError, "AzSortedFeat_Dense::read", 
+                          file->pointFileName(), "#data mismatch"); 
+  }
+  index = ia_index.point(&index_num); 
+  offset = 0; 
+  isOriginal = true; 
+}
+
 /*------------------------------------------------------*/
 void AzSortedFeat_Dense::filter(const AzSortedFeat_Dense *inp, 
                           const AzIntArr *ia_isYes, 
@@ -235,7 +259,7 @@ const
     return NULL;  /* end of data */
   }
 
-  const double *dx2value = v_dx2v->point(); 
+  const AZ_MTX_FLOAT *dx2value = v_dx2v->point(); 
 
   int dx = index[cursor]; 
   double curr_val = dx2value[dx]; 
@@ -278,7 +302,7 @@ const
                           "Conflict in # of data points"); 
   }
 
-  const double *dx2value = v_dx2v->point(); 
+  const AZ_MTX_FLOAT *dx2value = v_dx2v->point(); 
   int ix; 
   for (ix = 0; ix < index_num; ++ix) {
     int dx = index[ix]; 
@@ -333,7 +357,9 @@ void AzSortedFeat_Sparse::reset(const AzSvect *v_data_transpose,
   }
 
   /*---  make it flat for faster access later on  ---*/
-  AzTools::flatten(&ifa_dx_val, &ia_index, &v_value); 
+  AzDvect v_val; 
+  AzTools::flatten(&ifa_dx_val, &ia_index, &v_val); 
+  v_value.set(&v_val); 
 
   /*---  ---*/
   _shouldDoBackward = false;
@@ -351,6 +377,26 @@ void AzSortedFeat_Sparse::reset(const AzSvect *v_data_transpose,
   }
 }
 
+/*------------------------------------------------------*/
+void AzSortedFeat_Sparse::write(AzFile *file)
+{
+  file->writeInt(data_num); 
+  file->writeBool(_shouldDoBackward); 
+  ia_zero.write(file); 
+  ia_index.write(file); 
+  v_value.write(file); 
+}
+
+/*------------------------------------------------------*/
+void AzSortedFeat_Sparse::read(AzFile *file)
+{
+  data_num = file->readInt(); 
+  _shouldDoBackward = file->readBool(); 
+  ia_zero.read(file); 
+  ia_index.read(file); 
+  v_value.read(file); 
+}
+
 /*------------------------------------------------------*/
 void AzSortedFeat_Sparse::filter(const AzSortedFeat_Sparse *inp, 
                           const AzIntArr *ia_isYes, 
@@ -372,7 +418,7 @@ void AzSortedFeat_Sparse::filter(const AzSortedFeat_Sparse *inp,
 
   int inp_index_num; 
   const int *inp_index = inp->ia_index.point(&inp_index_num); 
-  const double *inp_value = inp->v_value.point(); 
+  const AZ_MTX_FLOAT *inp_value = inp->v_value.point(); 
   int where_is_zero = -1; 
   for (ix = 0; ix < inp_index_num; ++ix) {
     int dx = inp_index[ix]; 
@@ -417,7 +463,7 @@ void AzSortedFeat_Sparse::separate(const AzSortedFeat_Sparse *inp,
 
   int inp_index_num; 
   const int *inp_index = inp->ia_index.point(&inp_index_num); 
-  const double *inp_value = inp->v_value.point(); 
+  const AZ_MTX_FLOAT *inp_value = inp->v_value.point(); 
   int yes_where_is_zero = -1, no_where_is_zero = -1; 
   for (ix = 0; ix < inp_index_num; ++ix) {
     int dx = inp_index[ix]; 
@@ -474,7 +520,7 @@ void AzSortedFeat_Sparse::sub_terminate(AzSortedFeat_Sparse *ptr,
     if (zero_num == 0) {
       /*---  remove dummy entry  ---*/
       ptr->ia_index.remove(where_is_zero); 
-      double *value = ptr->v_value.point_u(); 
+      AZ_MTX_FLOAT *value = ptr->v_value.point_u(); 
       int ix; 
       for (ix = where_is_zero+1; ix < ptr->v_value.rowNum(); ++ix) {
         value[ix-1] = value[ix]; 
@@ -528,7 +574,7 @@ const
     return NULL;  /* end of data */
   }
 
-  const double *value = v_value.point(); 
+  const AZ_MTX_FLOAT *value = v_value.point(); 
 
   int dx = index[cursor]; 
   double curr_val = value[cursor]; 
@@ -583,7 +629,7 @@ const
     return NULL;  /* end of data */
   }
 
-  const double *value = v_value.point(); 
+  const AZ_MTX_FLOAT *value = v_value.point(); 
 
   int dx = index[cursor-1]; 
   double curr_val = value[cursor-1]; 
@@ -640,7 +686,7 @@ const
 
   int num; 
   const int *index = ia_index.point(&num); 
-  const double *value = v_value.point(); 
+  const AZ_MTX_FLOAT *value = v_value.point(); 
 
   int ix; 
   for (ix = 0; ix < num; ++ix) {
@@ -699,7 +745,7 @@ const
 
 /*--------------------------------------------------------*/
 /*--------------------------------------------------------*/
-void AzSortedFeatArr::reset_sparse(const AzSmat *m_tran, 
+void AzSortedFeatArr::reset_sparse(const AzSmatc *m_tran, 
                             bool inp_beTight)
 {
   const char *eyec = "AzSortedFeatArr::reset_sparse"; 
@@ -723,7 +769,7 @@ void AzSortedFeatArr::reset_sparse(const AzSmat *m_tran,
 }
 
 /*--------------------------------------------------------*/
-void AzSortedFeatArr::reset_dense(const AzDmat *m_tran_dense,   /* set */
+void AzSortedFeatArr::reset_dense(const AzValMat *m_tran_dense,   /* set */
                                   bool inp_beTight)
 {
   const char *eyec = "AzSortedFeatArr::reset (dense)"; 
@@ -747,6 +793,73 @@ void AzSortedFeatArr::reset_dense(const AzDmat *m_tran_dense,   /* set */
   }
 }
 
+/*--------------------------------------------------------*/
+void AzSortedFeatArr::write(AzFile *file)
+{
+  const char *eyec = "AzSortedFeatArr::write"; 
+  if (ia_isActive.size() > 0) {
+    throw new AzException(eyec, "only the original sorted features can be written"); 
+  }
+  file->writeInt(f_num); 
+  file->writeBool(doingSparse()); 
+  int fx; 
+  for (fx = 0; fx < f_num; ++fx) {
+    if (arrs != NULL) arrs[fx]->write(file); 
+    else              arrd[fx]->write(file); 
+  }
+}
+
+/*--------------------------------------------------------*/
+void AzSortedFeatArr::read_sparse(AzFile *file, 
+                                  bool inp_beTight)
+{
+  const char *eyec = "AzSortedFeatArr::read_sparse"; 
+  beTight = inp_beTight; 
+  f_num = file->readInt(); 
+  bool isSparse = file->readBool(); 
+  if (!isSparse) {
+    throw new AzException(AzInputError, eyec, file->pointFileName(), 
+                          "sorted features are not sparse"); 
+  }
+  ia_isActive.reset(); 
+  active_num = 0; 
+
+  a_sparse.free(&arrs); 
+  a_dense.free(&arrd); 
+  a_sparse.alloc(&arrs, f_num, eyec, "arrs"); 
+  int fx; 
+  for (fx = 0; fx < f_num; ++fx) {
+    arrs[fx] = new AzSortedFeat_Sparse(); 
+    arrs[fx]->read(file); 
+  }
+}
+
+/*--------------------------------------------------------*/
+void AzSortedFeatArr::read_dense(AzFile *file, 
+                                 const AzValMat *m_tran_dense, 
+                                 bool inp_beTight)
+{
+  const char *eyec = "AzSortedFeatArr::read_dense"; 
+  beTight = inp_beTight; 
+  f_num = file->readInt(); 
+  bool isSparse = file->readBool(); 
+  if (isSparse || f_num != m_tran_dense->colNum()) {
+    throw new AzException(AzInputError, eyec, file->pointFileName(), 
+                          "sorted features do not match the data"); 
+  }
+  ia_isActive.reset(); 
+  active_num = 0; 
+
+  a_sparse.free(&arrs); 
+  a_dense.free(&arrd); 
+  a_dense.alloc(&arrd, f_num, eyec, "arrd"); 
+  int fx; 
+  for (fx = 0; fx < f_num; ++fx) {
+    arrd[fx] = new AzSortedFeat_Dense(); 
+    arrd[fx]->read(file, m_tran_dense->col(fx)); 
+  }
+}
+
 /*--------------------------------------------------------*/
 void AzSortedFeatArr::copy_base(const AzSortedFeatArr *inp)
 {
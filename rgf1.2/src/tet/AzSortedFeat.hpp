@@ -21,7 +21,9 @@
 
 #include "AzUtil.hpp"
 #include "AzSmat.hpp"
+#include "AzSmatc.hpp"
 #include "AzDmat.hpp"
+#include "AzValMat.hpp"
 
 
 class AzSortedFeat
@@ -45,13 +47,13 @@ protected:
   const int *index; 
   int index_num; 
   int offset; 
-  const AzDvect *v_dx2v; 
+  const AzValArr *v_dx2v; 
   bool isOriginal; 
 
 public:
   AzSortedFeat_Dense() : v_dx2v(NULL), index(NULL), index_num(0), 
                          offset(-1), isOriginal(false) {}
-  AzSortedFeat_Dense(const AzDvect *v_data_transpose, 
+  AzSortedFeat_Dense(const AzValArr *v_data_transpose, 
                      const AzIntArr *ia_dx) 
                        : v_dx2v(NULL), index(NULL), index_num(0), 
                          offset(-1), isOriginal(false) {
@@ -70,11 +72,15 @@ public:
     copy_base(inp); 
   }
 
-  void reset(const AzDvect *v_data_transpose, const AzIntArr *ia_dx); 
+  void reset(const AzValArr *v_data_transpose, const AzIntArr *ia_dx); 
   void filter(const AzSortedFeat_Dense *inp,
               const AzIntArr *ia_isYes,
               int yes_num); 
 
+  /*---  for the binary data cache; only for the original one  ---*/
+  void write(AzFile *file); 
+  void read(AzFile *file, const AzValArr *v_data_transpose); 
+
   inline int dataNum() const {
     return index_num; 
   }
@@ -133,7 +139,7 @@ class AzSortedFeat_Sparse : public virtual AzSortedFeat
 protected:
   AzIntArr ia_zero; /* may not be set if unnecessary */
   AzIntArr ia_index; 
-  AzDvect v_value; 
+  AzValArr v_value; 
   bool _shouldDoBackward; 
   int data_num; 
 
@@ -165,6 +171,10 @@ public:
               const AzIntArr *ia_isYes, 
               int yes_num); 
 
+  /*---  for the binary data cache  ---*/
+  void write(AzFile *file); 
+  void read(AzFile *file); 
+
   inline void rewind(AzCursor &cur) const {
     if (_shouldDoBackward) {
       cur.set(ia_index.size()); 
@@ -253,10 +263,18 @@ public:
                     : arrs(NULL), arrd(NULL), f_num(0), beTight(false) {
     filter_base(inp, dxs, dxs_num); 
   }
-  void reset_sparse(const AzSmat *m_tran, 
+  void reset_sparse(const AzSmatc *m_tran, 
                     bool beTight=false); 
-  void reset_dense(const AzDmat *m_tran_dense, 
+  void reset_dense(const AzValMat *m_tran_dense, 
+                   bool inp_beTight=false); 
+
+  /*---  for the binary data cache: the result of reset_sparse|dense  ---*/
+  void write(AzFile *file); 
+  void read_sparse(AzFile *file, 
                    bool inp_beTight=false); 
+  void read_dense(AzFile *file, 
+                  const AzValMat *m_tran_dense, /* must be what was sorted */
+                  bool inp_beTight=false); 
 
   inline bool doingSparse() const {
     if (arrs != NULL) return true; 
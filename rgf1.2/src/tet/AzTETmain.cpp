@@ -25,6 +25,9 @@
 #include "AzTaskTools.hpp"
 #include "AzHelp.hpp"
 #include "AzTETproc.hpp"
+#include "AzTreeEnsembleFlat.hpp"
+#include "AzTreeEnsembleMulti.hpp"
+#include "AzTreeEnsembleCode.hpp"
 
 static int exe_argx = 0; 
 static int action_argx = 1; 
@@ -48,12 +51,16 @@ void AzTETmain::train(const char *argv[], int argc)
 
   /*---  read training data  ---*/
   AzDvect v_tr_y, v_fixed_dw; 
-  AzSmat m_tr_x; 
+  AzSmatc m_tr_x; 
   AzSvFeatInfoClone featInfo; 
+  AzDataCache cache; 
   AzTimeLog::print("Reading training data ... ", log_out); 
-  readData(s_train_x_fn.c_str(), s_train_y_fn.c_str(), s_fdic_fn.c_str(), 
-           &m_tr_x, &v_tr_y, &featInfo); 
-  readDataWeights(s_dw_fn, v_tr_y.rowNum(), &v_fixed_dw); 
+  readTrainingData(&cache, &m_tr_x, &v_tr_y, &v_fixed_dw, &featInfo); 
+
+  if (class_num > 0) {
+    train_multiclass(&cache, &m_tr_x, &v_tr_y, &v_fixed_dw, &featInfo); 
+    return; 
+  }
 
   /*---  for wamr start  ---*/
   AzTreeEnsemble *prev_ens_ptr = NULL, prev_ens; 
@@ -64,21 +71,79 @@ void AzTETmain::train(const char *argv[], int argc)
 
   /*---  select algorithm  ---*/
   AzTETrainer *trainer = alg_sel->select(s_alg_name.c_str()); 
+  if (s_x_bin_fn.length() > 0) trainer->reset_data_cache(&cache); 
+  else                         trainer->reset_packed_data(&m_tr_x); 
+  AzSmat m_none; /* the trainer takes the data set above instead */
+
+  /*---  read validation data  ---*/
+  AzSmat m_valid_x; 
+  AzDvect v_valid_y; 
+  if (s_valid_x_fn.length() > 0) {
+    AzTimeLog::print("Reading validation data ... ", log_out); 
+    readData(s_valid_x_fn.c_str(), s_valid_y_fn.c_str(), "", 
+             &m_valid_x, &v_valid_y); 
+  }
 
   /*---  training  ---*/
   print_config(s_tet_param, log_out); 
-  AzTimeLog::print("Start ... #train=", m_tr_x.colNum(), log_out); 
+  AzTimeLog::print("Start ... #train=", v_tr_y.rowNum(), log_out); 
   print_hline(log_out); 
   clock_t t0 = clock(); 
-  AzTETproc::train(log_out, trainer, s_tet_param.c_str(), 
-                   &m_tr_x, &v_tr_y, &featInfo, 
-                   s_model_stem.c_str(), s_model_names_fn.c_str(), 
-                   &v_fixed_dw, prev_ens_ptr); 
+  if (s_valid_x_fn.length() > 0) {
+    AzTETproc::train_valid(log_out, trainer, s_tet_param.c_str(), 
+                     &m_none, &v_tr_y, &featInfo, 
+                     &m_valid_x, &v_valid_y, validPerfType(), valid_patience, 
+                     s_model_stem.c_str(), s_model_names_fn.c_str(), 
+                     &v_fixed_dw, prev_ens_ptr, doCompact); 
+  }
+  else {
+    const char *checkpoint_fn = NULL; 
+    if (s_checkpoint_fn.length() > 0) checkpoint_fn = s_checkpoint_fn.c_str(); 
+    AzTETproc::train(log_out, trainer, s_tet_param.c_str(), 
+                     &m_none, &v_tr_y, &featInfo, 
+                     s_model_stem.c_str(), s_model_names_fn.c_str(), 
+                     &v_fixed_dw, prev_ens_ptr, checkpoint_fn, doCompact); 
+  }
   AzTimeLog::print("Done ... ", log_out); 
   clock_t clk = clock() - t0; 
   show_elapsed(log_out, clk); 
 }
 
+/*------------------------------------------------*/
+/* one-vs-rest; the training data is sorted once  */
+/* for all the classes as in "sweep"              */
+/*------------------------------------------------*/
+void AzTETmain::train_multiclass(AzDataCache *cache, 
+                                 AzSmatc *m_tr_x, 
+                                 const AzDvect *v_tr_y, 
+                                 const AzDvect *v_fixed_dw, 
+                                 const AzSvFeatInfo *featInfo)
+{
+  alg_sel->select(s_alg_name.c_str()); /* to check the name before sorting data */
+
+  AzDataForTrTree data; 
+  AzParam p(s_tet_param.c_str(), false); /* the rest is for the trainers */
+  bool beTight = false; /* the data is kept until the end */
+  if (s_x_bin_fn.length() > 0) cache->read_data(log_out, p, beTight, &data); 
+  else                         data.reset_data(log_out, m_tr_x, NULL, p, beTight, featInfo); 
+  m_tr_x->reset(); 
+
+  int th_num = AzThreads::threadNum(class_threads, class_num); 
+
+  print_config(s_tet_param, log_out); 
+  AzBytArr s; 
+  s.c("#class="); s.cn(class_num); 
+  s.c(", #train="); s.cn(v_tr_y->rowNum()); 
+  AzTimeLog::print("Start ... ", s.c_str(), log_out); 
+  print_hline(log_out); 
+  clock_t t0 = clock(); 
+  AzTETproc::train_multiclass(log_out, alg_sel, s_alg_name.c_str(), th_num, 
+                   s_tet_param.c_str(), &data, v_tr_y, class_num, featInfo, v_fixed_dw, 
+                   s_model_stem.c_str(), s_model_names_fn.c_str(), doCompact); 
+  AzTimeLog::print("Done ... ", log_out); 
+  show_elapsed(log_out, clock() - t0); 
+}
+
 /*------------------------------------------------------------------*/
 void AzTETmain::readData(const char *x_fn, 
                          const char *y_fn, 
@@ -99,7 +164,24 @@ const
 }
 
 /*------------------------------------------------------------------*/
-void AzTETmain::readDataWeights(AzBytArr &s_fn, 
+void AzTETmain::readData(const char *x_fn, 
+                         const char *y_fn, 
+                         const char *fdic_fn, 
+                         /*---  output  ---*/
+                         AzSmatc *m_x, 
+                         AzDvect *v_y, 
+                         AzSvFeatInfoClone *featInfo) /* may be NULL */
+const 
+{
+  AzStrPool sp_desc; 
+  AzSvDataS::read_packed(x_fn, y_fn, fdic_fn, m_x, v_y, &sp_desc); 
+  if (featInfo != NULL) {
+    featInfo->reset(&sp_desc); 
+  }
+}
+
+/*------------------------------------------------------------------*/
+void AzTETmain::readDataWeights(const AzBytArr &s_fn, 
                             int data_num, 
                             AzDvect *v_fixed_dw)
 const
@@ -114,6 +196,58 @@ const
   }
 }
 
+/*------------------------------------------------------------------*/
+/* Training data comes from either text files or the binary data    */
+/* cache; in the latter, m_tr_x is left empty, and the trainer      */
+/* should read the data from the cache.                             */
+void AzTETmain::readTrainingData(AzDataCache *cache, 
+                         /*---  output  ---*/
+                         AzSmatc *m_tr_x, 
+                         AzDvect *v_tr_y, 
+                         AzDvect *v_fixed_dw, 
+                         AzSvFeatInfoClone *featInfo)
+const
+{
+  if (s_x_bin_fn.length() <= 0) {
+    readData(s_train_x_fn.c_str(), s_train_y_fn.c_str(), s_fdic_fn.c_str(), 
+             m_tr_x, v_tr_y, featInfo); 
+    readDataWeights(s_dw_fn, v_tr_y->rowNum(), v_fixed_dw); 
+    return; 
+  }
+
+  cache->reset(s_x_bin_fn.c_str()); 
+  if (cache->targets()->rowNum() <= 0) {
+    throw new AzException(AzInputError, "AzTETmain::readTrainingData", 
+              s_x_bin_fn.c_str(), "has no targets.  Specify train_y_fn for prepare_data."); 
+  }
+  v_tr_y->set(cache->targets()); 
+  featInfo->reset(cache->featInfo()); 
+  if (s_dw_fn.length() > 0) {
+    readDataWeights(s_dw_fn, v_tr_y->rowNum(), v_fixed_dw); 
+  }
+  else {
+    v_fixed_dw->set(cache->weights()); 
+  }
+}
+
+/*------------------------------------------------------------------*/
+void AzTETmain::readTestData_bin(AzSmat *m_test_x, 
+                                 AzDvect *v_test_y) /* set only if test_y_fn is specified */
+const
+{
+  AzDataCache cache; 
+  cache.reset(s_x_bin_fn.c_str()); 
+  cache.read_features(m_test_x); 
+  if (s_test_y_fn.length() > 0) {
+    AzSvDataS::readVector(s_test_y_fn.c_str(), v_test_y); 
+    if (v_test_y->rowNum() != m_test_x->colNum()) {
+      AzBytArr s("Conflict in dimensionality: #data = "); s.cn(m_test_x->colNum()); 
+      s.c(", # of values in "); s.c(&s_test_y_fn); s.c(" = "); s.cn(v_test_y->rowNum()); 
+      throw new AzException(AzInputNotValid, "AzTETmain::readTestData_bin", s.c_str()); 
+    }
+  }
+}
+
 /*------------------------------------------------*/
 void AzTETmain::print_config(const AzBytArr &s_config, 
                              const AzOut &out) const 
@@ -139,27 +273,49 @@ void AzTETmain::predict_single(const char *argv[], int argc)
   if (!success) return; 
 
   prepareLogDmp(doLog, doDump);
+  if (AzFile::isStdio(s_pred_fn.c_str()) && !log_out.isNull()) {
+    log_out.setStderr(); /* stdout is for predictions */
+  }
 
   printParam_predict_single(log_out); 
   print_hline(log_out); 
   checkParam_predict_single();
 
+  if (stream_chunk > 0) {
+    predict_stream(log_out); 
+    AzTimeLog::print("Done ... ", log_out); 
+    return; 
+  }
+
   /*---  read test data  ---*/
   AzTimeLog::print("Reading test data ... ", log_out); 
   AzSvDataS dataset; 
+  AzSmat m_bin_x; 
+  AzDvect v_bin_y; 
+  const AzSmat *m_test_x = &m_bin_x; 
   bool doEval = false;
-  if (s_test_y_fn.length() > 0) {
+  if (s_x_bin_fn.length() > 0) {
+    readTestData_bin(&m_bin_x, &v_bin_y); 
+    if (s_test_y_fn.length() > 0) {
+      doEval = true; 
+      eval->reset(&v_bin_y, s_eval_fn.c_str(), doAppend_eval); 
+      eval->begin(); 
+    }
+  }
+  else if (s_test_y_fn.length() > 0) {
     dataset.read(s_test_x_fn.c_str(), s_test_y_fn.c_str());     
     doEval = true; 
     eval->reset(dataset.targets(), s_eval_fn.c_str(), doAppend_eval); 
     eval->begin(); 
+    m_test_x = dataset.feat(); 
   }
   else {
     dataset.read_features_only(s_test_x_fn.c_str()); 
+    m_test_x = dataset.feat(); 
   }
 
   AzTimeLog::print("Predicting ... ", log_out); 
-  _predict(&dataset, s_model_fn.c_str(), s_pred_fn.c_str(), log_out, doEval); 
+  _predict(m_test_x, s_model_fn.c_str(), s_pred_fn.c_str(), log_out, doEval); 
 
   if (doEval) {
     eval->end(); 
@@ -168,6 +324,61 @@ void AzTETmain::predict_single(const char *argv[], int argc)
   AzTimeLog::print("Done ... ", log_out); 
 }
 
+/*------------------------------------------------*/
+/* Read test data stream_chunk data points at a time and write the  */
+/* predictions right away.  test_x_fn and prediction_fn can be "-". */
+void AzTETmain::predict_stream(const AzOut &out) const
+{
+  const char *model_fn = s_model_fn.c_str(); 
+  AzTimeLog::print("Predicting in the streaming mode ... ", out); 
+  AzSvDataStream stream; 
+  stream.reset(s_test_x_fn.c_str()); 
+  AzTreeEnsembleFlat flat; 
+  if (AzTreeEnsembleFlat::isPacked(model_fn)) {
+    flat.map(model_fn); 
+    checkFeatNum(stream.featNum(), flat.orgdim(), model_fn); 
+    if (flat.outNum() != 1) {
+      throw new AzException(AzInputNotValid, "AzTETmain::predict_stream", 
+            "A multi-output model is supported only by \"predict\" without streaming: ", model_fn); 
+    }
+  }
+  else {
+    AzTreeEnsemble ens; 
+    readModel(stream.featNum(), model_fn, &ens); 
+    flat.reset(&ens); 
+  }
+
+  AzFile pred_file(s_pred_fn.c_str()); 
+  pred_file.open("wb"); 
+  int data_num = 0; 
+  clock_t apply_clk = 0; 
+  for ( ; ; ) {
+    AzSmat m_test_x; 
+    int num = stream.read(stream_chunk, &m_test_x); 
+    if (num <= 0) break; 
+    AzDvect v_test_p; 
+    clock_t t0 = clock(); 
+    flat.apply(&m_test_x, &v_test_p, num_threads); 
+    apply_clk += clock() - t0; 
+    writePrediction_single(&v_test_p, &pred_file); 
+    pred_file.flush(); 
+    data_num += num; 
+  }
+  pred_file.close(true); 
+  stream.close(); 
+
+  if (!out.isNull()) {
+    AzPrint::writeln(out, "#test=", data_num); 
+    show_elapsed(out, apply_clk); 
+    AzBytArr s(s_pred_fn); s.c(": "); 
+    AzBytArr s_info; 
+    AzTE_ModelInfo info; 
+    flat.info(&info); 
+    format_info(model_fn, &info, "=", ",", &s_info); 
+    AzPrint::writeln(out, s, s_info); 
+  }
+}
+
 /*------------------------------------------------------------------*/
 void AzTETmain::writePrediction_single(const AzDvect *v_p, 
                                        AzFile *file)
@@ -184,43 +395,261 @@ void AzTETmain::writePrediction_single(const AzDvect *v_p,
   s.writeText(file); 
 }
 
+/*------------------------------------------------------------------*/
+void AzTETmain::writePrediction_multi(const AzDmat *m_p, /* #output x #data */
+                                      AzFile *file)
+{
+  /* one line per data point with the outputs delimited by a space */
+  int width = 8; 
+  int dx; 
+  for (dx = 0; dx < m_p->colNum(); ++dx) {
+    AzBytArr s; 
+    int ox; 
+    for (ox = 0; ox < m_p->rowNum(); ++ox) {
+      if (ox > 0) s.c(" "); 
+      s.concatFloat(m_p->get(ox, dx), width); 
+    }
+    s.nl(); 
+    s.writeText(file); 
+  }
+}
+
+/*------------------------------------------------*/
+void AzTETmain::_predict(const AzSmat *m_test_x, 
+                         const char *model_fn, 
+                         const char *pred_fn, 
+                         const AzOut &out, 
+                         bool doEval) const
+{
+  if (AzTreeEnsembleFlat::isPacked(model_fn)) {
+    _predict_packed(m_test_x, model_fn, pred_fn, out, doEval); 
+    return; 
+  }
+  if (AzTreeEnsembleMulti::isMultiOutput(model_fn)) {
+    if (doEval) {
+      throw new AzException(AzInputNotValid, "AzTETmain::_predict", 
+            "Evaluation is not supported with a multi-output model: ", model_fn); 
+    }
+    _predict_multi(m_test_x, model_fn, pred_fn, out); 
+    return; 
+  }
+  AzTreeEnsemble ens; 
+  readModel(m_test_x->rowNum(), model_fn, &ens); 
+  AzDvect v_test_p; 
+  clock_t t0 = clock(); 
+  AzTreeEnsembleFlat flat(&ens); /* faster than ens.apply; same result */
+  flat.apply(m_test_x, &v_test_p, num_threads); 
+  clock_t apply_clk = clock() - t0; 
+
+  if (!out.isNull()) {
+    show_elapsed(out, apply_clk); 
+  }
+  AzTE_ModelInfo info; 
+  ens.info(&info); 
+  _predict_output(&info, &v_test_p, model_fn, pred_fn, out, doEval); 
+}
+
 /*------------------------------------------------*/
-void AzTETmain::_predict(const AzSvDataS *dataset, 
+/* A packed model (pack_model) is mapped into memory and used as it is. */
+void AzTETmain::_predict_packed(const AzSmat *m_test_x, 
                          const char *model_fn, 
                          const char *pred_fn, 
                          const AzOut &out, 
                          bool doEval) const
 {
-  AzTreeEnsemble ens(model_fn); 
-  if (ens.orgdim() > 0 && 
-      ens.orgdim() != dataset->featNum()) {
-    AzBytArr s("#feature in test data is "); s.cn(dataset->featNum()); 
-    s.c(", whereas #feature in training data was "); s.cn(ens.orgdim()); 
-    throw new AzException(AzInputError, "AzTETmain::_predict", s.c_str()); 
+  clock_t t0 = clock(); 
+  AzTreeEnsembleFlat flat; 
+  flat.map(model_fn); 
+  checkFeatNum(m_test_x->rowNum(), flat.orgdim(), model_fn); 
+  AzTE_ModelInfo info; 
+  flat.info(&info); 
+  if (flat.outNum() != 1) {
+    if (doEval) {
+      throw new AzException(AzInputNotValid, "AzTETmain::_predict_packed", 
+            "Evaluation is not supported with a multi-output model: ", model_fn); 
+    }
+    AzDmat m_test_p; 
+    flat.apply(m_test_x, &m_test_p, num_threads); 
+    clock_t apply_clk = clock() - t0; 
+    AzFile pred_file(pred_fn);  
+    pred_file.open("wb"); 
+    writePrediction_multi(&m_test_p, &pred_file); 
+    pred_file.close(true); 
+    if (!out.isNull()) {
+      show_elapsed(out, apply_clk); 
+      AzBytArr s(pred_fn); s.c(": "); 
+      s.c(model_fn); s.c(","); 
+      s.c("#class="); s.cn(flat.outNum()); s.c(","); 
+      s.c("#leaf="); s.cn(info.leaf_num); s.c(","); 
+      s.c("#tree="); s.cn(info.tree_num); 
+      AzPrint::writeln(out, s); 
+    }
+    return; 
   }
+
   AzDvect v_test_p; 
+  flat.apply(m_test_x, &v_test_p, num_threads); 
+  clock_t apply_clk = clock() - t0; 
+  if (!out.isNull()) {
+    show_elapsed(out, apply_clk); 
+  }
+  _predict_output(&info, &v_test_p, model_fn, pred_fn, out, doEval); 
+}
+
+/*------------------------------------------------*/
+/* All the outputs of each data point in one pass; one line per data  */
+/* point with the scores of the classes delimited by a space.         */
+void AzTETmain::_predict_multi(const AzSmat *m_test_x, 
+                         const char *model_fn, 
+                         const char *pred_fn, 
+                         const AzOut &out) const
+{
+  AzTreeEnsembleMulti multi(model_fn); 
+  checkFeatNum(m_test_x->rowNum(), multi.orgdim(), model_fn); 
+  AzDataArr<const AzTreeEnsemble *> arr_ens(multi.outNum()); 
+  int ox; 
+  for (ox = 0; ox < multi.outNum(); ++ox) *arr_ens.point_u(ox) = multi.ens(ox); 
+  AzDmat m_test_p; 
   clock_t t0 = clock(); 
-  ens.apply(dataset->feat(), &v_test_p); 
+  AzTreeEnsembleFlat flat(arr_ens.point(0), multi.outNum()); 
+  flat.apply(m_test_x, &m_test_p, num_threads); 
   clock_t apply_clk = clock() - t0; 
+  if (!out.isNull()) {
+    show_elapsed(out, apply_clk); 
+  }
+
+  AzFile pred_file(pred_fn);  
+  pred_file.open("wb"); 
+  writePrediction_multi(&m_test_p, &pred_file); 
+  pred_file.close(true); 
+
+  if (!out.isNull()) {
+    AzTE_ModelInfo info; 
+    multi.info(&info); 
+    AzBytArr s(pred_fn); s.c(": "); 
+    s.c(model_fn); s.c(","); 
+    s.c("#class="); s.cn(multi.outNum()); s.c(","); 
+    s.c("#leaf="); s.cn(info.leaf_num); s.c(","); 
+    s.c("#tree="); s.cn(info.tree_num); 
+    AzPrint::writeln(out, s); 
+  }
+}
 
+/*------------------------------------------------*/
+void AzTETmain::readModel(int f_num, /* #feature in test data */
+                          const char *model_fn, 
+                          AzTreeEnsemble *ens) /* output */
+{
+  if (AzTreeEnsembleMulti::isMultiOutput(model_fn)) {
+    throw new AzException(AzInputNotValid, "AzTETmain::readModel", 
+          "A multi-output model is supported only by \"predict\" without streaming: ", model_fn); 
+  }
+  if (AzTreeEnsembleFlat::isPacked(model_fn)) {
+    throw new AzException(AzInputNotValid, "AzTETmain::readModel", 
+          "A packed model is supported only by \"predict\", \"batch_predict\", and \"serve\": ", model_fn); 
+  }
+  ens->read(model_fn); 
+  checkFeatNum(f_num, ens->orgdim(), model_fn); 
+}
+
+/*------------------------------------------------*/
+void AzTETmain::checkFeatNum(int f_num, /* #feature in test data */
+                             int orgdim, /* #feature in training data */
+                             const char *model_fn)
+{
+  if (orgdim > 0 && orgdim != f_num) {
+    AzBytArr s("#feature in test data is "); s.cn(f_num); 
+    s.c(", whereas #feature in training data was "); s.cn(orgdim); 
+    s.c(": "); s.c(model_fn); 
+    throw new AzException(AzInputError, "AzTETmain::checkFeatNum", s.c_str()); 
+  }
+}
+
+/*------------------------------------------------*/
+void AzTETmain::_predict_output(const AzTE_ModelInfo *info, 
+                         const AzDvect *v_test_p, 
+                         const char *model_fn, 
+                         const char *pred_fn, 
+                         const AzOut &out, 
+                         bool doEval) const
+{
   /*---  write predictions  ---*/
   AzFile pred_file(pred_fn);  
   pred_file.open("wb"); 
-  writePrediction_single(&v_test_p, &pred_file); 
+  writePrediction_single(v_test_p, &pred_file); 
   pred_file.close(true); 
 
   if (!out.isNull()) {
-    show_elapsed(out, apply_clk); 
     AzBytArr s(pred_fn); s.c(": "); 
     AzBytArr s_info; 
-    format_info(model_fn, &ens, "=", ",", &s_info); 
+    format_info(model_fn, info, "=", ",", &s_info); 
     AzPrint::writeln(out, s, s_info); 
   }
   if (doEval) {
     /*---  write evaluation if required  ---*/
+    eval->evaluate(v_test_p, info, model_fn); 
+  }
+}
+
+/*------------------------------------------------*/
+/* Apply all the models at once.  The models saved during one training  */
+/* run share the trees of the earlier ones (with more nodes split and   */
+/* with other weights), and AzTreeEnsembleFlat packs such trees once;   */
+/* so a data point goes down each distinct tree once for all the models. */
+/* The models are read on up to th_num threads.                         */
+void AzTETmain::_predict_models(const AzSmat *m_test_x, 
+                         const AzStrPool *sp_model_fn, 
+                         int th_num, 
+                         const AzOut &out, 
+                         bool doEval) const
+{
+  int num = sp_model_fn->size(); 
+  AzDataArr<AzTreeEnsemble> arr_ens(num); 
+  AzThreadErr th_err; 
+  int ix; 
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(th_num) schedule(dynamic,1)
+#endif
+  for (ix = 0; ix < num; ++ix) {
+    try {
+      readModel(m_test_x->rowNum(), sp_model_fn->c_str(ix), arr_ens.point_u(ix)); 
+    }
+    catch (AzException *e) {
+      th_err.keep(e); 
+    }
+  }
+  th_err.throw_if(); 
+
+  AzDataArr<const AzTreeEnsemble *> arr_ens_ptr(num); 
+  int t_num = 0; 
+  for (ix = 0; ix < num; ++ix) {
+    *arr_ens_ptr.point_u(ix) = arr_ens.point(ix); 
+    t_num += arr_ens.point(ix)->size(); 
+  }
+  clock_t t0 = clock(); 
+  AzTreeEnsembleFlat flat(arr_ens_ptr.point(0), num); 
+  AzDmat m_test_p; 
+  flat.apply(m_test_x, &m_test_p, num_threads); 
+  clock_t apply_clk = clock() - t0; 
+
+  if (!out.isNull()) {
+    AzBytArr s("#model="); s.cn(num); s.c(", #tree="); s.cn(t_num); 
+    s.c(", #distinct tree="); s.cn(flat.treeNum()); 
+    AzPrint::writeln(out, s); 
+    show_elapsed(out, apply_clk); 
+  }
+  int data_num = m_test_x->colNum(); 
+  AzDvect v_test_p(data_num); 
+  for (ix = 0; ix < num; ++ix) {
+    int dx; 
+    for (dx = 0; dx < data_num; ++dx) v_test_p.set(dx, m_test_p.get(ix, dx)); 
+    const char *model_fn = sp_model_fn->c_str(ix); 
+    AzBytArr s_pred_fn(model_fn); 
+    s_pred_fn.concat(&s_pred_fn_suffix); 
     AzTE_ModelInfo info; 
-    ens.info(&info); 
-    eval->evaluate(&v_test_p, &info, model_fn); 
+    arr_ens.point(ix)->info(&info); 
+    _predict_output(&info, &v_test_p, 
+                    model_fn, s_pred_fn.c_str(), out, doEval); 
   }
 }
 
@@ -239,29 +668,56 @@ void AzTETmain::batch_predict(const char *argv[], int argc)
   /*---  read test data  ---*/
   bool doEval = false;
   AzSvDataS dataset; 
-  if (s_test_y_fn.length() > 0) {
+  AzSmat m_bin_x; 
+  AzDvect v_bin_y; 
+  const AzSmat *m_test_x = &m_bin_x; 
+  if (s_x_bin_fn.length() > 0) {
+    readTestData_bin(&m_bin_x, &v_bin_y); 
+    if (s_test_y_fn.length() > 0) {
+      doEval = true; 
+      eval->reset(&v_bin_y, s_eval_fn.c_str(), doAppend_eval); 
+      eval->begin(); 
+    }
+  }
+  else if (s_test_y_fn.length() > 0) {
     dataset.read(s_test_x_fn.c_str(), s_test_y_fn.c_str(), s_fdic_fn.c_str());     
     doEval = true; 
     eval->reset(dataset.targets(), s_eval_fn.c_str(), doAppend_eval); 
     eval->begin(); 
+    m_test_x = dataset.feat(); 
   }
   else {
     dataset.read_features_only(s_test_x_fn.c_str(), s_fdic_fn.c_str()); 
+    m_test_x = dataset.feat(); 
   }
 
   if (!log_out.isNull()) {
-    AzPrint::writeln(log_out, "#test=", dataset.size()); 
+    AzPrint::writeln(log_out, "#test=", m_test_x->colNum()); 
   }
   AzStrPool sp_model_fn; 
   AzTools::readList(s_model_names_fn.c_str(), 
                     &sp_model_fn); 
   int num = sp_model_fn.size(); 
+  bool doOneByOne = false; /* multi-output or packed models */
   int ix; 
   for (ix = 0; ix < num; ++ix) {
     const char *model_fn = sp_model_fn.c_str(ix); 
-    AzBytArr s_pred_fn(model_fn); 
-    s_pred_fn.concat(&s_pred_fn_suffix); 
-    _predict(&dataset, model_fn, s_pred_fn.c_str(), log_out, doEval); 
+    if (AzTreeEnsembleMulti::isMultiOutput(model_fn) || 
+        AzTreeEnsembleFlat::isPacked(model_fn)) doOneByOne = true; 
+  }
+  if (num > 1 && !doOneByOne) {
+    /*---  all the models at once sharing the trees  ---*/
+    int th_num = AzThreads::threadNum(num_threads, num); 
+    _predict_models(m_test_x, &sp_model_fn, th_num, log_out, doEval); 
+  }
+  else {
+    /*---  one model at a time; data points are split among threads  ---*/
+    for (ix = 0; ix < num; ++ix) {
+      const char *model_fn = sp_model_fn.c_str(ix); 
+      AzBytArr s_pred_fn(model_fn); 
+      s_pred_fn.concat(&s_pred_fn_suffix); 
+      _predict(m_test_x, model_fn, s_pred_fn.c_str(), log_out, doEval); 
+    }
   }
   if (doEval) {
     eval->end(); 
@@ -285,13 +741,17 @@ void AzTETmain::train_test(const char *argv[], int argc)
   clock_t clocks = 0; 
 
   /*---  read training data  ---*/
-  AzSmat m_tr_x; 
+  AzSmatc m_tr_x; 
   AzDvect v_tr_y, v_fixed_dw; 
   AzSvFeatInfoClone featInfo;  
+  AzDataCache cache; 
   AzTimeLog::print("Reading training data ... ", log_out); 
-  readData(s_train_x_fn.c_str(), s_train_y_fn.c_str(), s_fdic_fn.c_str(), 
-           &m_tr_x, &v_tr_y, &featInfo); 
-  readDataWeights(s_dw_fn, v_tr_y.rowNum(), &v_fixed_dw); 
+  readTrainingData(&cache, &m_tr_x, &v_tr_y, &v_fixed_dw, &featInfo); 
+
+  if (class_num > 0) {
+    train_multiclass(&cache, &m_tr_x, &v_tr_y, &v_fixed_dw, &featInfo); 
+    return; 
+  }
 
   /*---  for wamr start  ---*/
   AzTreeEnsemble *prev_ens_ptr = NULL, prev_ens; 
@@ -302,6 +762,9 @@ void AzTETmain::train_test(const char *argv[], int argc)
 
   /*---  select algorithm  ---*/
   AzTETrainer *trainer = alg_sel->select(s_alg_name.c_str()); 
+  if (s_x_bin_fn.length() > 0) trainer->reset_data_cache(&cache); 
+  else                         trainer->reset_packed_data(&m_tr_x); 
+  AzSmat m_none; /* the trainer takes the data set above instead */
 
   /*---  read test data  ---*/
   AzSmat m_test_x; 
@@ -315,7 +778,7 @@ void AzTETmain::train_test(const char *argv[], int argc)
   print_config(s_tet_param, log_out); 
 
   AzBytArr s; 
-  s.c("#train=");  s.cn(m_tr_x.colNum()); 
+  s.c("#train=");  s.cn(v_tr_y.rowNum()); 
   s.c(", #test="); s.cn(m_test_x.colNum()); 
   AzTimeLog::print("Start ... ", s.c_str(), log_out); 
   print_hline(log_out); 
@@ -323,7 +786,7 @@ void AzTETmain::train_test(const char *argv[], int argc)
   clock_t b_clk = clock(); 
   if (s_model_stem.length() > 0) {
     AzTETproc::train_test_save(log_out, trainer, s_tet_param.c_str(), 
-                               &m_tr_x, &v_tr_y, &featInfo, 
+                               &m_none, &v_tr_y, &featInfo, 
                                &m_test_x, eval, 
                                doSaveLastModelOnly, 
                                s_model_stem.c_str(), s_model_names_fn.c_str(), 
@@ -331,7 +794,7 @@ void AzTETmain::train_test(const char *argv[], int argc)
   }
   else {
     AzTETproc::train_test(log_out, trainer, s_tet_param.c_str(), 
-                          &m_tr_x, &v_tr_y, &featInfo, 
+                          &m_none, &v_tr_y, &featInfo, 
                           &m_test_x, eval, &v_fixed_dw, prev_ens_ptr); 
   }
   AzTimeLog::print("Done ...", log_out); 
@@ -355,7 +818,7 @@ void AzTETmain::xv(const char *argv[], int argc)
   clock_t clocks = 0; 
 
   /*---  read training data  ---*/
-  AzSmat m_tr_x; 
+  AzSmatc m_tr_x; 
   AzDvect v_tr_y, v_fixed_dw; 
   AzSvFeatInfoClone featInfo;  
   AzTimeLog::print("Reading training data ... ", log_out); 
@@ -363,8 +826,14 @@ void AzTETmain::xv(const char *argv[], int argc)
            &m_tr_x, &v_tr_y, &featInfo); 
   readDataWeights(s_dw_fn, v_tr_y.rowNum(), &v_fixed_dw); 
 
-  /*---  select algorithm  ---*/
-  AzTETrainer *trainer = alg_sel->select(s_alg_name.c_str()); 
+  /*---  select algorithm; one trainer for each thread  ---*/
+  int th_num = AzThreads::threadNum(xv_threads, xv_num); 
+  AzDataArr<AzTETrainer *> arr_trainer(th_num); 
+  *arr_trainer.point_u(0) = alg_sel->select(s_alg_name.c_str()); 
+  int thx; 
+  for (thx = 1; thx < th_num; ++thx) {
+    *arr_trainer.point_u(thx) = alg_sel->newTrainer(s_alg_name.c_str()); 
+  }
 
   print_config(s_tet_param, log_out); 
 
@@ -374,9 +843,16 @@ void AzTETmain::xv(const char *argv[], int argc)
   print_hline(log_out); 
 
   clock_t b_clk = clock(); 
-  AzTETproc::xv(log_out, xv_num, s_xv_fn.c_str(), xv_doShuffle, 
-                trainer, s_tet_param.c_str(), 
-                &m_tr_x, &v_tr_y, &featInfo, &v_fixed_dw); 
+  try {
+    AzTETproc::xv(log_out, xv_num, s_xv_fn.c_str(), xv_doShuffle, 
+                  arr_trainer.point_u(0), th_num, s_tet_param.c_str(), 
+                  &m_tr_x, &v_tr_y, &featInfo, &v_fixed_dw); 
+  }
+  catch (AzException *e) {
+    for (thx = 1; thx < th_num; ++thx) delete *arr_trainer.point(thx); 
+    throw e; 
+  }
+  for (thx = 1; thx < th_num; ++thx) delete *arr_trainer.point(thx); 
   AzTimeLog::print("Done ...", log_out); 
   clocks += (clock() - b_clk); 
   show_elapsed(log_out, clocks); 
@@ -399,9 +875,19 @@ void AzTETmain::format_info(const char *model_fn,
 {
   AzTE_ModelInfo info; 
   ens->info(&info);
+  format_info(model_fn, &info, name_dlm, dlm, s); 
+}
+
+/*------------------------------------------------*/
+void AzTETmain::format_info(const char *model_fn, 
+                          const AzTE_ModelInfo *info, 
+                          const char *name_dlm, 
+                          const char *dlm, 
+                          AzBytArr *s) const 
+{
   s->c(model_fn); s->c(dlm); 
-  s->c("#leaf"); s->c(name_dlm); s->cn(info.leaf_num); s->c(dlm); 
-  s->c("#tree"); s->c(name_dlm); s->cn(info.tree_num);
+  s->c("#leaf"); s->c(name_dlm); s->cn(info->leaf_num); s->c(dlm); 
+  s->c("#tree"); s->c(name_dlm); s->cn(info->tree_num); 
 }
 
 /*------------------------------------------------*/
@@ -420,7 +906,7 @@ void AzTETmain::train_predict(const char *argv[], int argc,
   clock_t clocks = 0; 
 
   /*---  read training data  ---*/
-  AzSmat m_tr_x; 
+  AzSmatc m_tr_x; 
   AzDvect v_tr_y, v_fixed_dw; 
   AzSvFeatInfoClone featInfo;  
   AzTimeLog::print("Reading training data ... ", log_out); 
@@ -437,6 +923,9 @@ void AzTETmain::train_predict(const char *argv[], int argc,
 
   /*---  select algorithm  ---*/
   AzTETrainer *trainer = alg_sel->select(s_alg_name.c_str()); 
+  int tr_num = m_tr_x.colNum(); 
+  trainer->reset_packed_data(&m_tr_x); 
+  AzSmat m_none; /* the trainer takes the data set above instead */
 
   /*---  read test data  ---*/
   AzSmat m_test_x; 
@@ -448,7 +937,7 @@ void AzTETmain::train_predict(const char *argv[], int argc,
   print_config(s_tet_param, log_out); 
 
   AzBytArr s; 
-  s.c("#train=");  s.cn(m_tr_x.colNum()); 
+  s.c("#train=");  s.cn(tr_num); 
   s.c(", #test="); s.cn(m_test_x.colNum()); 
   AzTimeLog::print("Start train_predict ... ", s.c_str(), log_out); 
   print_hline(log_out); 
@@ -456,14 +945,14 @@ void AzTETmain::train_predict(const char *argv[], int argc,
   clock_t b_clk = clock(); 
   if (do2) {
     AzTETproc::train_predict2(log_out, trainer, s_tet_param.c_str(), 
-                           &m_tr_x, &v_tr_y, &featInfo, 
+                           &m_none, &v_tr_y, &featInfo, 
                            doSaveLastModelOnly, 
                            &m_test_x, s_model_stem.c_str(),
                            pred_fn_suffix, info_fn_suffix, &v_fixed_dw, prev_ens_ptr);
   }
   else {
     AzTETproc::train_predict(log_out, trainer, s_tet_param.c_str(), 
-                           &m_tr_x, &v_tr_y, &featInfo, 
+                           &m_none, &v_tr_y, &featInfo, 
                            doSaveLastModelOnly, 
                            &m_test_x, s_model_stem.c_str(),
                            pred_fn_suffix, info_fn_suffix, &v_fixed_dw, prev_ens_ptr); 
@@ -503,6 +992,7 @@ bool AzTETmain::resetParam_train(const char *argv[], int argc,
   p.vStr(kw_alg_name, &s_alg_name); 
   p.vStr(kw_train_x_fn, &s_train_x_fn); 
   p.vStr(kw_train_y_fn, &s_train_y_fn); 
+  p.vStr(kw_x_bin_fn, &s_x_bin_fn); 
   p.vStr(kw_fdic_fn, &s_fdic_fn); 
   p.vStr(kw_dw_fn, &s_dw_fn); 
   if (for_train_test) {
@@ -512,6 +1002,16 @@ bool AzTETmain::resetParam_train(const char *argv[], int argc,
     p.swOn(&doAppend_eval, kw_doAppend_eval); 
     p.swOn(&doSaveLastModelOnly, kw_doSaveLastModelOnly); 
   }
+  else {
+    p.vStr(kw_valid_x_fn, &s_valid_x_fn); 
+    p.vStr(kw_valid_y_fn, &s_valid_y_fn); 
+    p.vStr(kw_valid_metric, &s_valid_metric); 
+    p.vInt(kw_valid_patience, &valid_patience); 
+    p.vStr(kw_checkpoint_fn, &s_checkpoint_fn); 
+    p.vInt(kw_class_num, &class_num); 
+    p.vInt(kw_class_threads, &class_threads); 
+    p.swOn(&doCompact, kw_doCompact); 
+  }
 
   p.vStr(kw_model_stem, &s_model_stem); 
   p.vStr(kw_model_names_fn, &s_model_names_fn); 
@@ -541,8 +1041,13 @@ void AzTETmain::printParam_train(const AzOut &out,
     o.ppBegin("AzTETmain::train", "\"train\""); 
   }
   o.printV(kw_alg_name, s_alg_name); 
-  o.printV(kw_train_x_fn, s_train_x_fn); 
-  o.printV(kw_train_y_fn, s_train_y_fn); 
+  if (s_x_bin_fn.length() > 0) {
+    o.printV(kw_x_bin_fn, s_x_bin_fn); 
+  }
+  else {
+    o.printV(kw_train_x_fn, s_train_x_fn); 
+    o.printV(kw_train_y_fn, s_train_y_fn); 
+  }
   o.printV_if_not_empty(kw_fdic_fn, s_fdic_fn); 
   o.printV_if_not_empty(kw_dw_fn, s_dw_fn); 
   o.printSw(kw_doLog, doLog); 
@@ -561,6 +1066,20 @@ void AzTETmain::printParam_train(const AzOut &out,
       o.printSw(kw_doSaveLastModelOnly, doSaveLastModelOnly); 
     }
   }
+  else if (s_valid_x_fn.length() > 0) {
+    o.printV(kw_valid_x_fn, s_valid_x_fn); 
+    o.printV(kw_valid_y_fn, s_valid_y_fn); 
+    o.printV(kw_valid_metric, s_valid_metric); 
+    o.printV(kw_valid_patience, valid_patience); 
+  }
+  if (!for_train_test) {
+    o.printV_if_not_empty(kw_checkpoint_fn, s_checkpoint_fn); 
+    o.printSw(kw_doCompact, doCompact); 
+    if (class_num > 0) {
+      o.printV(kw_class_num, class_num); 
+      if (class_threads != 1) o.printV(kw_class_threads, AzThreads::resolve(class_threads)); 
+    }
+  }
   o.printV_if_not_empty(kw_model_stem, s_model_stem); 
   o.printV_if_not_empty(kw_model_names_fn, s_model_names_fn); 
   o.printV_if_not_empty(kw_prev_model_fn, s_prev_model_fn); 
@@ -572,15 +1091,75 @@ void AzTETmain::printParam_train(const AzOut &out,
 void AzTETmain::checkParam_train(bool for_train_test) const
 {
   const char *eyec = "AzTETmain::checkParam_train"; 
-  throw_if_missing(kw_train_x_fn, s_train_x_fn, eyec); 
-  throw_if_missing(kw_train_y_fn, s_train_y_fn, eyec); 
+  if (s_x_bin_fn.length() > 0) {
+    if (s_train_x_fn.length() > 0 || s_train_y_fn.length() > 0 || s_fdic_fn.length() > 0) {
+      AzBytArr s("Specify either "); s.c(kw_x_bin_fn); s.c(" or "); 
+      s.c(kw_train_x_fn); s.c(", "); s.c(kw_train_y_fn); s.c(", "); s.c(kw_fdic_fn); 
+      s.c(" but not both."); 
+      throw new AzException(AzInputNotValid, eyec, s.c_str()); 
+    }
+  }
+  else {
+    throw_if_missing(kw_train_x_fn, s_train_x_fn, eyec); 
+    throw_if_missing(kw_train_y_fn, s_train_y_fn, eyec); 
+  }
   if (for_train_test) {
     throw_if_missing(kw_test_x_fn, s_test_x_fn, eyec); 
     throw_if_missing(kw_test_y_fn, s_test_y_fn, eyec); 
   }
   else {
     throw_if_missing(kw_model_stem, s_model_stem, eyec); 
+    if (s_valid_x_fn.length() > 0 || s_valid_y_fn.length() > 0) {
+      throw_if_missing(kw_valid_x_fn, s_valid_x_fn, eyec); 
+      throw_if_missing(kw_valid_y_fn, s_valid_y_fn, eyec); 
+      validPerfType(); 
+      if (valid_patience < 0) {
+        throw new AzException(AzInputNotValid, eyec, kw_valid_patience, "must be non-negative"); 
+      }
+      if (s_checkpoint_fn.length() > 0) {
+        AzBytArr s(kw_checkpoint_fn); s.c(" cannot be used with "); s.c(kw_valid_x_fn); 
+        throw new AzException(AzInputNotValid, eyec, s.c_str()); 
+      }
+    }
+    if (s_checkpoint_fn.length() > 0) {
+      /*---  fail before reading data rather than at the first check point  ---*/
+      const AzTETrainer *trainer = alg_sel->select(s_alg_name.c_str(), true); 
+      if (trainer != NULL && !trainer->canCheckpoint()) {
+        AzBytArr s(kw_checkpoint_fn); s.c(" cannot be used with "); 
+        s.c(kw_alg_name); s.c(s_alg_name.c_str()); 
+        throw new AzException(AzInputNotValid, eyec, s.c_str()); 
+      }
+    }
+    if (class_num != 0) {
+      if (class_num < 2) {
+        throw new AzException(AzInputNotValid, eyec, kw_class_num, "must be 2 or larger"); 
+      }
+      if (class_threads < 0) {
+        throw new AzException(AzInputNotValid, eyec, kw_class_threads, "must be non-negative"); 
+      }
+      const char *kw = NULL; 
+      if      (s_valid_x_fn.length() > 0)    kw = kw_valid_x_fn; 
+      else if (s_checkpoint_fn.length() > 0) kw = kw_checkpoint_fn; 
+      else if (s_prev_model_fn.length() > 0) kw = kw_prev_model_fn; 
+      if (kw != NULL) {
+        AzBytArr s(kw); s.c(" cannot be used with "); s.c(kw_class_num); 
+        throw new AzException(AzInputNotValid, eyec, s.c_str()); 
+      }
+    }
+  }
+}
+
+/*------------------------------------------------*/
+AzPerfType AzTETmain::validPerfType() const
+{
+  int px; 
+  for (px = 0; px < AzPerfType_Num; ++px) {
+    if (s_valid_metric.compare(AzPerfResult::getPerfStr((AzPerfType)px)) == 0) {
+      return (AzPerfType)px; 
+    }
   }
+  throw new AzException(AzInputNotValid, "AzTETmain::validPerfType", kw_valid_metric, 
+                        "must be \"loss\", \"rmse\", or \"acc\"."); 
 }
 
 /*------------------------------------------------*/
@@ -679,6 +1258,12 @@ const
   else if (s_action.compare(kw_train_test) == 0)    s_desc.c(help_train_test); 
   else if (s_action.compare(kw_predict) == 0)       s_desc.c(help_predict); 
   else if (s_action.compare(kw_batch_predict) == 0) s_desc.c(help_batch_predict); 
+  else if (s_action.compare(kw_prepare_data) == 0)  s_desc.c(help_prepare_data); 
+  else if (s_action.compare(kw_sweep) == 0)         s_desc.c(help_sweep); 
+  else if (s_action.compare(kw_xv) == 0)            s_desc.c(help_xv); 
+  else if (s_action.compare(kw_pack_model) == 0)    s_desc.c(help_pack_model); 
+  else if (s_action.compare(kw_compact_model) == 0) s_desc.c(help_compact_model); 
+  else if (s_action.compare(kw_compile_model) == 0) s_desc.c(help_compile_model); 
   if (s_desc.length() > 0) {
     h.item(s_kw.c_str(), s_desc.c_str()); 
   }
@@ -690,7 +1275,25 @@ const
   h.writeln_header("  Example parameters:"); 
   s.reset(); 
   s.c("    "); 
-  if (s_action.beginsWith("train")) {  
+  if (s_action.compare(kw_prepare_data) == 0) {
+    s.c("train_x_fn=data.x,train_y_fn=data.y,x_bin_fn=data.bin"); 
+  }
+  else if (s_action.compare(kw_sweep) == 0) {
+    s.c("train_x_fn=data.x,train_y_fn=data.y,test_x_fn=test.x,test_y_fn=test.y,sweep_fn=params.txt,evaluation_fn=sweep.csv,..."); 
+  }
+  else if (s_action.compare(kw_xv) == 0) {
+    s.c("train_x_fn=data.x,train_y_fn=data.y,xv_fn=xv.txt,num_xv=5,ShuffleData,..."); 
+  }
+  else if (s_action.compare(kw_pack_model) == 0) {
+    s.c("model_fn=output/m-05,packed_model_fn=output/m-05.packed"); 
+  }
+  else if (s_action.compare(kw_compact_model) == 0) {
+    s.c("model_fn=output/m-05,compact_model_fn=output/m-05.compact"); 
+  }
+  else if (s_action.compare(kw_compile_model) == 0) {
+    s.c("model_fn=output/m-05,code_fn_prefix=output/m05,code_name=m05,test_x_fn=test.x"); 
+  }
+  else if (s_action.beginsWith("train")) {  
     const char *dflt_name = alg_sel->dflt_name(); 
     s.c("algorithm="); s.c(dflt_name); s.c(",train_x_fn=data.x,train_y_fn=data.y,"); 
     if (alg_sel->isRGFfamily(dflt_name)) {
@@ -738,6 +1341,7 @@ void AzTETmain::printHelp_train(const AzOut &out,
   h.item_required(kw_train_x_fn, help_train_x_fn); 
   h.item_required(kw_train_y_fn, help_train_y_fn);
   h.item_experimental(kw_fdic_fn, help_fdic_fn); 
+  h.item(kw_x_bin_fn, help_x_bin_fn_train); 
   if (for_train_test) {
     h.item_required(kw_test_x_fn, help_test_x_fn); 
     h.item_required(kw_test_y_fn, help_test_y_fn); 
@@ -758,6 +1362,22 @@ void AzTETmain::printHelp_train(const AzOut &out,
   else {
     h.item_required(kw_model_stem, help_model_stem, dflt_model_stem);
     h.item_experimental(kw_model_names_fn, help_model_names_fn_out); 
+    h.item(kw_doCompact, help_doCompact); 
+
+    h.nl(); 
+    h.writeln_header("To optionally stop training early with validation data:"); 
+    h.item(kw_valid_x_fn, help_valid_x_fn); 
+    h.item(kw_valid_y_fn, help_valid_y_fn); 
+    h.item(kw_valid_metric, help_valid_metric, dflt_valid_metric); 
+    h.item(kw_valid_patience, help_valid_patience, dflt_valid_patience); 
+
+    h.nl(); 
+    h.writeln_header("To optionally resume training after an interruption:"); 
+    h.item(kw_checkpoint_fn, help_checkpoint_fn); 
+    h.nl(); 
+    h.writeln_header("To optionally train one-vs-rest for multi-class classification:"); 
+    h.item(kw_class_num, help_class_num); 
+    h.item(kw_class_threads, help_class_threads, 1); 
   }
 
   h.nl(); 
@@ -844,7 +1464,9 @@ bool AzTETmain::resetParam_batch_predict(const char *argv[], int argc)
 
   p.vStr(kw_model_names_fn, &s_model_names_fn); 
   p.vStr(kw_test_x_fn, &s_test_x_fn); 
+  p.vStr(kw_x_bin_fn, &s_x_bin_fn); 
   p.vStr(kw_pred_fn_suffix, &s_pred_fn_suffix); 
+  p.vInt(kw_num_threads, &num_threads); 
 
   p.vStr(kw_test_y_fn, &s_test_y_fn); 
   p.vStr(kw_eval_fn, &s_eval_fn); 
@@ -866,8 +1488,10 @@ void AzTETmain::printParam_batch_predict(const AzOut &out) const
 
   o.ppBegin("AzTETmain::predict", "\"batch_predict\""); 
   o.printV(kw_model_names_fn, s_model_names_fn); 
-  o.printV(kw_test_x_fn, s_test_x_fn); 
+  if (s_x_bin_fn.length() > 0) o.printV(kw_x_bin_fn, s_x_bin_fn); 
+  else                         o.printV(kw_test_x_fn, s_test_x_fn); 
   o.printV(kw_pred_fn_suffix, s_pred_fn_suffix); 
+  if (num_threads != 1) o.printV(kw_num_threads, AzThreads::resolve(num_threads)); 
 
   o.printV_if_not_empty(kw_test_y_fn, s_test_y_fn);
   o.printV_if_not_empty(kw_eval_fn, s_eval_fn); 
@@ -891,7 +1515,9 @@ void AzTETmain::printHelp_batch_predict(const AzOut &out,
   h.begin("batch_predict", "AzTETmain"); 
   h.item_required(kw_model_names_fn, help_model_names_fn_inp); 
   h.item_required(kw_test_x_fn, help_test_x_fn); 
+  h.item(kw_x_bin_fn, help_x_bin_fn_test); 
   h.item_required(kw_pred_fn_suffix, help_pred_fn_suffix); 
+  h.item(kw_num_threads, help_num_threads, 1); 
 
   h.nl(); 
   h.writeln_header("To optionally evaluate the prediction values: "); 
@@ -908,7 +1534,10 @@ void AzTETmain::printHelp_batch_predict(const AzOut &out,
 void AzTETmain::checkParam_batch_predict() const
 {
   const char *eyec = "AzTETmain::checkParam_batch_predict"; 
-  throw_if_missing(kw_test_x_fn, s_test_x_fn, eyec); 
+  checkParam_test_x(eyec); 
+  if (num_threads < 0) {
+    throw new AzException(AzInputNotValid, eyec, kw_num_threads, "must be non-negative"); 
+  }
   throw_if_missing(kw_model_names_fn, s_model_names_fn, eyec); 
   throw_if_missing(kw_pred_fn_suffix, s_pred_fn_suffix, eyec); 
 
@@ -940,7 +1569,14 @@ bool AzTETmain::resetParam_predict_single(const char *argv[], int argc)
 
   p.vStr(kw_model_fn, &s_model_fn); 
   p.vStr(kw_test_x_fn, &s_test_x_fn); 
+  p.vStr(kw_x_bin_fn, &s_x_bin_fn); 
   p.vStr(kw_pred_fn, &s_pred_fn); 
+  p.vInt(kw_num_threads, &num_threads); 
+  p.vInt(kw_stream_chunk, &stream_chunk); 
+  if (stream_chunk == 0 && 
+      (AzFile::isStdio(s_test_x_fn.c_str()) || AzFile::isStdio(s_pred_fn.c_str()))) {
+    stream_chunk = dflt_stream_chunk; 
+  }
 
   p.vStr(kw_test_y_fn, &s_test_y_fn); 
   p.vStr(kw_eval_fn, &s_eval_fn); 
@@ -961,8 +1597,11 @@ void AzTETmain::printParam_predict_single(const AzOut &out) const
 
   o.ppBegin("AzTETmain::predict", "\"predict\""); 
   o.printV(kw_model_fn, s_model_fn); 
-  o.printV(kw_test_x_fn, s_test_x_fn); 
+  if (s_x_bin_fn.length() > 0) o.printV(kw_x_bin_fn, s_x_bin_fn); 
+  else                         o.printV(kw_test_x_fn, s_test_x_fn); 
   o.printV(kw_pred_fn, s_pred_fn);  
+  if (num_threads != 1) o.printV(kw_num_threads, AzThreads::resolve(num_threads)); 
+  if (stream_chunk > 0) o.printV(kw_stream_chunk, stream_chunk); 
 
   o.printV_if_not_empty(kw_test_y_fn, s_test_y_fn);
   o.printV_if_not_empty(kw_eval_fn, s_eval_fn); 
@@ -984,7 +1623,10 @@ void AzTETmain::printHelp_predict_single(const AzOut &out,
   h.begin("predict (single)", "AzTETmain"); 
   h.item_required(kw_model_fn, help_model_fn); 
   h.item_required(kw_test_x_fn, help_test_x_fn); 
+  h.item(kw_x_bin_fn, help_x_bin_fn_test); 
   h.item_required(kw_pred_fn, help_pred_fn_out); 
+  h.item(kw_num_threads, help_num_threads, 1); 
+  h.item(kw_stream_chunk, help_stream_chunk, 0); 
 
   h.nl(); 
   h.writeln_header_experimental("To optionally evaluate the prediction values: "); 
@@ -1002,7 +1644,23 @@ void AzTETmain::printHelp_predict_single(const AzOut &out,
 void AzTETmain::checkParam_predict_single() const
 {
   const char *eyec = "AzTETmain::checkParam_predict_single"; 
-  throw_if_missing(kw_test_x_fn, s_test_x_fn, eyec); 
+  checkParam_test_x(eyec); 
+  if (num_threads < 0) {
+    throw new AzException(AzInputNotValid, eyec, kw_num_threads, "must be non-negative"); 
+  }
+  if (stream_chunk < 0) {
+    throw new AzException(AzInputNotValid, eyec, kw_stream_chunk, "must be non-negative"); 
+  }
+  if (stream_chunk > 0) {
+    if (s_x_bin_fn.length() > 0) {
+      throw new AzException(AzInputNotValid, eyec, kw_x_bin_fn, 
+            "cannot be used in the streaming mode.  Use test_x_fn."); 
+    }
+    if (s_test_y_fn.length() > 0) {
+      throw new AzException(AzInputNotValid, eyec, kw_test_y_fn, 
+            "Evaluation is not supported in the streaming mode."); 
+    }
+  }
   throw_if_missing(kw_model_fn, s_model_fn, eyec); 
   throw_if_missing(kw_pred_fn, s_pred_fn, eyec); 
   if (s_model_fn.compare(&s_pred_fn) == 0) {
@@ -1018,6 +1676,21 @@ void AzTETmain::checkParam_predict_single() const
   }
 }
 
+/*------------------------------------------------*/
+void AzTETmain::checkParam_test_x(const char *eyec) const
+{
+  if (s_x_bin_fn.length() > 0) {
+    if (s_test_x_fn.length() > 0) {
+      AzBytArr s("Specify either "); s.c(kw_x_bin_fn); s.c(" or "); 
+      s.c(kw_test_x_fn); s.c(" but not both."); 
+      throw new AzException(AzInputNotValid, eyec, s.c_str()); 
+    }
+  }
+  else {
+    throw_if_missing(kw_test_x_fn, s_test_x_fn, eyec); 
+  }
+}
+
 /*------------------------------------------------*/
 /*------------------------------------------------*/
 bool AzTETmain::resetParam_xv(const char *argv[], int argc)
@@ -1043,6 +1716,7 @@ bool AzTETmain::resetParam_xv(const char *argv[], int argc)
   p.swOn(&xv_doShuffle, kw_xv_doShuffle); 
   p.vInt(kw_xv_num, &xv_num); 
   p.vStr(kw_xv_fn, &s_xv_fn); 
+  p.vInt(kw_xv_threads, &xv_threads); 
 
   p.swOff(&doLog, kw_not_doLog); 
   p.swOn(&doDump, kw_doDump); 
@@ -1070,6 +1744,7 @@ void AzTETmain::printParam_xv(const AzOut &out) const
   o.printSw(kw_xv_doShuffle, xv_doShuffle); 
   o.printV(kw_xv_num, xv_num);
   o.printV(kw_xv_fn, s_xv_fn); 
+  if (xv_threads != 1) o.printV(kw_xv_threads, AzThreads::resolve(xv_threads)); 
   o.printSw(kw_doLog, doLog); 
   o.printSw(kw_doDump, doDump); 
 
@@ -1083,6 +1758,38 @@ void AzTETmain::checkParam_xv() const
   throw_if_missing(kw_train_x_fn, s_train_x_fn, eyec); 
   throw_if_missing(kw_train_y_fn, s_train_y_fn, eyec); 
   throw_if_missing(kw_xv_fn, s_xv_fn, eyec); 
+  if (xv_num < 2) {
+    throw new AzException(AzInputNotValid, eyec, kw_xv_num, "must be 2 or larger"); 
+  }
+  if (xv_threads < 0) {
+    throw new AzException(AzInputNotValid, eyec, kw_xv_threads, "must be non-negative"); 
+  }
+}
+
+/*------------------------------------------------*/
+void AzTETmain::printHelp_xv(const AzOut &out, 
+                const char *argv[], int argc) const
+{
+  print_usage(out, argv, argc); 
+
+  AzBytArr s_alg_options; 
+  alg_sel->printOptions("|", &s_alg_options); 
+
+  AzHelp h(out); 
+  h.item(kw_alg_name, s_alg_options.c_str(), s_alg_name.c_str()); 
+  h.item_required(kw_train_x_fn, help_train_x_fn); 
+  h.item_required(kw_train_y_fn, help_train_y_fn); 
+  h.item_experimental(kw_fdic_fn, help_fdic_fn); 
+  h.item(kw_dw_fn, help_dw_fn); 
+  h.item_required(kw_xv_fn, help_xv_fn); 
+  h.item(kw_xv_num, help_xv_num, xv_num); 
+  h.item(kw_xv_doShuffle, help_xv_doShuffle); 
+  h.item(kw_xv_threads, help_xv_threads, 1); 
+  h.item_experimental(kw_not_doLog, help_not_doLog); 
+  h.item_experimental(kw_doDump, help_doDump); 
+  h.nl(); 
+  h.writeln_header("Other parameters are passed to the algorithm.  To display them, enter \"train_test\" instead of \"xv\"."); 
+  h.end(); 
 }
 
 /*------------------------------------------------*/
@@ -1186,4 +1893,919 @@ void AzTETmain::printHelp_features(const AzOut &out,
   h.item(kw_features_digits, help_features_digits); 
   h.item(kw_doSparse_features, help_doSparse_features); 
   h.end(); 
-}
\ No newline at end of file
+}
+
+/*------------------------------------------------------*/
+/*------------------------------------------------------*/
+/*  write data in the binary format for x_bin_fn=       */
+/*------------------------------------------------------*/
+void AzTETmain::prepare_data(const char *argv[], int argc)
+{
+  bool success = resetParam_prepare_data(argv, argc); 
+  if (!success) return; 
+
+  prepareLogDmp(doLog, doDump); 
+
+  printParam_prepare_data(log_out); 
+  print_hline(log_out); 
+  checkParam_prepare_data(); 
+
+  AzDvect v_y, v_dw; 
+  AzSmatc m_x; 
+  AzSvFeatInfoClone featInfo; 
+  AzTimeLog::print("Reading data ... ", log_out); 
+  readData(s_train_x_fn.c_str(), s_train_y_fn.c_str(), s_fdic_fn.c_str(), 
+           &m_x, &v_y, &featInfo); 
+  readDataWeights(s_dw_fn, m_x.colNum(), &v_dw); 
+  if (s_train_y_fn.length() <= 0) v_y.reform(0); /* test data */
+
+  AzTimeLog::print("Sorting and writing data ... ", log_out); 
+  AzParam p(s_tet_param.c_str()); 
+  AzDataCache::write(s_x_bin_fn.c_str(), log_out, 
+                     &m_x, &v_y, &v_dw, &featInfo, p); 
+  p.check(log_out); 
+  AzTimeLog::print("Done ... ", log_out); 
+}
+
+/*------------------------------------------------*/
+bool AzTETmain::resetParam_prepare_data(const char *argv[], int argc)
+{
+  if (argc-config_argx != 1) {
+    printHelp_prepare_data(log_out, argv, argc); 
+    return false; /* failed */
+  }
+
+  const char *param = argv[config_argx]; 
+  if (isHelpNeeded(param)) {
+    printHelp_prepare_data(log_out, argv, argc); 
+    return false; /* failed */    
+  }
+
+  AzParam p(param); 
+  p.vStr(kw_train_x_fn, &s_train_x_fn); 
+  p.vStr(kw_train_y_fn, &s_train_y_fn); 
+  p.vStr(kw_fdic_fn, &s_fdic_fn); 
+  p.vStr(kw_dw_fn, &s_dw_fn); 
+  p.vStr(kw_x_bin_fn, &s_x_bin_fn); 
+  p.swOff(&doLog, kw_not_doLog); 
+  p.swOn(&doDump, kw_doDump); 
+
+  /*---  separate unused parameters to pass to AzDataForTrTree  ---*/
+  s_tet_param.reset(); 
+  p.check(log_out, &s_tet_param); 
+
+  return true; /* success */
+}
+
+/*------------------------------------------------*/
+void AzTETmain::printParam_prepare_data(const AzOut &out) const
+{
+  if (out.isNull()) return; 
+  AzPrint o(out); 
+  o.ppBegin("AzTETmain::prepare_data", "\"prepare_data\""); 
+  o.printV(kw_train_x_fn, s_train_x_fn); 
+  o.printV_if_not_empty(kw_train_y_fn, s_train_y_fn); 
+  o.printV_if_not_empty(kw_fdic_fn, s_fdic_fn); 
+  o.printV_if_not_empty(kw_dw_fn, s_dw_fn); 
+  o.printV(kw_x_bin_fn, s_x_bin_fn); 
+  o.printSw(kw_doLog, doLog); 
+  o.printSw(kw_doDump, doDump); 
+  o.ppEnd(); 
+}
+
+/*------------------------------------------------*/
+void AzTETmain::checkParam_prepare_data() const
+{
+  const char *eyec = "AzTETmain::checkParam_prepare_data"; 
+  throw_if_missing(kw_train_x_fn, s_train_x_fn, eyec); 
+  throw_if_missing(kw_x_bin_fn, s_x_bin_fn, eyec); 
+}
+
+/*------------------------------------------------*/
+void AzTETmain::printHelp_prepare_data(const AzOut &out, 
+                const char *argv[], int argc) const
+{
+  print_usage(out, argv, argc); 
+  AzHelp h(out); 
+  h.begin("prepare_data", "AzTETmain"); 
+  h.item_required(kw_train_x_fn, help_train_x_fn); 
+  h.item(kw_train_y_fn, "Path to the target file.  Required if the data is for training."); 
+  h.item_experimental(kw_fdic_fn, help_fdic_fn); 
+  h.item(kw_dw_fn, help_dw_fn); 
+  h.item_required(kw_x_bin_fn, help_x_bin_fn_out); 
+  h.item(kw_dataproc, "Sparse|Dense|Auto.  How the data should be managed in training.  Training with data_management=Hist can also use the data."); 
+  h.item_experimental(kw_not_doLog, help_not_doLog); 
+  h.item_experimental(kw_doDump, help_doDump); 
+  h.end(); 
+}
+
+/*------------------------------------------------*/
+/*------------------------------------------------*/
+/*  load models once and score data points sent   */
+/*  over stdin or a Unix domain socket            */
+/*------------------------------------------------*/
+void AzTETmain::serve(const char *argv[], int argc)
+{
+  bool success = resetParam_serve(argv, argc); 
+  if (!success) return; 
+
+  prepareLogDmp(doLog, doDump); 
+  if (s_socket_fn.length() <= 0 && !log_out.isNull()) {
+    log_out.setStderr(); /* stdout is for predictions */
+  }
+
+  printParam_serve(log_out); 
+  print_hline(log_out); 
+  checkParam_serve(); 
+
+  AzStrPool sp_model_fn; 
+  if (s_model_fn.length() > 0) sp_model_fn.put(&s_model_fn); 
+  else                         AzTools::readList(s_model_names_fn.c_str(), &sp_model_fn); 
+
+  AzTimeLog::print("Reading models ... ", log_out); 
+  AzTETserver server; 
+  server.reset(&sp_model_fn, serve_batch, num_threads, log_out); 
+  if (s_socket_fn.length() > 0) server.serve_socket(s_socket_fn.c_str(), serve_timeout, log_out); 
+  else                          server.serve_stdio(log_out); 
+  AzTimeLog::print("Done ... ", log_out); 
+}
+
+/*------------------------------------------------*/
+bool AzTETmain::resetParam_serve(const char *argv[], int argc)
+{
+  if (argc-config_argx != 1) {
+    printHelp_serve(log_out, argv, argc); 
+    return false; /* failed */
+  }
+
+  const char *param = argv[config_argx]; 
+  if (isHelpNeeded(param)) {
+    printHelp_serve(log_out, argv, argc); 
+    return false; /* failed */    
+  }
+
+  AzParam p(param); 
+  p.vStr(kw_model_fn, &s_model_fn); 
+  p.vStr(kw_model_names_fn, &s_model_names_fn); 
+  p.vStr(kw_serve_socket, &s_socket_fn); 
+  p.vInt(kw_serve_batch, &serve_batch); 
+  p.vInt(kw_serve_timeout, &serve_timeout); 
+  p.vInt(kw_num_threads, &num_threads); 
+  p.swOff(&doLog, kw_not_doLog); 
+  p.swOn(&doDump, kw_doDump); 
+  p.check(log_out); 
+
+  return true; /* success */
+}
+
+/*------------------------------------------------*/
+void AzTETmain::printParam_serve(const AzOut &out) const
+{
+  if (out.isNull()) return; 
+  AzPrint o(out); 
+  o.ppBegin("AzTETmain::serve", "\"serve\""); 
+  o.printV_if_not_empty(kw_model_fn, s_model_fn); 
+  o.printV_if_not_empty(kw_model_names_fn, s_model_names_fn); 
+  o.printV_if_not_empty(kw_serve_socket, s_socket_fn); 
+  o.printV(kw_serve_batch, serve_batch); 
+  if (s_socket_fn.length() > 0) o.printV(kw_serve_timeout, serve_timeout); 
+  if (num_threads != 1) o.printV(kw_num_threads, AzThreads::resolve(num_threads)); 
+  o.printSw(kw_doLog, doLog); 
+  o.printSw(kw_doDump, doDump); 
+  o.ppEnd(); 
+}
+
+/*------------------------------------------------*/
+void AzTETmain::checkParam_serve() const
+{
+  const char *eyec = "AzTETmain::checkParam_serve"; 
+  if (s_model_fn.length() > 0 && s_model_names_fn.length() > 0 || 
+      s_model_fn.length() <= 0 && s_model_names_fn.length() <= 0) {
+    AzBytArr s("Specify either "); s.c(kw_model_fn); s.c(" or "); 
+    s.c(kw_model_names_fn); s.c("."); 
+    throw new AzException(AzInputNotValid, eyec, s.c_str()); 
+  }
+  if (serve_batch <= 0) {
+    throw new AzException(AzInputNotValid, eyec, kw_serve_batch, "must be positive"); 
+  }
+  if (serve_timeout < 0) {
+    throw new AzException(AzInputNotValid, eyec, kw_serve_timeout, "must be non-negative"); 
+  }
+  if (num_threads < 0) {
+    throw new AzException(AzInputNotValid, eyec, kw_num_threads, "must be non-negative"); 
+  }
+}
+
+/*------------------------------------------------*/
+void AzTETmain::printHelp_serve(const AzOut &out, 
+                const char *argv[], int argc) const
+{
+  print_usage(out, argv, argc); 
+  AzHelp h(out); 
+  h.begin("serve", "AzTETmain"); 
+  h.item(kw_model_fn, "Path to the model file.  Specify either this or model_names_fn."); 
+  h.item(kw_model_names_fn, "Path to the file to read model path names from.  The predictions of the models are returned in this order, separated by a space."); 
+  h.item(kw_serve_socket, help_serve_socket); 
+  h.item(kw_serve_batch, help_serve_batch, dflt_serve_batch); 
+  h.item(kw_serve_timeout, help_serve_timeout, dflt_serve_timeout); 
+  h.item(kw_num_threads, help_num_threads, 1); 
+  h.item_experimental(kw_not_doLog, help_not_doLog); 
+  h.item_experimental(kw_doDump, help_doDump); 
+  h.nl(); 
+  h.writeln_header("Send one data point per line in the dense format (\"val val ...\") or the sparse format (\"fx:val fx:val ...\"); one line of predictions, or \"error: ...\", is returned for each.  \"#quit\" closes the connection and \"#shutdown\" stops the server."); 
+  h.end(); 
+}
+
+/*------------------------------------------------*/
+/*------------------------------------------------*/
+/*  train with several parameter sets on the data */
+/*  read and sorted only once                     */
+/*------------------------------------------------*/
+void AzTETmain::sweep(const char *argv[], int argc)
+{
+  const char *eyec = "AzTETmain::sweep"; 
+  bool success = resetParam_sweep(argv, argc); 
+  if (!success) return; 
+
+  prepareLogDmp(doLog, doDump); 
+
+  printParam_sweep(log_out); 
+  print_hline(log_out); 
+  checkParam_sweep(); 
+
+  /*---  read parameter sets  ---*/
+  AzStrPool sp_line, sp_config; 
+  AzTools::readList(s_sweep_fn.c_str(), &sp_line); 
+  int ix; 
+  for (ix = 0; ix < sp_line.size(); ++ix) {
+    AzBytArr s_line(sp_line.c_str(ix)); 
+    if (s_line.length() <= 0 || *s_line.point() == '#') continue; 
+    AzBytArr s_config; 
+    merge_config(s_tet_param, s_line, &s_config); 
+    sp_config.put(&s_config); 
+  }
+  if (sp_config.size() <= 0) {
+    throw new AzException(AzInputError, eyec, "No parameter set in", s_sweep_fn.c_str()); 
+  }
+
+  alg_sel->select(s_alg_name.c_str()); /* to check the name before reading data */
+
+  /*---  read training data and sort it once for all  ---*/
+  AzDvect v_tr_y, v_fixed_dw; 
+  AzSmatc m_tr_x; 
+  AzSvFeatInfoClone featInfo; 
+  AzDataCache cache; 
+  AzTimeLog::print("Reading training data ... ", log_out); 
+  readTrainingData(&cache, &m_tr_x, &v_tr_y, &v_fixed_dw, &featInfo); 
+  AzDataForTrTree data; 
+  AzParam p(s_tet_param.c_str(), false); /* the rest is for the trainers */
+  bool beTight = false; /* the data is kept until the end */
+  if (s_x_bin_fn.length() > 0) cache.read_data(log_out, p, beTight, &data); 
+  else                         data.reset_data(log_out, &m_tr_x, NULL, p, beTight, &featInfo); 
+  m_tr_x.reset(); 
+
+  /*---  read test data  ---*/
+  AzSmat m_test_x; 
+  AzDvect v_test_y; 
+  AzTimeLog::print("Reading test data ... ", log_out); 
+  readData(s_test_x_fn.c_str(), s_test_y_fn.c_str(), "", 
+           &m_test_x, &v_test_y); 
+
+  int th_num = AzThreads::threadNum(sweep_threads, sp_config.size()); 
+
+  AzBytArr s; 
+  s.c("#param_set="); s.cn(sp_config.size()); 
+  s.c(", #train="); s.cn(v_tr_y.rowNum()); 
+  s.c(", #test="); s.cn(m_test_x.colNum()); 
+  AzTimeLog::print("Start ... ", s.c_str(), log_out); 
+  print_hline(log_out); 
+
+  clock_t b_clk = clock(); 
+  AzTETproc::sweep(log_out, &sp_config, alg_sel, s_alg_name.c_str(), th_num, 
+                   &data, &v_tr_y, &featInfo, &v_fixed_dw, 
+                   &m_test_x, &v_test_y, s_eval_fn.c_str()); 
+  AzTimeLog::print("Done ...", log_out); 
+  show_elapsed(log_out, clock() - b_clk); 
+}
+
+/*------------------------------------------------*/
+/* common parameters followed by one line of the  */
+/* sweep file; the line wins on the same keyword  */
+/*------------------------------------------------*/
+void AzTETmain::merge_config(const AzBytArr &s_common, 
+                             const AzBytArr &s_line, 
+                             AzBytArr *s_config) /* output */
+{
+  const char *eyec = "AzTETmain::merge_config"; 
+  AzStrPool sp_common, sp_line, sp_line_kw; 
+  AzTools::getStrings(s_common.point(), s_common.length(), ',', &sp_common); 
+  AzTools::getStrings(s_line.point(), s_line.length(), ',', &sp_line); 
+  int ix; 
+  for (ix = 0; ix < sp_line.size(); ++ix) {
+    if (sp_line.getLen(ix) <= 0) continue; 
+    const char *str = sp_line.c_str(ix); 
+    const char *eq = strchr(str, '='); 
+    AzBytArr s_kw(str); /* keyword with "=", or an option */
+    if (eq != NULL) s_kw.reset((const AzByte *)str, Az64::ptr_diff(eq-str)+1); 
+    if (s_kw.compare(kw_alg_name) == 0 || 
+        s_kw.compare(kw_dataproc) == 0 || s_kw.compare(kw_max_bin) == 0) {
+      throw new AzException(AzInputNotValid, eyec, s_kw.c_str(), 
+                "applies to all the parameter sets; specify it on the command line."); 
+    }
+    sp_line_kw.put(&s_kw); 
+  }
+  sp_line_kw.commit(); 
+
+  s_config->reset(); 
+  for (ix = 0; ix < sp_common.size(); ++ix) {
+    if (sp_common.getLen(ix) <= 0) continue; 
+    const char *str = sp_common.c_str(ix); 
+    const char *eq = strchr(str, '='); 
+    AzBytArr s_kw(str); 
+    if (eq != NULL) s_kw.reset((const AzByte *)str, Az64::ptr_diff(eq-str)+1); 
+    if (sp_line_kw.find(&s_kw) >= 0) continue; /* overridden by the line */
+    if (s_config->length() > 0) s_config->c(","); 
+    s_config->c(str); 
+  }
+  for (ix = 0; ix < sp_line.size(); ++ix) {
+    if (sp_line.getLen(ix) <= 0) continue; 
+    if (s_config->length() > 0) s_config->c(","); 
+    s_config->c(sp_line.c_str(ix)); 
+  }
+}
+
+/*------------------------------------------------*/
+bool AzTETmain::resetParam_sweep(const char *argv[], int argc)
+{
+  if (argc-config_argx != 1) {
+    printHelp_sweep(log_out, argv, argc); 
+    return false; /* failed */
+  }
+
+  const char *param = argv[config_argx]; 
+  if (isHelpNeeded(param)) {
+    printHelp_sweep(log_out, argv, argc); 
+    return false; /* failed */    
+  }
+
+  AzParam p(param); 
+  p.vStr(kw_alg_name, &s_alg_name); 
+  p.vStr(kw_train_x_fn, &s_train_x_fn); 
+  p.vStr(kw_train_y_fn, &s_train_y_fn); 
+  p.vStr(kw_x_bin_fn, &s_x_bin_fn); 
+  p.vStr(kw_fdic_fn, &s_fdic_fn); 
+  p.vStr(kw_dw_fn, &s_dw_fn); 
+  p.vStr(kw_test_x_fn, &s_test_x_fn); 
+  p.vStr(kw_test_y_fn, &s_test_y_fn); 
+  p.vStr(kw_sweep_fn, &s_sweep_fn); 
+  p.vStr(kw_eval_fn, &s_eval_fn); 
+  p.vInt(kw_sweep_threads, &sweep_threads); 
+  p.swOff(&doLog, kw_not_doLog); 
+  p.swOn(&doDump, kw_doDump); 
+
+  /*---  separate unused parameters to pass to AzDataForTrTree and the trainers  ---*/
+  s_tet_param.reset(); 
+  p.check(log_out, &s_tet_param); 
+
+  return true; /* success */
+}
+
+/*------------------------------------------------*/
+void AzTETmain::printParam_sweep(const AzOut &out) const
+{
+  if (out.isNull()) return; 
+  AzPrint o(out); 
+  o.ppBegin("AzTETmain::sweep", "\"sweep\""); 
+  o.printV(kw_alg_name, s_alg_name); 
+  if (s_x_bin_fn.length() > 0) {
+    o.printV(kw_x_bin_fn, s_x_bin_fn); 
+  }
+  else {
+    o.printV(kw_train_x_fn, s_train_x_fn); 
+    o.printV(kw_train_y_fn, s_train_y_fn); 
+  }
+  o.printV_if_not_empty(kw_fdic_fn, s_fdic_fn); 
+  o.printV_if_not_empty(kw_dw_fn, s_dw_fn); 
+  o.printV(kw_test_x_fn, s_test_x_fn); 
+  o.printV(kw_test_y_fn, s_test_y_fn); 
+  o.printV(kw_sweep_fn, s_sweep_fn); 
+  o.printV(kw_eval_fn, s_eval_fn); 
+  if (sweep_threads != 1) o.printV(kw_sweep_threads, AzThreads::resolve(sweep_threads)); 
+  o.printSw(kw_doLog, doLog); 
+  o.printSw(kw_doDump, doDump); 
+  o.ppEnd(); 
+}
+
+/*------------------------------------------------*/
+void AzTETmain::checkParam_sweep() const
+{
+  const char *eyec = "AzTETmain::checkParam_sweep"; 
+  if (s_x_bin_fn.length() > 0) {
+    if (s_train_x_fn.length() > 0 || s_train_y_fn.length() > 0 || s_fdic_fn.length() > 0) {
+      AzBytArr s("Specify either "); s.c(kw_x_bin_fn); s.c(" or "); 
+      s.c(kw_train_x_fn); s.c(", "); s.c(kw_train_y_fn); s.c(", "); s.c(kw_fdic_fn); 
+      s.c(" but not both."); 
+      throw new AzException(AzInputNotValid, eyec, s.c_str()); 
+    }
+  }
+  else {
+    throw_if_missing(kw_train_x_fn, s_train_x_fn, eyec); 
+    throw_if_missing(kw_train_y_fn, s_train_y_fn, eyec); 
+  }
+  throw_if_missing(kw_test_x_fn, s_test_x_fn, eyec); 
+  throw_if_missing(kw_test_y_fn, s_test_y_fn, eyec); 
+  throw_if_missing(kw_sweep_fn, s_sweep_fn, eyec); 
+  throw_if_missing(kw_eval_fn, s_eval_fn, eyec); 
+  if (sweep_threads < 0) {
+    throw new AzException(AzInputNotValid, eyec, kw_sweep_threads, "must be non-negative"); 
+  }
+}
+
+/*------------------------------------------------*/
+void AzTETmain::printHelp_sweep(const AzOut &out, 
+                const char *argv[], int argc) const
+{
+  print_usage(out, argv, argc); 
+
+  AzBytArr s_alg_options; 
+  alg_sel->printOptions("|", &s_alg_options); 
+
+  AzHelp h(out); 
+  h.item(kw_alg_name, s_alg_options.c_str(), s_alg_name.c_str()); 
+  h.item_required(kw_train_x_fn, help_train_x_fn); 
+  h.item_required(kw_train_y_fn, help_train_y_fn); 
+  h.item_experimental(kw_fdic_fn, help_fdic_fn); 
+  h.item(kw_x_bin_fn, help_x_bin_fn_train); 
+  h.item(kw_dw_fn, help_dw_fn); 
+  h.item_required(kw_test_x_fn, help_test_x_fn); 
+  h.item_required(kw_test_y_fn, help_test_y_fn); 
+  h.item_required(kw_sweep_fn, help_sweep_fn); 
+  h.item_required(kw_eval_fn, help_sweep_eval_fn); 
+  h.item(kw_sweep_threads, help_sweep_threads, 1); 
+  h.item_experimental(kw_not_doLog, help_not_doLog); 
+  h.item_experimental(kw_doDump, help_doDump); 
+  h.nl(); 
+  h.writeln_header("The training data is read and sorted once with data_management= etc. on the command line; this and algorithm= cannot be changed by the parameter sets.  Other parameters on the command line are passed to the algorithm.  To display them, enter \"train_test\" instead of \"sweep\"."); 
+  h.end(); 
+}
+
+/*------------------------------------------------*/
+/*------------------------------------------------*/
+/*  write a model in the packed format, which     */
+/*  predict etc. map into memory without parsing  */
+/*------------------------------------------------*/
+void AzTETmain::pack_model(const char *argv[], int argc)
+{
+  bool success = resetParam_pack_model(argv, argc); 
+  if (!success) return; 
+
+  prepareLogDmp(doLog, doDump); 
+
+  printParam_pack_model(log_out); 
+  print_hline(log_out); 
+  checkParam_pack_model(); 
+
+  const char *eyec = "AzTETmain::pack_model"; 
+  const char *model_fn = s_model_fn.c_str(); 
+  if (AzTreeEnsembleFlat::isPacked(model_fn)) {
+    throw new AzException(AzInputNotValid, eyec, "Already packed: ", model_fn); 
+  }
+  AzTreeEnsembleMulti multi; 
+  AzTreeEnsemble ens; 
+  AzBaseArray<const AzTreeEnsemble *> a_ens; 
+  const AzTreeEnsemble **ens_ptr = NULL; 
+  int ens_num = 1; 
+  if (AzTreeEnsembleMulti::isMultiOutput(model_fn)) {
+    multi.read(model_fn); 
+    ens_num = multi.outNum(); 
+    a_ens.alloc(&ens_ptr, ens_num, eyec, "ens"); 
+    int ox; 
+    for (ox = 0; ox < ens_num; ++ox) ens_ptr[ox] = multi.ens(ox); 
+  }
+  else {
+    ens.read(model_fn); 
+    a_ens.alloc(&ens_ptr, ens_num, eyec, "ens"); 
+    ens_ptr[0] = &ens; 
+  }
+
+  AzTreeEnsembleFlat flat(ens_ptr, ens_num); 
+  flat.write(s_packed_model_fn.c_str()); 
+
+  if (!log_out.isNull()) {
+    AzTE_ModelInfo info; 
+    flat.info(&info); 
+    AzBytArr s(s_packed_model_fn.c_str()); s.c(": "); 
+    s.c("#output="); s.cn(flat.outNum()); 
+    s.c(", #tree="); s.cn(info.tree_num); 
+    s.c(", #distinct tree="); s.cn(flat.treeNum()); 
+    s.c(", #node="); s.cn(flat.nodeNum()); 
+    AzPrint::writeln(log_out, s); 
+  }
+  AzTimeLog::print("Done ...", log_out); 
+}
+
+/*------------------------------------------------*/
+bool AzTETmain::resetParam_pack_model(const char *argv[], int argc)
+{
+  if (argc-config_argx != 1) {
+    printHelp_pack_model(log_out, argv, argc); 
+    return false; /* failed */
+  }
+
+  const char *param = argv[config_argx]; 
+  if (isHelpNeeded(param)) {
+    printHelp_pack_model(log_out, argv, argc); 
+    return false; /* failed */    
+  }
+
+  AzParam p(param); 
+  p.vStr(kw_model_fn, &s_model_fn); 
+  p.vStr(kw_packed_model_fn, &s_packed_model_fn); 
+  p.swOff(&doLog, kw_not_doLog); 
+  p.swOn(&doDump, kw_doDump); 
+  p.check(log_out); 
+
+  return true; /* success */
+}
+
+/*------------------------------------------------*/
+void AzTETmain::printParam_pack_model(const AzOut &out) const
+{
+  if (out.isNull()) return; 
+  AzPrint o(out); 
+  o.ppBegin("AzTETmain::pack_model", "\"pack_model\""); 
+  o.printV(kw_model_fn, s_model_fn); 
+  o.printV(kw_packed_model_fn, s_packed_model_fn); 
+  o.printSw(kw_doLog, doLog); 
+  o.printSw(kw_doDump, doDump); 
+  o.ppEnd(); 
+}
+
+/*------------------------------------------------*/
+void AzTETmain::checkParam_pack_model() const
+{
+  const char *eyec = "AzTETmain::checkParam_pack_model"; 
+  throw_if_missing(kw_model_fn, s_model_fn, eyec); 
+  throw_if_missing(kw_packed_model_fn, s_packed_model_fn, eyec); 
+}
+
+/*------------------------------------------------*/
+void AzTETmain::printHelp_pack_model(const AzOut &out, 
+                const char *argv[], int argc) const
+{
+  print_usage(out, argv, argc); 
+
+  AzHelp h(out); 
+  h.item_required(kw_model_fn, help_pack_model_fn); 
+  h.item_required(kw_packed_model_fn, help_packed_model_fn); 
+  h.item_experimental(kw_not_doLog, help_not_doLog); 
+  h.item_experimental(kw_doDump, help_doDump); 
+  h.end(); 
+}
+
+/*------------------------------------------------*/
+/*------------------------------------------------*/
+/*  write a smaller model with the same           */
+/*  predictions                                   */
+/*------------------------------------------------*/
+void AzTETmain::compact_model(const char *argv[], int argc)
+{
+  const char *eyec = "AzTETmain::compact_model"; 
+  bool success = resetParam_compact_model(argv, argc); 
+  if (!success) return; 
+
+  prepareLogDmp(doLog, doDump); 
+
+  printParam_compact_model(log_out); 
+  print_hline(log_out); 
+  checkParam_compact_model(); 
+
+  const char *model_fn = s_model_fn.c_str(); 
+  if (AzTreeEnsembleFlat::isPacked(model_fn)) {
+    throw new AzException(AzInputNotValid, eyec, 
+          "A packed model cannot be compacted; compact the original model and pack it: ", model_fn); 
+  }
+  AzTE_ModelInfo info, new_info; 
+  int node_num = -1, new_node_num = -1, merged_num = -1; 
+  if (AzTreeEnsembleMulti::isMultiOutput(model_fn)) {
+    AzTreeEnsembleMulti multi(model_fn); 
+    multi.info(&info); 
+    node_num = multi.nodeNum(); 
+    merged_num = multi.compact(); 
+    multi.info(&new_info); 
+    new_node_num = multi.nodeNum(); 
+    multi.write(s_compact_model_fn.c_str()); 
+  }
+  else {
+    AzTreeEnsemble ens(model_fn); 
+    ens.info(&info); 
+    node_num = ens.nodeNum(); 
+    merged_num = ens.compact(); 
+    ens.info(&new_info); 
+    new_node_num = ens.nodeNum(); 
+    ens.write(s_compact_model_fn.c_str()); 
+  }
+
+  if (!log_out.isNull()) {
+    AzBytArr s(s_compact_model_fn.c_str()); s.c(": "); 
+    s.c("#tree="); s.cn(info.tree_num); s.c("->"); s.cn(new_info.tree_num); 
+    s.c(", #node="); s.cn(node_num); s.c("->"); s.cn(new_node_num); 
+    s.c(", #leaf="); s.cn(info.leaf_num); s.c("->"); s.cn(new_info.leaf_num); 
+    s.c(", #merged leaf="); s.cn(merged_num); 
+    AzPrint::writeln(log_out, s); 
+  }
+  AzTimeLog::print("Done ...", log_out); 
+}
+
+/*------------------------------------------------*/
+bool AzTETmain::resetParam_compact_model(const char *argv[], int argc)
+{
+  if (argc-config_argx != 1) {
+    printHelp_compact_model(log_out, argv, argc); 
+    return false; /* failed */
+  }
+
+  const char *param = argv[config_argx]; 
+  if (isHelpNeeded(param)) {
+    printHelp_compact_model(log_out, argv, argc); 
+    return false; /* failed */    
+  }
+
+  AzParam p(param); 
+  p.vStr(kw_model_fn, &s_model_fn); 
+  p.vStr(kw_compact_model_fn, &s_compact_model_fn); 
+  p.swOff(&doLog, kw_not_doLog); 
+  p.swOn(&doDump, kw_doDump); 
+  p.check(log_out); 
+
+  return true; /* success */
+}
+
+/*------------------------------------------------*/
+void AzTETmain::printParam_compact_model(const AzOut &out) const
+{
+  if (out.isNull()) return; 
+  AzPrint o(out); 
+  o.ppBegin("AzTETmain::compact_model", "\"compact_model\""); 
+  o.printV(kw_model_fn, s_model_fn); 
+  o.printV(kw_compact_model_fn, s_compact_model_fn); 
+  o.printSw(kw_doLog, doLog); 
+  o.printSw(kw_doDump, doDump); 
+  o.ppEnd(); 
+}
+
+/*------------------------------------------------*/
+void AzTETmain::checkParam_compact_model() const
+{
+  const char *eyec = "AzTETmain::checkParam_compact_model"; 
+  throw_if_missing(kw_model_fn, s_model_fn, eyec); 
+  throw_if_missing(kw_compact_model_fn, s_compact_model_fn, eyec); 
+}
+
+/*------------------------------------------------*/
+void AzTETmain::printHelp_compact_model(const AzOut &out, 
+                const char *argv[], int argc) const
+{
+  print_usage(out, argv, argc); 
+
+  AzHelp h(out); 
+  h.item_required(kw_model_fn, help_compact_inp_model_fn); 
+  h.item_required(kw_compact_model_fn, help_compact_model_fn); 
+  h.item_experimental(kw_not_doLog, help_not_doLog); 
+  h.item_experimental(kw_doDump, help_doDump); 
+  h.nl(); 
+  h.writeln_header("Dead nodes: the splits decided by the splits above on the same feature.  Zero-weight subtrees and the nodes whose children are leaves of the same weight become leaves.  The weight of a leaf is moved to the leaf of an earlier tree with the same rule (the same splits from the root), and the trees left with zero weight are removed.  The predictions are the same up to floating-point rounding.  The option \"CompactModel\" of \"train\" does the same before saving."); 
+  h.end(); 
+}
+
+/*------------------------------------------------*/
+/*------------------------------------------------*/
+/*  generate C++ code that scores data            */
+/*------------------------------------------------*/
+void AzTETmain::compile_model(const char *argv[], int argc)
+{
+  const char *eyec = "AzTETmain::compile_model"; 
+  bool success = resetParam_compile_model(argv, argc); 
+  if (!success) return; 
+
+  prepareLogDmp(doLog, doDump); 
+
+  printParam_compile_model(log_out); 
+  print_hline(log_out); 
+  checkParam_compile_model(); 
+
+  const char *model_fn = s_model_fn.c_str(); 
+  if (AzTreeEnsembleFlat::isPacked(model_fn)) {
+    throw new AzException(AzInputNotValid, eyec, 
+          "A packed model cannot be compiled; compile the original model: ", model_fn); 
+  }
+  AzTreeEnsembleMulti multi; 
+  AzTreeEnsemble ens; 
+  AzBaseArray<const AzTreeEnsemble *> a_ens; 
+  const AzTreeEnsemble **ens_ptr = NULL; 
+  int out_num = 1; 
+  if (AzTreeEnsembleMulti::isMultiOutput(model_fn)) {
+    multi.read(model_fn); 
+    out_num = multi.outNum(); 
+    a_ens.alloc(&ens_ptr, out_num, eyec, "ens"); 
+    int ox; 
+    for (ox = 0; ox < out_num; ++ox) ens_ptr[ox] = multi.ens(ox); 
+  }
+  else {
+    ens.read(model_fn); 
+    a_ens.alloc(&ens_ptr, out_num, eyec, "ens"); 
+    ens_ptr[0] = &ens; 
+  }
+
+  int feat_num = AzTreeEnsembleCode::featNum(ens_ptr, out_num); 
+  AzTreeEnsembleCode::write(ens_ptr, out_num, feat_num, s_code_name.c_str(), 
+                            model_fn, s_code_fn_prefix.c_str()); 
+  if (!log_out.isNull()) {
+    AzBytArr s(s_code_fn_prefix.c_str()); s.c(".hpp/.cpp: "); 
+    s.c("#feature="); s.cn(feat_num); s.c(", #output="); s.cn(out_num); 
+    AzTE_ModelInfo info; 
+    if (out_num > 1) multi.info(&info); 
+    else             ens.info(&info); 
+    s.c(", #tree="); s.cn(info.tree_num); s.c(", #leaf="); s.cn(info.leaf_num); 
+    AzPrint::writeln(log_out, s); 
+  }
+
+  if (s_test_x_fn.length() > 0) {
+    test_compiled_model(ens_ptr, out_num, feat_num); 
+  }
+  AzTimeLog::print("Done ...", log_out); 
+}
+
+/*------------------------------------------------*/
+/* Compile the code with a test program, run it   */
+/* on the test data, and compare its predictions  */
+/* (both functions) with AzTreeEnsemble::apply.   */
+/*------------------------------------------------*/
+void AzTETmain::test_compiled_model(const AzTreeEnsemble *const *ens, 
+                                    int out_num, 
+                                    int feat_num) const
+{
+  const char *eyec = "AzTETmain::test_compiled_model"; 
+  const char *prefix = s_code_fn_prefix.c_str(); 
+  AzSvDataS dataset; 
+  dataset.read_features_only(s_test_x_fn.c_str()); 
+  const AzSmat *m_test_x = dataset.feat(); 
+  if (m_test_x->rowNum() > feat_num) {
+    AzBytArr s("#feature in test data is "); s.cn(m_test_x->rowNum()); 
+    s.c(", whereas the code takes "); s.cn(feat_num); 
+    throw new AzException(AzInputError, eyec, s.c_str()); 
+  }
+  int data_num = m_test_x->colNum(); 
+
+  /*---  test data as dense rows  ---*/
+  AzBytArr s_x_fn(prefix, "_test.x"), s_p_fn(prefix, "_test.pred"), s_exe_fn(prefix, "_test.bin"); 
+  AzFile x_file(s_x_fn.c_str()); 
+  x_file.open("wb"); 
+  int dx; 
+  for (dx = 0; dx < data_num; ++dx) {
+    AzDvect v_x(m_test_x->col(dx)); 
+    AzBytArr s; 
+    int fx; 
+    for (fx = 0; fx < feat_num; ++fx) {
+      if (fx > 0) s.c(" "); 
+      s.cn((fx < v_x.rowNum()) ? v_x.get(fx) : 0, 17); 
+    }
+    s.nl(); 
+    s.writeText(&x_file); 
+  }
+  x_file.close(true); 
+
+  /*---  compile and run  ---*/
+  AzTreeEnsembleCode::write_test(s_code_name.c_str(), prefix); 
+  AzBytArr s_cmd(s_code_compiler.c_str()); 
+  s_cmd.c(" \""); s_cmd.c(&s_exe_fn); s_cmd.c("\" \""); s_cmd.c(prefix); s_cmd.c("_test.cpp\" \""); 
+  s_cmd.c(prefix); s_cmd.c(".cpp\""); 
+  AzTimeLog::print("Compiling: ", s_cmd.c_str(), log_out); 
+  if (system(s_cmd.c_str()) != 0) {
+    throw new AzException(AzInputError, eyec, "Failed to compile: ", s_cmd.c_str()); 
+  }
+  AzBytArr s_run("\""); s_run.c(&s_exe_fn); s_run.c("\" \""); s_run.c(&s_x_fn); 
+  s_run.c("\" \""); s_run.c(&s_p_fn); s_run.c("\""); 
+  AzTimeLog::print("Running: ", s_run.c_str(), log_out); 
+  if (system(s_run.c_str()) != 0) {
+    throw new AzException(AzInputError, eyec, "Failed to run: ", s_run.c_str()); 
+  }
+
+  /*---  read as double; not through AzSmat, which may be float  ---*/
+  AzStrPool sp_line; 
+  AzTools::readList(s_p_fn.c_str(), &sp_line); 
+  if (sp_line.size() != data_num) {
+    throw new AzException(AzInputError, eyec, "Unexpected output of the test program: ", s_p_fn.c_str()); 
+  }
+  AzDmat m_pred(out_num*2, data_num); 
+  for (dx = 0; dx < data_num; ++dx) {
+    const char *ptr = sp_line.c_str(dx); 
+    int px; 
+    for (px = 0; px < out_num*2; ++px) {
+      char *next = NULL; 
+      m_pred.set(px, dx, strtod(ptr, &next)); 
+      if (next == ptr) {
+        throw new AzException(AzInputError, eyec, "Unexpected output of the test program: ", s_p_fn.c_str()); 
+      }
+      ptr = next; 
+    }
+  }
+
+  /*---  compare: _predict and _predict_row for each output  ---*/
+  int diff_num = 0; 
+  double max_diff = 0; 
+  int ox; 
+  for (ox = 0; ox < out_num; ++ox) {
+    AzDvect v_p; 
+    ens[ox]->apply(m_test_x, &v_p); 
+    for (dx = 0; dx < data_num; ++dx) {
+      double diff = MAX(fabs(m_pred.get(ox, dx) - v_p.get(dx)), 
+                        fabs(m_pred.get(out_num+ox, dx) - v_p.get(dx))); 
+      if (diff != 0) ++diff_num; 
+      max_diff = MAX(max_diff, diff); 
+    }
+  }
+  remove(s_x_fn.c_str()); 
+  remove(s_p_fn.c_str()); 
+  remove(s_exe_fn.c_str()); 
+
+  AzBytArr s("Tested on "); s.cn(data_num); s.c(" data points: "); 
+  s.c("#differ="); s.cn(diff_num); s.c(", max difference="); s.cn(max_diff); 
+  AzTimeLog::print(s, log_out); 
+  if (diff_num > 0) {
+    throw new AzException(AzInputError, eyec, "The generated code doesn't predict the same as the model.", s.c_str()); 
+  }
+}
+
+/*------------------------------------------------*/
+bool AzTETmain::resetParam_compile_model(const char *argv[], int argc)
+{
+  if (argc-config_argx != 1) {
+    printHelp_compile_model(log_out, argv, argc); 
+    return false; /* failed */
+  }
+
+  const char *param = argv[config_argx]; 
+  if (isHelpNeeded(param)) {
+    printHelp_compile_model(log_out, argv, argc); 
+    return false; /* failed */    
+  }
+
+  AzParam p(param); 
+  p.vStr(kw_model_fn, &s_model_fn); 
+  p.vStr(kw_code_fn_prefix, &s_code_fn_prefix); 
+  p.vStr(kw_code_name, &s_code_name); 
+  p.vStr(kw_test_x_fn, &s_test_x_fn); 
+  p.vStr(kw_code_compiler, &s_code_compiler); 
+  p.swOff(&doLog, kw_not_doLog); 
+  p.swOn(&doDump, kw_doDump); 
+  p.check(log_out); 
+
+  return true; /* success */
+}
+
+/*------------------------------------------------*/
+void AzTETmain::printParam_compile_model(const AzOut &out) const
+{
+  if (out.isNull()) return; 
+  AzPrint o(out); 
+  o.ppBegin("AzTETmain::compile_model", "\"compile_model\""); 
+  o.printV(kw_model_fn, s_model_fn); 
+  o.printV(kw_code_fn_prefix, s_code_fn_prefix); 
+  o.printV(kw_code_name, s_code_name); 
+  o.printV_if_not_empty(kw_test_x_fn, s_test_x_fn); 
+  if (s_test_x_fn.length() > 0) o.printV(kw_code_compiler, s_code_compiler); 
+  o.printSw(kw_doLog, doLog); 
+  o.printSw(kw_doDump, doDump); 
+  o.ppEnd(); 
+}
+
+/*------------------------------------------------*/
+void AzTETmain::checkParam_compile_model() const
+{
+  const char *eyec = "AzTETmain::checkParam_compile_model"; 
+  throw_if_missing(kw_model_fn, s_model_fn, eyec); 
+  throw_if_missing(kw_code_fn_prefix, s_code_fn_prefix, eyec); 
+  if (!AzTreeEnsembleCode::isName(s_code_name.c_str())) {
+    throw new AzException(AzInputNotValid, eyec, kw_code_name, "must be a C identifier"); 
+  }
+}
+
+/*------------------------------------------------*/
+void AzTETmain::printHelp_compile_model(const AzOut &out, 
+                const char *argv[], int argc) const
+{
+  print_usage(out, argv, argc); 
+
+  AzHelp h(out); 
+  h.item_required(kw_model_fn, help_compile_inp_model_fn); 
+  h.item_required(kw_code_fn_prefix, help_code_fn_prefix); 
+  h.item(kw_code_name, help_code_name, dflt_code_name); 
+  h.item(kw_test_x_fn, help_code_test_x_fn); 
+  h.item(kw_code_compiler, help_code_compiler, dflt_code_compiler); 
+  h.item_experimental(kw_not_doLog, help_not_doLog); 
+  h.item_experimental(kw_doDump, help_doDump); 
+  h.nl(); 
+  h.writeln_header("The generated header declares <code_name>_predict_row(x,out), which takes the values of the <code_name>_FEAT_NUM features of one data point and writes <code_name>_OUT_NUM predictions (the #class of a multi-output model, or 1), and <code_name>_predict(x,num,out) for num data points stored one after another.  The predictions are the same as \"predict\"."); 
+  h.end(); 
+}
@@ -26,6 +26,10 @@
 #include "AzTETmain_kw.hpp"
 #include "AzTET_Eval.hpp"
 #include "AzSvDataS.hpp"
+#include "AzDataCache.hpp"
+#include "AzThreads.hpp"
+#include "AzSvDataStream.hpp"
+#include "AzTETserve.hpp"
 
 #include <ctime>
 
@@ -42,6 +46,7 @@ protected:
   bool doLog, doDump; 
   bool doAppend_eval; 
   bool doSaveLastModelOnly; 
+  bool doCompact; /* for train */
   const AzTETselector *alg_sel; 
 
   AzBytArr s_test_x_fn, s_test_y_fn; 
@@ -51,17 +56,41 @@ protected:
   AzBytArr s_xv_fn; 
   bool xv_doShuffle; 
   int xv_num; 
+  int xv_threads; /* #folds to run at the same time */
 
   AzBytArr s_input_x_fn, s_output_x_fn; 
   bool doSparse_features; 
   int features_digits; 
+
+  AzBytArr s_x_bin_fn; 
+  int num_threads; /* for predict and batch_predict */
+  int stream_chunk; /* for predict; 0: not streaming */
+  AzBytArr s_socket_fn; /* for serve */
+  int serve_batch; 
+  int serve_timeout; /* seconds */
+  AzBytArr s_sweep_fn; 
+  int sweep_threads; /* #parameter sets to train at the same time */
+  AzBytArr s_valid_x_fn, s_valid_y_fn, s_valid_metric; /* for train */
+  int valid_patience; 
+  AzBytArr s_checkpoint_fn; /* for train */
+  AzBytArr s_packed_model_fn; /* for pack_model */
+  AzBytArr s_compact_model_fn; /* for compact_model */
+  AzBytArr s_code_fn_prefix, s_code_name, s_code_compiler; /* for compile_model */
+  int class_num; /* for train; 0: not multi-class */
+  int class_threads; /* #classes to train at the same time */
 public:
   AzTETmain(const AzTETselector *inp_alg_sel, 
             AzTET_Eval *inp_eval) : s_model_stem(dflt_model_stem), eval(NULL), 
                                     doLog(true), doDump(false), doAppend_eval(false), 
-                                    doSaveLastModelOnly(false), 
-                                    xv_doShuffle(false), xv_num(2), 
-                                    doSparse_features(false), features_digits(10)
+                                    doSaveLastModelOnly(false), doCompact(false), 
+                                    xv_doShuffle(false), xv_num(2), xv_threads(1), 
+                                    doSparse_features(false), features_digits(10), 
+                                    num_threads(1), stream_chunk(0), 
+                                    serve_batch(dflt_serve_batch), serve_timeout(dflt_serve_timeout), sweep_threads(1), 
+                                    s_valid_metric(dflt_valid_metric), 
+                                    valid_patience(dflt_valid_patience), 
+                                    class_num(0), class_threads(1), 
+                                    s_code_name(dflt_code_name), s_code_compiler(dflt_code_compiler)
   {
     alg_sel = inp_alg_sel; 
     eval = inp_eval; 
@@ -76,6 +105,12 @@ public:
   virtual void xv(const char *argv[], int argc); 
 
   virtual void features(const char *argv[], int argc); 
+  virtual void prepare_data(const char *argv[], int argc); 
+  virtual void serve(const char *argv[], int argc); 
+  virtual void sweep(const char *argv[], int argc); 
+  virtual void pack_model(const char *argv[], int argc); 
+  virtual void compact_model(const char *argv[], int argc); 
+  virtual void compile_model(const char *argv[], int argc); 
 
   virtual void printHelp_train(const AzOut &out, 
                                const char *argv[], int argc, 
@@ -86,9 +121,7 @@ public:
   virtual void printHelp_batch_predict(const AzOut &out, 
                                const char *argv[], int argc) const; 
   virtual void printHelp_xv(const AzOut &out, 
-                            const char *argv[], int argc) const {
-    throw new AzException("AzTETmain::printHelp_xv", "No help for xv"); 
-  }
+                            const char *argv[], int argc) const; 
 
   static void writePrediction_single(const AzDvect *v_p, 
                                      AzFile *file);
@@ -107,12 +140,34 @@ protected:
                          AzSmat *m_x, 
                          AzDvect *v_y, 
                          AzSvFeatInfoClone *featInfo=NULL) const; 
-  virtual void readDataWeights(AzBytArr &s_fn, 
+  /*---  packed: for training data, which is transposed in the end  ---*/
+  virtual void readData(const char *x_fn, 
+                         const char *y_fn, 
+                         const char *fdic_fn, 
+                         /*---  output  ---*/
+                         AzSmatc *m_x, 
+                         AzDvect *v_y, 
+                         AzSvFeatInfoClone *featInfo=NULL) const; 
+  virtual void readDataWeights(const AzBytArr &s_fn, 
                             int data_num, 
                             AzDvect *v_fixed_dw) const; 
+  virtual void readTrainingData(AzDataCache *cache, 
+                         /*---  output  ---*/
+                         AzSmatc *m_tr_x, 
+                         AzDvect *v_tr_y, 
+                         AzDvect *v_fixed_dw, 
+                         AzSvFeatInfoClone *featInfo) const; 
+  virtual void readTestData_bin(AzSmat *m_test_x, 
+                                AzDvect *v_test_y) const; 
 
   void prepareLogDmp(bool doLog, bool doDump); 
 
+  virtual void train_multiclass(AzDataCache *cache, 
+                                AzSmatc *m_tr_x, /* destroyed */
+                                const AzDvect *v_tr_y, 
+                                const AzDvect *v_fixed_dw, 
+                                const AzSvFeatInfo *featInfo); 
+
   virtual bool resetParam_train_predict(const char *argv[], int argc); 
   virtual void printParam_train_predict(const AzOut &out) const; 
   virtual void checkParam_train_predict() const; 
@@ -140,6 +195,48 @@ protected:
   virtual void printHelp_features(const AzOut &out, 
                 const char *argv[], int argc) const; 
 
+  virtual bool resetParam_serve(const char *argv[], int argc); 
+  virtual void printParam_serve(const AzOut &out) const; 
+  virtual void checkParam_serve() const; 
+  virtual void printHelp_serve(const AzOut &out, 
+                               const char *argv[], int argc) const; 
+
+  virtual bool resetParam_sweep(const char *argv[], int argc); 
+  virtual void printParam_sweep(const AzOut &out) const; 
+  virtual void checkParam_sweep() const; 
+  virtual void printHelp_sweep(const AzOut &out, 
+                               const char *argv[], int argc) const; 
+  static void merge_config(const AzBytArr &s_common, 
+                           const AzBytArr &s_line, 
+                           AzBytArr *s_config); /* output */
+
+  virtual bool resetParam_prepare_data(const char *argv[], int argc); 
+  virtual void printParam_prepare_data(const AzOut &out) const; 
+  virtual void checkParam_prepare_data() const; 
+
+  virtual bool resetParam_pack_model(const char *argv[], int argc); 
+  virtual void printParam_pack_model(const AzOut &out) const; 
+  virtual void checkParam_pack_model() const; 
+  virtual void printHelp_pack_model(const AzOut &out, 
+                                    const char *argv[], int argc) const;  
+  virtual bool resetParam_compact_model(const char *argv[], int argc); 
+  virtual void printParam_compact_model(const AzOut &out) const; 
+  virtual void checkParam_compact_model() const; 
+  virtual void printHelp_compact_model(const AzOut &out, 
+                const char *argv[], int argc) const; 
+  virtual bool resetParam_compile_model(const char *argv[], int argc); 
+  virtual void printParam_compile_model(const AzOut &out) const; 
+  virtual void checkParam_compile_model() const; 
+  virtual void printHelp_compile_model(const AzOut &out, 
+                const char *argv[], int argc) const; 
+  void test_compiled_model(const AzTreeEnsemble *const *ens, int out_num, 
+                           int feat_num) const; 
+  virtual void printHelp_prepare_data(const AzOut &out, 
+                const char *argv[], int argc) const; 
+
+  virtual void checkParam_test_x(const char *eyec) const; 
+  virtual AzPerfType validPerfType() const; 
+
   virtual bool isHelpNeeded(const char *param) const; 
 
   inline virtual void throw_if_missing(const char *kw, const AzBytArr &s_val, 
@@ -161,11 +258,45 @@ protected:
                           const char *name_dlm, 
                           const char *dlm, 
                           AzBytArr *s_info) const; 
-  virtual void _predict(const AzSvDataS *dataset, 
+  virtual void format_info(const char *model_fn, 
+                          const AzTE_ModelInfo *info, 
+                          const char *name_dlm, 
+                          const char *dlm, 
+                          AzBytArr *s_info) const; 
+  virtual void _predict(const AzSmat *m_test_x, 
+                         const char *model_fn, 
+                         const char *pred_fn, 
+                         const AzOut &out, 
+                         bool doEval) const; 
+  virtual void _predict_multi(const AzSmat *m_test_x, 
+                         const char *model_fn, 
+                         const char *pred_fn, 
+                         const AzOut &out) const; 
+  virtual void _predict_packed(const AzSmat *m_test_x, 
                          const char *model_fn, 
                          const char *pred_fn, 
                          const AzOut &out, 
                          bool doEval) const; 
+  virtual void predict_stream(const AzOut &out) const; 
+  static void readModel(int f_num, /* #feature in test data */
+                        const char *model_fn, 
+                        AzTreeEnsemble *ens); /* output */
+  static void checkFeatNum(int f_num, /* #feature in test data */
+                           int orgdim, /* #feature in training data */
+                           const char *model_fn); 
+  static void writePrediction_multi(const AzDmat *m_p, /* #output x #data */
+                                    AzFile *file); 
+  virtual void _predict_output(const AzTE_ModelInfo *info, 
+                         const AzDvect *v_test_p, 
+                         const char *model_fn, 
+                         const char *pred_fn, 
+                         const AzOut &out, 
+                         bool doEval) const; 
+  virtual void _predict_models(const AzSmat *m_test_x, 
+                         const AzStrPool *sp_model_fn, 
+                         int th_num, 
+                         const AzOut &out, 
+                         bool doEval) const; 
 
   virtual void print_config(const AzBytArr &s_config, 
                             const AzOut &out) const; 
@@ -25,12 +25,26 @@
 #define kw_batch_predict "batch_predict"
 #define kw_train_predict "train_predict"
 #define kw_features      "output_features"
+#define kw_prepare_data  "prepare_data"
+#define kw_serve  "serve"
+#define kw_sweep  "sweep"
+#define kw_pack_model  "pack_model"
+#define kw_compact_model  "compact_model"
+#define kw_compile_model  "compile_model"
+#define kw_xv  "xv"
 #define help_train         "Train and save models to files."
 #define help_train_test    "Train and test models.  Optionally models can be saved to files."
 #define help_train_predict "Train models and save predictions on test data to files.  Models can also be saved to files."  
 #define help_predict       "Apply a model saved by \"train\" to new data."
 #define help_batch_predict "Apply several models to new data."
 #define help_features      "Output features generated by tree ensembles."
+#define help_serve  "Keep models in memory and score data points sent over stdin or a Unix domain socket."
+#define help_sweep  "Train with several sets of parameters on the same data sorted only once and test the models."
+#define help_pack_model  "Convert a model to the packed format, which \"predict\", \"batch_predict\", and \"serve\" map into memory and use without parsing."
+#define help_compact_model  "Write a smaller model with the same predictions: dead nodes and zero-weight subtrees are removed, and duplicated rules are merged."
+#define help_compile_model  "Generate C++ code that scores data with a model: nested comparisons with the borders and the weights as constants."
+#define help_xv  "Cross validation: split the training data into folds, train on all but one fold and test on that fold in turn, and write the performance averaged over the folds at every check point."
+#define help_prepare_data  "Save data in a binary format so that \"train\" etc. can skip parsing and sorting."
 
 #define kw_alg_name "algorithm="
 #define kw_train_x_fn "train_x_fn="
@@ -55,10 +69,31 @@
 #define kw_xv_doShuffle "ShuffleData"
 #define kw_xv_num "num_xv="
 #define kw_xv_fn "xv_fn="
+#define kw_xv_threads "xv_num_threads="
 #define kw_input_x_fn "input_x_fn="
 #define kw_output_x_fn "output_x_fn="
 #define kw_features_digits "features_digits="
 #define kw_doSparse_features "SparseFeatures"
+#define kw_x_bin_fn "x_bin_fn="
+#define kw_stream_chunk "stream_chunk="
+#define kw_serve_socket "socket_fn="
+#define kw_serve_batch "serve_batch="
+#define kw_serve_timeout "serve_timeout="
+#define kw_sweep_fn "sweep_fn="
+#define kw_valid_x_fn "valid_x_fn="
+#define kw_valid_y_fn "valid_y_fn="
+#define kw_valid_metric "valid_metric="
+#define kw_valid_patience "valid_patience="
+#define kw_sweep_threads "sweep_num_threads="
+#define kw_checkpoint_fn "checkpoint_fn="
+#define kw_class_num "num_class="
+#define kw_class_threads "class_num_threads="
+#define kw_packed_model_fn "packed_model_fn="
+#define kw_compact_model_fn "compact_model_fn="
+#define kw_doCompact "CompactModel"
+#define kw_code_fn_prefix "code_fn_prefix="
+#define kw_code_name "code_name="
+#define kw_code_compiler "compiler="
 
 #define help_train_x_fn "Path to the feature file of training data."
 #define help_train_y_fn "Path to the target file of training data."
@@ -88,8 +123,50 @@
 #define help_features_digits "How many digits should be retained in the output."
 #define help_doSparse_features "Write features in the sparse data format."
 
+#define help_x_bin_fn_out "Path to the binary data file to write to."
+#define help_x_bin_fn_train "Path to the binary data file written by \"prepare_data\".  Use this instead of train_x_fn and train_y_fn to skip parsing and sorting the training data.  The data point weights and feature names saved in the file are used unless train_w_fn is specified."
+#define help_x_bin_fn_test "Path to the binary data file written by \"prepare_data\".  Use this instead of test_x_fn."
+
+#define help_stream_chunk "If positive, read test data this many data points at a time and write the predictions as they are made, so that memory usage does not depend on the data size.  Specify \"-\" as test_x_fn or prediction_fn to read from stdin or write to stdout (then, the log goes to stderr); in that case, this is set to 10000 unless specified.  Evaluation is not supported in this mode."
+
+#define help_serve_socket "Path to the Unix domain socket to listen on.  If omitted, data points are read from stdin and predictions are written to stdout (then, the log goes to stderr).  Clients are served one at a time in the order of connection.  If the file exists and is not a socket, it is an error."
+#define help_serve_batch "Maximum number of data points to be scored together."
+#define help_serve_timeout "Seconds a socket client may stay idle (not sending a request or not reading the response) before it is disconnected so that the next client is served.  0: no limit."
+
+#define help_sweep_fn "Path to the file of parameter sets, one per line, delimited by \",\" (e.g., \"reg_L2=0.1,max_leaf_forest=1000\").  Empty lines and lines starting with \"#\" are ignored.  Each set overrides the algorithm parameters given on the command line."
+#define help_sweep_eval_fn "Path to the file to write evaluation to: one line for each parameter set and each check point (see test_interval)."
+#define help_valid_x_fn "Path to the feature file of validation data.  If specified, the model is tested on this data at every check point (see test_interval), training stops when it stops improving, and only the best model is saved."
+#define help_valid_y_fn "Path to the target file of validation data."
+#define help_valid_metric "loss|rmse|acc.  What is compared on validation data; \"loss\" is the training loss function (see loss)."
+#define help_valid_patience "Stop training if validation does not improve for this many check points.  0: never stop early; just save the best model."
+#define help_xv_fn "Path to the file to write the performance averaged over the folds to: one line for each check point (see test_interval)."
+#define help_xv_num "Number of folds."
+#define help_xv_doShuffle "Shuffle the data points before splitting them into folds.  If omitted, the folds are consecutive blocks of the training data."
+#define help_xv_threads "Number of folds to be processed at the same time.  0: as many as the processors."
+#define help_sweep_threads "Number of parameter sets to be trained at the same time.  0: as many as the processors."
+#define help_class_num "If 2 or larger, train one-vs-rest: train_y_fn must contain class labels 0,1,...,num_class-1, one forest is trained for each class on the training data read and sorted only once, and each model file holds all the forests (a multi-output model).  \"predict\" writes num_class scores per data point for such a model.  Not supported with validation data, checkpoints, or warm-start."
+#define help_class_threads "Number of classes to be trained at the same time.  0: as many as the processors."
+#define help_pack_model_fn "Path to the model file saved by \"train\".  A multi-output model (num_class=) can also be packed."
+#define help_packed_model_fn "Path to the packed model file to write to.  It can be given as model_fn= to \"predict\", \"batch_predict\", and \"serve\"; it is mapped into memory and shared by the processes using it.  It is not portable across the platforms with different endianness."
+#define help_compact_inp_model_fn "Path to the model file saved by \"train\".  A multi-output model (num_class=) can also be compacted."
+#define help_compact_model_fn "Path to the file to write the compacted model to."
+#define help_doCompact "Compact the models before saving them as \"compact_model\" does: remove the nodes the splits above make unreachable, collapse the nodes whose children are leaves of the same weight (e.g., zero-weight subtrees), move the weight of a leaf to the leaf of an earlier tree with the same rule, and remove the trees left with zero weight.  The predictions are the same up to floating-point rounding."
+#define help_compile_inp_model_fn "Path to the model file saved by \"train\".  A multi-output model (num_class=) can also be compiled."
+#define help_code_fn_prefix "Path names of the generated code: <this>.hpp and <this>.cpp.  With test_x_fn, also <this>_test.cpp."
+#define help_code_name "Prefix of the generated functions and macros; a C identifier."
+#define help_code_test_x_fn "Path to the feature file of test data.  If specified, the generated code is compiled with a test program, run on this data, and checked against the predictions of the model.  Error if any of them differs."
+#define help_code_compiler "Command to compile the test program; the output and source file names are appended."
+#define help_checkpoint_fn "Path to the checkpoint file.  The training state is written to it at every check point (see test_interval), and if it exists at start, training resumes from it instead of starting over; the training data and the algorithm must be the same.  It is removed when training ends.  Not supported with validation data or min-penalty regularization."
+
 /* #define dflt_model_names_fn "model_list.txt" */
 #define dflt_model_stem ""
+#define dflt_stream_chunk 10000
+#define dflt_serve_batch 1000
+#define dflt_serve_timeout 30
+#define dflt_valid_metric "loss"
+#define dflt_valid_patience 3
+#define dflt_code_name "rgf_model"
+#define dflt_code_compiler "c++ -O2 -o"
 
 #define Az_config "config"
 
@@ -18,6 +18,8 @@
 
 #include "AzTETproc.hpp"
 #include "AzTaskTools.hpp"
+#include "AzThreads.hpp"
+#include "AzTreeEnsembleMulti.hpp"
 
 /*------------------------------------------------------------------*/
 void AzTETproc::train(const AzOut &out, 
@@ -32,26 +34,154 @@ void AzTETproc::train(const AzOut &out,
                       /*---  data point weights  ---*/
                       AzDvect *v_fixed_dw, /* may be NULL */
                       /*---  for warm start  ---*/
-                      AzTreeEnsemble *inp_ens) /* may be NULL */
+                      AzTreeEnsemble *inp_ens, /* may be NULL */
+                      /*---  for resuming  ---*/
+                      const char *checkpoint_fn, /* may be NULL */
+                      bool doCompact)
 {
-  trainer->startup(out, config, m_train_x, v_train_y, featInfo, v_fixed_dw, inp_ens); 
-
   AzBytArr s_model_names; 
   int seq_no = 1; 
+  if (checkpoint_fn != NULL && AzFile::isExisting(checkpoint_fn)) {
+    AzTimeLog::print("Resuming from the checkpoint: ", checkpoint_fn, out); 
+    if (inp_ens != NULL) {
+      AzTimeLog::print("The model for warm-start is ignored", out); 
+      inp_ens->destroy(); 
+    }
+    AzFile file(checkpoint_fn); 
+    file.open("rb"); 
+    seq_no = file.readInt(); 
+    s_model_names.read(&file); 
+    trainer->resume(out, config, m_train_x, v_train_y, featInfo, v_fixed_dw, &file); 
+    file.close(); 
+  }
+  else {
+    trainer->startup(out, config, m_train_x, v_train_y, featInfo, v_fixed_dw, inp_ens); 
+  }
+
   for ( ; ; ) {
     AzTETrainer_Ret ret = trainer->proceed_until(); 
     if (out_model_fn != NULL) {
       AzTreeEnsemble ens; 
       trainer->copy_to(&ens); 
-      writeModel(&ens, seq_no, out_model_fn, NULL, &s_model_names, out); 
+      writeModel(&ens, seq_no, out_model_fn, NULL, &s_model_names, out, doCompact); 
       ++seq_no; 
     }
     if (ret == AzTETrainer_Ret_Exit) {
       break;   
     }
+    if (checkpoint_fn != NULL) {
+      writeCheckpoint(trainer, seq_no, s_model_names, checkpoint_fn, out); 
+    }
   }
   int model_num = seq_no - 1; 
   end_of_saving_models(model_num, s_model_names, out_model_names_fn, out); 
+  if (checkpoint_fn != NULL) {
+    remove(checkpoint_fn); /* done; nothing to resume */
+  }
+}
+
+/*------------------------------------------------------------------*/
+/* Written to a temporary file first and then renamed so that an    */
+/* interruption while writing doesn't destroy the last checkpoint.  */
+/*------------------------------------------------------------------*/
+void AzTETproc::writeCheckpoint(AzTETrainer *trainer, 
+                                int seq_no, /* of the next model */
+                                const AzBytArr &s_model_names, 
+                                const char *checkpoint_fn, 
+                                const AzOut &out)
+{
+  const char *eyec = "AzTETproc::writeCheckpoint"; 
+  AzTimeLog::print("Writing checkpoint: ", checkpoint_fn, out); 
+  AzBytArr s_tmp_fn(checkpoint_fn, ".tmp"); 
+  AzFile file(s_tmp_fn.c_str()); 
+  file.open("wb"); 
+  file.writeInt(seq_no); 
+  s_model_names.write(&file); 
+  try {
+    trainer->write_checkpoint(&file); 
+  }
+  catch (AzException *e) {
+    file.close(); 
+    remove(s_tmp_fn.c_str()); 
+    throw e; 
+  }
+  file.close(true); 
+#ifdef _WIN32
+  remove(checkpoint_fn); /* rename doesn't overwrite */
+#endif
+  if (rename(s_tmp_fn.c_str(), checkpoint_fn) != 0) {
+    throw new AzException(AzFileIOError, eyec, "Failed to rename to", checkpoint_fn); 
+  }
+}
+
+/*------------------------------------------------------------------*/
+void AzTETproc::train_valid(const AzOut &out, 
+                      AzTETrainer *trainer, 
+                      const char *config,                       
+                      AzSmat *m_train_x, 
+                      AzDvect *v_train_y, 
+                      const AzSvFeatInfo *featInfo, 
+                      /*---  for validation  ---*/
+                      AzSmat *m_valid_x, 
+                      const AzDvect *v_valid_y, 
+                      AzPerfType perf_type, 
+                      int patience, 
+                      /*---  for writing model to file  ---*/
+                      const char *out_model_fn, 
+                      const char *out_model_names_fn, /* may be NULL */
+                      /*---  data point weights  ---*/
+                      AzDvect *v_fixed_dw, /* may be NULL */
+                      /*---  for warm start  ---*/
+                      AzTreeEnsemble *inp_ens, /* may be NULL */
+                      bool doCompact)
+{
+  /*---  the validation data keeps what was applied so far  ---*/
+  AzTETrainer_TestData td(out, m_valid_x); 
+
+  trainer->startup(out, config, m_train_x, v_train_y, featInfo, v_fixed_dw, inp_ens); 
+
+  AzTreeEnsemble ens[2]; /* the best one and the current one */
+  int best = -1, best_seq = -1; 
+  double best_perf = -1; 
+  int seq_no = 1; 
+  for ( ; ; ++seq_no) {
+    AzTETrainer_Ret ret = trainer->proceed_until(); 
+
+    int cur = (best == 0) ? 1 : 0; 
+    AzDvect v_p; 
+    AzTE_ModelInfo info; 
+    trainer->apply(&td, &v_p, &info, &ens[cur]); 
+    AzPerfResult res = AzTaskTools::eval(&v_p, v_valid_y, trainer->lossType()); 
+    double perf = res.getPerf(perf_type); 
+    if (best < 0 || AzPerfResult::isBetter(perf_type, perf, best_perf)) {
+      best = cur; 
+      best_seq = seq_no; 
+      best_perf = perf; 
+    }
+    AzBytArr s("Validation: seq#="); s.cn(seq_no); 
+    s.c(", #leaf="); s.cn(info.leaf_num); s.c(", #tree="); s.cn(info.tree_num); 
+    s.c(", "); s.c(AzPerfResult::getPerfStr(perf_type)); s.c("="); s.cn(perf, 6); 
+    s.c(" (best: seq#="); s.cn(best_seq); s.c(")"); 
+    AzPrint::writeln(out, s); 
+
+    if (ret == AzTETrainer_Ret_Exit) {
+      break;   
+    }
+    if (patience > 0 && seq_no - best_seq >= patience) {
+      AzBytArr s("Stopping: no improvement on the validation data in the last "); 
+      s.cn(patience); s.c(" check point(s)"); 
+      AzTimeLog::print(s, out); 
+      break; 
+    }
+  }
+
+  AzBytArr s_model_names; 
+  int model_num = 0; 
+  if (out_model_fn != NULL) {
+    writeModel(&ens[best], best_seq, out_model_fn, NULL, &s_model_names, out, doCompact); 
+    ++model_num; 
+  }
+  end_of_saving_models(model_num, s_model_names, out_model_names_fn, out); 
 }
 
 /*------------------------------------------------------------------*/
@@ -170,8 +300,14 @@ void AzTETproc::writeModel(AzTreeEnsemble *ens,
                            const char *fn_stem, 
                            AzBytArr *s_model_fn, 
                            AzBytArr *s_model_names, 
-                           const AzOut &out)
+                           const AzOut &out, 
+                           bool doCompact)
 {
+  if (doCompact) {
+    int tree_num = ens->size(), node_num = ens->nodeNum(); 
+    int merged_num = ens->compact(); 
+    show_compact(out, tree_num, node_num, ens->size(), ens->nodeNum(), merged_num); 
+  }
   AzBytArr s; 
   gen_model_fn(fn_stem, seq_no, &s); 
   AzTimeLog::print("Writing model: seq#=", seq_no, out); 
@@ -181,6 +317,19 @@ void AzTETproc::writeModel(AzTreeEnsemble *ens,
   s_model_names->concat(&s); 
 }
 
+/*------------------------------------------------------------------*/
+void AzTETproc::show_compact(const AzOut &out, 
+                             int org_tree_num, int org_node_num, 
+                             int tree_num, int node_num, 
+                             int merged_num)
+{
+  if (out.isNull()) return; 
+  AzBytArr s("Compacted: #tree="); s.cn(org_tree_num); s.c("->"); s.cn(tree_num); 
+  s.c(", #node="); s.cn(org_node_num); s.c("->"); s.cn(node_num); 
+  s.c(", #merged leaf="); s.cn(merged_num); 
+  AzPrint::writeln(out, s); 
+}
+
 /*------------------------------------------------------------------*/
 void AzTETproc::gen_model_fn(const char *fn_stem, 
                              int seq_no, 
@@ -377,17 +526,21 @@ void AzTETproc::xv(const AzOut &out,
                    int xv_num, 
                    const char *xv_fn, 
                    bool doShuffle, 
-                   AzTETrainer *trainer, 
+                   AzTETrainer **trainers, /* one for each thread */
+                   int th_num, 
                    const char *config, 
-                   AzSmat *m_x, 
-                   AzDvect *v_y, 
+                   const AzSmatc *m_x, 
+                   const AzDvect *v_y, 
                    const AzSvFeatInfo *featInfo,
                    /*---  data point weights  ---*/
-                   AzDvect *v_dw) /* may be NULL */
+                   const AzDvect *v_dw) /* may be NULL */
 {
   const char *eyec = "AzTETproc::xv"; 
 
   int nn = m_x->colNum(); 
+  if (xv_num < 2 || xv_num > nn) {
+    throw new AzException(AzInputNotValid, eyec, "The number of folds must be between 2 and the number of data points."); 
+  }
   int each = nn / xv_num; 
   int extra = nn % xv_num; 
   AzIntArr ia_dxs; 
@@ -397,84 +550,73 @@ void AzTETproc::xv(const AzOut &out,
   }
   const int *dxs = ia_dxs.point(); 
 
-  AzDataPool<AzPerfResult> perf; 
-
+  /*---  test data of fold#xx: [ia_bx[xx], ia_bx[xx+1])  ---*/
+  AzIntArr ia_bx; 
   int bx = 0; 
   int xx; 
   for (xx = 0; xx < xv_num; ++xx) {
-    int ex = bx+each; 
+    ia_bx.put(bx); 
+    bx += each; 
     if (extra > 0) {
-      ++ex; 
+      ++bx; 
       --extra; 
     }
-    int tst_num = ex-bx; 
-    int trn_num = nn-tst_num; 
- 
-    AzBytArr s("-----  "); s.cn(xx+1); s.c("/"); s.cn(xv_num); 
-    s.c(" #train: "); s.cn(trn_num); s.c(" #test: "); s.cn(tst_num); 
-    AzTimeLog::print(s, out); 
-   
-    AzSmat m_train_x(m_x->rowNum(), trn_num), m_test_x(m_x->rowNum(), tst_num); 
-    AzDvect v_train_y(trn_num), v_test_y(tst_num); 
-    AzDvect v_fixed_dw; 
-    if (!AzDvect::isNull(v_dw)) {
-      v_fixed_dw.reform(trn_num); 
+  }
+  ia_bx.put(bx); 
+
+  AzDataPool<AzPerfResult> perf; 
+  th_num = MAX(1, MIN(th_num, xv_num)); 
+  for (xx = 0; xx < xv_num; xx += th_num) {
+    int fold_num = MIN(th_num, xv_num - xx); 
+    AzDataArr<AzDataPool<AzPerfResult> > arr_perf(fold_num); 
+    if (fold_num == 1) {
+      xv_fold(out, xx, xv_num, dxs, ia_bx.get(xx), ia_bx.get(xx+1), trainers[0], config, 
+              m_x, v_y, featInfo, v_dw, arr_perf.point_u(0)); 
     }
-    int trn_col=0, tst_col=0; 
-	int ix; 
-    for (ix = 0; ix < nn; ++ix) {
-      if (ix >= bx && ix < ex) {
-        m_test_x.col_u(tst_col)->set(m_x->col(ix)); 
-        v_test_y.set(tst_col, v_y->get(ix)); 
-        ++tst_col; 
-      }
-      else {
-        m_train_x.col_u(trn_col)->set(m_x->col(ix)); 
-        v_train_y.set(trn_col, v_y->get(ix)); 
-        if (!AzDvect::isNull(v_dw)) {
-          v_fixed_dw.set(trn_col, v_dw->get(ix)); 
+    else {
+      /*---  folds in parallel; the log of each fold is kept and shown in order  ---*/
+      AzDataArr<stringstream> arr_log(fold_num); 
+      AzThreadErr th_err; 
+      int thx; 
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(fold_num) schedule(static,1)
+#endif
+      for (thx = 0; thx < fold_num; ++thx) {
+        try {
+          AzOut fold_out; 
+          if (!out.isNull()) fold_out.reset(arr_log.point_u(thx)); 
+          int fx = xx + thx; 
+          xv_fold(fold_out, fx, xv_num, dxs, ia_bx.get(fx), ia_bx.get(fx+1), trainers[thx], config, 
+                  m_x, v_y, featInfo, v_dw, arr_perf.point_u(thx)); 
+        }
+        catch (AzException *e) {
+          th_err.keep(e); 
         }
-        ++trn_col; 
-      }
-    }
-    if (trn_col != m_train_x.colNum() || tst_col != m_test_x.colNum()) {
-      throw new AzException(eyec, "dimension mismatch"); 
-    }    
-
-    /*---  ---*/
-    AzTETrainer_TestData td(out, &m_test_x); 
-    trainer->startup(out, config, &m_train_x, &v_train_y, featInfo, 
-                     &v_fixed_dw, NULL); 
-    int seq = 0; 
-    for ( ; ; ++seq) {
-      AzTETrainer_Ret ret = trainer->proceed_until(); 
-      AzDvect v_p; 
-      AzTE_ModelInfo info; 
-      trainer->apply(&td, &v_p, &info); 
-
-      AzPerfResult res = AzTaskTools::eval(&v_p, &v_test_y, trainer->lossType()); 
-      AzBytArr s("seq,");s.cn(seq+1);
-      s.c(",acc,");s.cn(res.acc,6);
-      s.c(",rmse,");s.cn(res.rmse,6); 
-      s.c(",loss,");s.cn(res.loss,6); 
-      s.c(",#leaf,"); s.cn(info.leaf_num); 
-      s.c(",#tree,"); s.cn(info.tree_num); 
-      AzPrint::writeln(out, s); 
-
-      res.multiply(1/(double)xv_num); 
-      if (xx == 0) {
-        *(perf.new_slot()) = res; 
       }
-      else {
-        perf.point_u(seq)->add(&res); 
+      for (thx = 0; thx < fold_num; ++thx) {
+        AzPrint::write(out, arr_log.point(thx)->str().c_str()); 
       }
+      th_err.throw_if(); 
+    }
 
-      if (ret == AzTETrainer_Ret_Exit) {
-        break;   
+    /*---  average over the folds in the order of the folds  ---*/
+    int fx; 
+    for (fx = 0; fx < fold_num; ++fx) {
+      const AzDataPool<AzPerfResult> *fold_perf = arr_perf.point(fx); 
+      if (xx+fx > 0 && perf.size() != fold_perf->size()) {
+        throw new AzException(eyec, "the number of results is different?"); 
+      }
+      int seq; 
+      for (seq = 0; seq < fold_perf->size(); ++seq) {
+        AzPerfResult res = *fold_perf->point(seq); 
+        res.multiply(1/(double)xv_num); 
+        if (xx+fx == 0) {
+          *(perf.new_slot()) = res; 
+        }
+        else {
+          perf.point_u(seq)->add(&res); 
+        }
       }
-    }
-    if (xx > 0 && perf.size() != seq+1) {
-      throw new AzException(eyec, "the number of results is different?"); 
     }
   }
 
@@ -494,6 +636,364 @@ void AzTETproc::xv(const AzOut &out,
   file.close(true); 
 }
 
+/*------------------------------------------------------------------*/
+/* train on all but dxs[bx..ex-1] and test on dxs[bx..ex-1] */
+void AzTETproc::xv_fold(const AzOut &out, 
+                   int xx, 
+                   int xv_num, 
+                   const int *dxs, 
+                   int bx, int ex, 
+                   AzTETrainer *trainer, 
+                   const char *config, 
+                   const AzSmatc *m_x, 
+                   const AzDvect *v_y, 
+                   const AzSvFeatInfo *featInfo,
+                   const AzDvect *v_dw, /* may be NULL */
+                   /*---  output  ---*/
+                   AzDataPool<AzPerfResult> *fold_perf)
+{
+  const char *eyec = "AzTETproc::xv_fold"; 
+
+  int nn = m_x->colNum(); 
+  int tst_num = ex-bx; 
+  int trn_num = nn-tst_num; 
+ 
+  AzBytArr s("-----  "); s.cn(xx+1); s.c("/"); s.cn(xv_num); 
+  s.c(" #train: "); s.cn(trn_num); s.c(" #test: "); s.cn(tst_num); 
+  AzTimeLog::print(s, out); 
+   
+  /*---  the data points of each side; m_x is shared by the folds  ---*/
+  AzIntArr ia_train_dxs, ia_test_dxs; 
+  ia_train_dxs.prepare(trn_num); 
+  ia_test_dxs.prepare(tst_num); 
+  AzDvect v_train_y(trn_num), v_test_y(tst_num); 
+  AzDvect v_fixed_dw; 
+  if (!AzDvect::isNull(v_dw)) {
+    v_fixed_dw.reform(trn_num); 
+  }
+  int trn_col=0, tst_col=0; 
+  int ix; 
+  for (ix = 0; ix < nn; ++ix) {
+    int dx = dxs[ix]; 
+    if (ix >= bx && ix < ex) {
+      ia_test_dxs.put(dx); 
+      v_test_y.set(tst_col, v_y->get(dx)); 
+      ++tst_col; 
+    }
+    else {
+      ia_train_dxs.put(dx); 
+      v_train_y.set(trn_col, v_y->get(dx)); 
+      if (!AzDvect::isNull(v_dw)) {
+        v_fixed_dw.set(trn_col, v_dw->get(dx)); 
+      }
+      ++trn_col; 
+    }
+  }
+  if (trn_col != trn_num || tst_col != tst_num) {
+    throw new AzException(eyec, "dimension mismatch"); 
+  }    
+
+  /*---  ---*/
+  AzTETrainer_TestData td; 
+  td.reset(out, m_x, &ia_test_dxs); 
+  AzSmat m_train_x; /* empty: the trainer reads m_x in place */
+  trainer->reset_packed_data(m_x, &ia_train_dxs); 
+  trainer->startup(out, config, &m_train_x, &v_train_y, featInfo, 
+                   &v_fixed_dw, NULL); 
+  fold_perf->reset(); 
+  int seq = 0; 
+  for ( ; ; ++seq) {
+    AzTETrainer_Ret ret = trainer->proceed_until(); 
+    AzDvect v_p; 
+    AzTE_ModelInfo info; 
+    trainer->apply(&td, &v_p, &info); 
+
+    AzPerfResult res = AzTaskTools::eval(&v_p, &v_test_y, trainer->lossType()); 
+    AzBytArr s("seq,");s.cn(seq+1); 
+    s.c(",acc,");s.cn(res.acc,6); 
+    s.c(",rmse,");s.cn(res.rmse,6); 
+    s.c(",loss,");s.cn(res.loss,6); 
+    s.c(",#leaf,"); s.cn(info.leaf_num); 
+    s.c(",#tree,"); s.cn(info.tree_num); 
+    AzPrint::writeln(out, s); 
+    *(fold_perf->new_slot()) = res; 
+
+    if (ret == AzTETrainer_Ret_Exit) {
+      break;   
+    }
+  }
+}
+
+/*------------------------------------------------------------------*/
+void AzTETproc::sweep(const AzOut &out, 
+                      const AzStrPool *sp_config, 
+                      const AzTETselector *alg_sel, 
+                      const char *alg_name, 
+                      int th_num, 
+                      const AzDataForTrTree *data, 
+                      const AzDvect *v_y, 
+                      const AzSvFeatInfo *featInfo,
+                      const AzDvect *v_dw, /* may be NULL */
+                      /*---  for evaluation  ---*/
+                      const AzSmat *m_test_x, 
+                      const AzDvect *v_test_y, 
+                      const char *sweep_fn)
+{
+  int c_num = sp_config->size(); 
+  AzFile file(sweep_fn); 
+  file.open("wb"); 
+  th_num = MAX(1, MIN(th_num, c_num)); 
+  int cx; 
+  for (cx = 0; cx < c_num; cx += th_num) {
+    int num = MIN(th_num, c_num - cx); 
+    AzDataArr<AzBytArr> arr_result(num); 
+    if (num == 1) {
+      sweep_config(out, cx, c_num, alg_sel, alg_name, sp_config->c_str(cx), 
+                   data, v_y, featInfo, v_dw, m_test_x, v_test_y, arr_result.point_u(0)); 
+    }
+    else {
+      /*---  configurations in parallel; the log of each is kept and shown in order  ---*/
+      AzDataArr<stringstream> arr_log(num); 
+      AzThreadErr th_err; 
+      int thx; 
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(num) schedule(static,1)
+#endif
+      for (thx = 0; thx < num; ++thx) {
+        try {
+          AzOut c_out; 
+          if (!out.isNull()) c_out.reset(arr_log.point_u(thx)); 
+          sweep_config(c_out, cx+thx, c_num, alg_sel, alg_name, sp_config->c_str(cx+thx), 
+                       data, v_y, featInfo, v_dw, m_test_x, v_test_y, arr_result.point_u(thx)); 
+        }
+        catch (AzException *e) {
+          th_err.keep(e); 
+        }
+      }
+      for (thx = 0; thx < num; ++thx) {
+        AzPrint::write(out, arr_log.point(thx)->str().c_str()); 
+      }
+      th_err.throw_if(); 
+    }
+
+    /*---  write the results as they become available  ---*/
+    int ix; 
+    for (ix = 0; ix < num; ++ix) {
+      arr_result.point(ix)->writeText(&file); 
+    }
+    file.flush(); 
+  }
+  file.close(true); 
+}
+
+/*------------------------------------------------------------------*/
+void AzTETproc::sweep_config(const AzOut &out, 
+                      int cx, 
+                      int c_num, 
+                      const AzTETselector *alg_sel, 
+                      const char *alg_name, 
+                      const char *config, 
+                      const AzDataForTrTree *data, 
+                      const AzDvect *v_y, 
+                      const AzSvFeatInfo *featInfo,
+                      const AzDvect *v_dw, /* may be NULL */
+                      const AzSmat *m_test_x, 
+                      const AzDvect *v_test_y, 
+                      /*---  output  ---*/
+                      AzBytArr *s_result)
+{
+  AzBytArr s("-----  "); s.cn(cx+1); s.c("/"); s.cn(c_num); s.c(" "); s.c(config); 
+  AzTimeLog::print(s, out); 
+
+  /*---  startup destroys its input; the data itself is shared  ---*/
+  AzSmat m_train_x; 
+  AzDvect v_train_y(v_y), v_fixed_dw; 
+  if (!AzDvect::isNull(v_dw)) v_fixed_dw.set(v_dw); 
+  AzSmat m_test_x_copy(m_test_x); 
+  AzTETrainer_TestData td(out, &m_test_x_copy); 
+
+  AzTETrainer *trainer = alg_sel->newTrainer(alg_name); 
+  try {
+    trainer->reset_shared_data(data); 
+    trainer->startup(out, config, &m_train_x, &v_train_y, featInfo, &v_fixed_dw, NULL); 
+    sweep_test(out, cx, trainer, config, &td, v_test_y, s_result); 
+  }
+  catch (AzException *e) {
+    delete trainer; 
+    throw e; 
+  }
+  delete trainer; 
+}
+
+/*------------------------------------------------------------------*/
+void AzTETproc::sweep_test(const AzOut &out, 
+                      int cx, 
+                      AzTETrainer *trainer, 
+                      const char *config, 
+                      AzTETrainer_TestData *td, 
+                      const AzDvect *v_test_y, 
+                      /*---  output  ---*/
+                      AzBytArr *s_result)
+{
+  AzBytArr s_cfg(config); 
+  s_cfg.replace(',', ';'); 
+  s_result->reset(); 
+  int seq = 0; 
+  for ( ; ; ++seq) {
+    AzTETrainer_Ret ret = trainer->proceed_until(); 
+    AzDvect v_p; 
+    AzTE_ModelInfo info; 
+    trainer->apply(td, &v_p, &info); 
+
+    AzPerfResult res = AzTaskTools::eval(&v_p, v_test_y, trainer->lossType()); 
+    AzBytArr s("config,"); s.cn(cx+1); 
+    s.c(",seq,"); s.cn(seq+1); 
+    s.c(",#tree,"); s.cn(info.tree_num); 
+    s.c(",#leaf,"); s.cn(info.leaf_num); 
+    s.c(",acc,"); s.cn(res.acc,4); 
+    s.c(",rmse,"); s.cn(res.rmse,4); 
+    s.c(",sqerr,"); s.cn(res.rmse*res.rmse,6); 
+    s.c(","); s.c(loss_str[trainer->lossType()]); 
+    s.c(",loss,"); s.cn(res.loss,6); 
+    s.c(",#test,"); s.cn(v_p.rowNum()); 
+    s.c(",cfg,"); s.c(&s_cfg); 
+    AzPrint::writeln(out, s); 
+    s_result->concat(&s); 
+    s_result->nl(); 
+
+    if (ret == AzTETrainer_Ret_Exit) {
+      break;   
+    }
+  }
+}
+
+/*------------------------------------------------------------------*/
+/* All the trainers stop at the same check points (test_interval) as  */
+/* they share the configuration; a class that stops earlier keeps its */
+/* last forest in the later model files.                              */
+/*------------------------------------------------------------------*/
+void AzTETproc::train_multiclass(const AzOut &out, 
+                      const AzTETselector *alg_sel, 
+                      const char *alg_name, 
+                      int th_num, 
+                      const char *config, 
+                      const AzDataForTrTree *data, 
+                      const AzDvect *v_y, /* class labels */
+                      int class_num, 
+                      const AzSvFeatInfo *featInfo,
+                      const AzDvect *v_dw, /* may be NULL */
+                      const char *out_model_fn, 
+                      const char *out_model_names_fn, /* may be NULL */
+                      bool doCompact)
+{
+  const char *eyec = "AzTETproc::train_multiclass"; 
+
+  /*---  one-vs-rest targets  ---*/
+  int data_num = v_y->rowNum(); 
+  AzDataArr<AzDvect> arr_y(class_num); 
+  int cx; 
+  for (cx = 0; cx < class_num; ++cx) {
+    arr_y.point_u(cx)->reform(data_num); 
+    arr_y.point_u(cx)->set(-1); 
+  }
+  int dx; 
+  for (dx = 0; dx < data_num; ++dx) {
+    double y = v_y->get(dx); 
+    int label = (int)y; 
+    if (label != y || label < 0 || label >= class_num) {
+      AzBytArr s("Class labels must be integers from 0 to "); s.cn(class_num-1); 
+      s.c(": "); s.cn(y); s.c(" for data#"); s.cn(dx+1); 
+      throw new AzException(AzInputError, eyec, s.c_str()); 
+    }
+    arr_y.point_u(label)->set(dx, 1); 
+  }
+
+  th_num = MAX(1, MIN(th_num, class_num)); 
+  AzDataArr<AzTETrainer *> arr_trainer(class_num); 
+  for (cx = 0; cx < class_num; ++cx) {
+    *arr_trainer.point_u(cx) = alg_sel->newTrainer(alg_name); 
+  }
+  try {
+    AzIntArr ia_done(class_num, 0); 
+    AzBytArr s_model_names; 
+    int seq_no = 1; 
+    bool doStart = true; 
+    for ( ; ; ) {
+      /*---  classes in parallel; the log of each is kept and shown in order  ---*/
+      AzDataArr<stringstream> arr_log(class_num); 
+      AzThreadErr th_err; 
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(th_num) schedule(dynamic,1)
+#endif
+      for (cx = 0; cx < class_num; ++cx) {
+        if (ia_done.get(cx)) continue; 
+        try {
+          AzOut c_out = out; 
+          if (th_num > 1) {
+            c_out = AzOut(); 
+            if (!out.isNull()) c_out.reset(arr_log.point_u(cx)); 
+          }
+          AzTETrainer *trainer = *arr_trainer.point(cx); 
+          AzTimeLog::print("-----  class#", cx, c_out); 
+          if (doStart) {
+            /*---  startup destroys its input; the data itself is shared  ---*/
+            AzSmat m_train_x; 
+            AzDvect v_fixed_dw; 
+            if (!AzDvect::isNull(v_dw)) v_fixed_dw.set(v_dw); 
+            trainer->reset_shared_data(data); 
+            trainer->startup(c_out, config, &m_train_x, arr_y.point_u(cx), featInfo, &v_fixed_dw, NULL); 
+          }
+          AzTETrainer_Ret ret = trainer->proceed_until(); 
+          if (ret == AzTETrainer_Ret_Exit) ia_done.update(cx, 1); 
+        }
+        catch (AzException *e) {
+          th_err.keep(e); 
+        }
+      }
+      if (th_num > 1) {
+        for (cx = 0; cx < class_num; ++cx) {
+          AzPrint::write(out, arr_log.point(cx)->str().c_str()); 
+        }
+      }
+      th_err.throw_if(); 
+      doStart = false; 
+
+      if (out_model_fn != NULL) {
+        AzTreeEnsembleMulti multi; 
+        multi.reset(class_num); 
+        for (cx = 0; cx < class_num; ++cx) {
+          (*arr_trainer.point(cx))->copy_to(multi.ens_u(cx)); 
+        }
+        if (doCompact) {
+          AzTE_ModelInfo info; 
+          multi.info(&info); 
+          int node_num = multi.nodeNum(); 
+          int merged_num = multi.compact(); 
+          AzTE_ModelInfo new_info; 
+          multi.info(&new_info); 
+          show_compact(out, info.tree_num, node_num, new_info.tree_num, multi.nodeNum(), merged_num); 
+        }
+        AzBytArr s; 
+        gen_model_fn(out_model_fn, seq_no, &s); 
+        AzTimeLog::print("Writing multi-output model: seq#=", seq_no, out); 
+        multi.write(s.c_str()); 
+        s.nl(); 
+        s_model_names.concat(&s); 
+        ++seq_no; 
+      }
+      if (ia_done.count(1) >= class_num) {
+        break; 
+      }
+    }
+    end_of_saving_models(seq_no - 1, s_model_names, out_model_names_fn, out); 
+  }
+  catch (AzException *e) {
+    for (cx = 0; cx < class_num; ++cx) delete *arr_trainer.point(cx); 
+    throw e; 
+  }
+  for (cx = 0; cx < class_num; ++cx) delete *arr_trainer.point(cx); 
+}
+
 /*------------------------------------------------------------------*/
 void AzTETproc::features(const AzOut &out, 
                       const AzTreeEnsemble *ens, 
@@ -24,8 +24,11 @@
 
 #include "AzUtil.hpp"
 #include "AzIntPool.hpp"
+#include "AzStrPool.hpp"
 #include "AzTETrainer.hpp"
+#include "AzTETselector.hpp"
 #include "AzTET_Eval.hpp"
+#include "AzPerfResult.hpp"
 
 //! Call tree ensemble trainer.
 class AzTETproc {
@@ -42,7 +45,32 @@ public:
                     /*---  data point weights  ---*/
                     AzDvect *v_fixed_dw=NULL, /* may be NULL */
                     /*---  for warm start  ---*/
-                    AzTreeEnsemble *inp_ens=NULL); /* may be NULL */
+                    AzTreeEnsemble *inp_ens=NULL, /* may be NULL */
+                    /*---  written at every check point; resumed from if it exists  ---*/
+                    const char *checkpoint_fn=NULL, /* may be NULL */
+                    bool doCompact=false); /* compact the models before saving */
+
+  /*---  test on validation data at every check point, stop when it  ---*/
+  /*---  stops improving, and save the best model only                ---*/
+  static void train_valid(const AzOut &out, 
+                        AzTETrainer *trainer, 
+                        const char *config, 
+                        AzSmat *m_train_x, 
+                        AzDvect *v_train_y, 
+                        const AzSvFeatInfo *featInfo,
+                        /*---  for validation  ---*/
+                        AzSmat *m_valid_x, 
+                        const AzDvect *v_valid_y, 
+                        AzPerfType perf_type, 
+                        int patience, /* #check points without improvement; 0: never stop */
+                        /*---  for writing model to file  ---*/
+                        const char *out_model_fn, 
+                        const char *out_model_list_fn=NULL, 
+                        /*---  data point weights  ---*/
+                        AzDvect *v_fixed_dw=NULL, /* may be NULL */
+                        /*---  for warm start  ---*/
+                        AzTreeEnsemble *inp_ens=NULL, /* may be NULL */
+                        bool doCompact=false); /* compact the model before saving */
 
   static void train_test(const AzOut &out, 
                         AzTETrainer *trainer, 
@@ -150,19 +178,115 @@ public:
                         bool doShuffle, 
                         AzTETrainer *trainer, 
                         const char *config, 
-                        AzSmat *m_x, 
-                        AzDvect *v_y, 
+                        const AzSmatc *m_x, 
+                        const AzDvect *v_y, 
                         const AzSvFeatInfo *featInfo,
                         /*---  data point weights  ---*/
-                        AzDvect *v_dw); /* may be NULL */
+                        const AzDvect *v_dw) { /* may be NULL */
+    xv(out, xv_num, xv_fn, doShuffle, &trainer, 1, config, m_x, v_y, featInfo, v_dw); 
+  }
+
+  /*---  up to th_num folds at a time, each with its own trainer;  ---*/
+  /*---  the folds take their data points from m_x without copying  ---*/
+  static void xv(const AzOut &out, 
+                        int xv_num, 
+                        const char *xv_fn, 
+                        bool doShuffle, 
+                        AzTETrainer **trainers, /* [th_num] */
+                        int th_num, 
+                        const char *config, 
+                        const AzSmatc *m_x, 
+                        const AzDvect *v_y, 
+                        const AzSvFeatInfo *featInfo,
+                        /*---  data point weights  ---*/
+                        const AzDvect *v_dw); /* may be NULL */
+
+  /*---  train with each configuration on the same pre-sorted data and  ---*/
+  /*---  test at every check point; up to th_num configurations at a time,  ---*/
+  /*---  each with a new trainer so that nothing is carried over           ---*/
+  static void sweep(const AzOut &out, 
+                        const AzStrPool *sp_config, 
+                        const AzTETselector *alg_sel, 
+                        const char *alg_name, 
+                        int th_num, 
+                        const AzDataForTrTree *data, 
+                        const AzDvect *v_y, 
+                        const AzSvFeatInfo *featInfo,
+                        const AzDvect *v_dw, /* may be NULL */
+                        /*---  for evaluation  ---*/
+                        const AzSmat *m_test_x, 
+                        const AzDvect *v_test_y, 
+                        const char *sweep_fn); 
+
+  /*---  one-vs-rest: one trainer per class on the same pre-sorted data; up to  ---*/
+  /*---  th_num classes at a time; one multi-output model per check point     ---*/
+  static void train_multiclass(const AzOut &out, 
+                        const AzTETselector *alg_sel, 
+                        const char *alg_name, 
+                        int th_num, 
+                        const char *config, 
+                        const AzDataForTrTree *data, 
+                        const AzDvect *v_y, /* class labels: 0,1,...,class_num-1 */
+                        int class_num, 
+                        const AzSvFeatInfo *featInfo,
+                        const AzDvect *v_dw, /* may be NULL */
+                        /*---  for writing model to file  ---*/
+                        const char *out_model_fn, 
+                        const char *out_model_names_fn=NULL, 
+                        bool doCompact=false); /* compact the models before saving */
 
 protected:
+  static void sweep_config(const AzOut &out, 
+                        int cx, 
+                        int c_num, 
+                        const AzTETselector *alg_sel, 
+                        const char *alg_name, 
+                        const char *config, 
+                        const AzDataForTrTree *data, 
+                        const AzDvect *v_y, 
+                        const AzSvFeatInfo *featInfo,
+                        const AzDvect *v_dw, /* may be NULL */
+                        const AzSmat *m_test_x, 
+                        const AzDvect *v_test_y, 
+                        /*---  output  ---*/
+                        AzBytArr *s_result); /* one line for each check point */
+  static void sweep_test(const AzOut &out, 
+                        int cx, 
+                        AzTETrainer *trainer, 
+                        const char *config, 
+                        AzTETrainer_TestData *td, 
+                        const AzDvect *v_test_y, 
+                        /*---  output  ---*/
+                        AzBytArr *s_result); /* one line for each check point */
+  static void xv_fold(const AzOut &out, 
+                        int xx, 
+                        int xv_num, 
+                        const int *dxs, /* data points in the order of the folds */
+                        int bx, int ex, /* test data: dxs[bx], ..., dxs[ex-1] */
+                        AzTETrainer *trainer, 
+                        const char *config, 
+                        const AzSmatc *m_x, 
+                        const AzDvect *v_y, 
+                        const AzSvFeatInfo *featInfo,
+                        const AzDvect *v_dw, /* may be NULL */
+                        /*---  output  ---*/
+                        AzDataPool<AzPerfResult> *fold_perf); 
   static void writeModel(AzTreeEnsemble *ens, 
                          int seq_no, 
                          const char *fn_stem, 
                          AzBytArr *s_model_fn, /* output */
                          AzBytArr *s_model_names,  /* output */
-                         const AzOut &out); 
+                         const AzOut &out, 
+                         bool doCompact=false); 
+  static void show_compact(const AzOut &out, 
+                           int org_tree_num, int org_node_num, 
+                           int tree_num, int node_num, 
+                           int merged_num); 
+  static void writeCheckpoint(AzTETrainer *trainer, 
+                              int seq_no, 
+                              const AzBytArr &s_model_names, 
+                              const char *checkpoint_fn, 
+                              const AzOut &out); 
   static void end_of_saving_models(int model_num, 
                                    const AzBytArr &s_model_names, 
                                    const char *out_model_names_fn, 
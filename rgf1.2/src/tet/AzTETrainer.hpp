@@ -24,6 +24,7 @@
 #include "AzLoss.hpp"
 #include "AzHelp.hpp"
 #include "AzDataForTrTree.hpp"
+#include "AzDataCache.hpp"
 #include "AzTE_ModelInfo.hpp"
 #include "AzTreeEnsemble.hpp"
 
@@ -51,6 +52,17 @@ public:
     m_test_x->destroy(); 
     _t = 0; _b.reset(); _v.reform(0); 
   }
+  /*---  the data points (columns) in ia_dxs (all if NULL); m_test_x is not changed  ---*/
+  void reset(const AzOut &out, 
+             const AzSmatc *m_test_x, 
+             const AzIntArr *ia_dxs) {
+    if (m_test_x == NULL) {
+      throw new AzException("AzTETrainer_TestData::reset", "test input is null"); 
+    }
+    data_dflt.reset_data_for_test(out, m_test_x, ia_dxs); 
+    data = &data_dflt; 
+    _t = 0; _b.reset(); _v.reform(0); 
+  }
 
   friend class AzTETrainer; 
 
@@ -68,6 +80,8 @@ protected:
 /* Abstract class: Tree ensemble trainer */
 class AzTETrainer {
 public:
+  virtual ~AzTETrainer() {} /* deleted through this type (e.g., AzRgfTrainerSel::newTrainer) */
+
   /*---  training  ---*/
   //! Start training.  Preparation.   
   virtual void startup(
@@ -80,9 +94,60 @@ public:
               AzTreeEnsemble *inp_ens=NULL) //!< for warm start; will be destroyed
               = 0; 
 
+  //! Take training data from the binary data cache in the next startup 
+  //! instead of m_x, which should be empty then.  
+  virtual void reset_data_cache(AzDataCache *cache) {
+    throw new AzException(AzInputNotValid, "AzTETrainer::reset_data_cache", 
+              "This algorithm does not support the binary data cache"); 
+  }
+
+  //! Take training data from the packed matrix in the next startup 
+  //! instead of m_x, which should be empty then.  m_x will be destroyed.  
+  virtual void reset_packed_data(AzSmatc *m_x) {
+    throw new AzException(AzInputNotValid, "AzTETrainer::reset_packed_data", 
+              "This algorithm does not support packed training data"); 
+  }
+
+  //! Same as above, but only the data points (columns) in ia_dxs; 
+  //! m_x is not changed and should be kept by the caller until startup returns.  
+  virtual void reset_packed_data(const AzSmatc *m_x, const AzIntArr *ia_dxs) {
+    throw new AzException(AzInputNotValid, "AzTETrainer::reset_packed_data", 
+              "This algorithm does not support packed training data"); 
+  }
+
+  //! Train on the given data, already sorted, in the next startup 
+  //! instead of m_x, which should be empty then.  The data is not copied 
+  //! and should be kept by the caller until the training is done.  
+  virtual void reset_shared_data(const AzDataForTrTree *shared) {
+    throw new AzException(AzInputNotValid, "AzTETrainer::reset_shared_data", 
+              "This algorithm does not support sharing training data"); 
+  }
+
   //! Do training until it's over or it's time to test.  
   virtual AzTETrainer_Ret proceed_until() = 0; 
 
+  //! Return true if write_checkpoint and resume are supported.  
+  virtual bool canCheckpoint() const { return false; }
+
+  //! Write the training state so that training can be resumed from this point.  
+  virtual void write_checkpoint(AzFile *file) {
+    throw new AzException(AzInputNotValid, "AzTETrainer::write_checkpoint", 
+              "This algorithm does not support checkpoints"); 
+  }
+
+  //! Resume training from a checkpoint instead of startup.  
+  //! The training data must be the same as when the checkpoint was written.  
+  virtual void resume(const AzOut &out, 
+              const char *param, 
+              AzSmat *m_x,   //!<training data; will be destroyed
+              AzDvect *v_y,  //!<training targets; will be destroyed
+              const AzSvFeatInfo *featInfo, 
+              AzDvect *v_data_weights, //!<data point weights; will be destroyed
+              AzFile *file) { //!<checkpoint
+    throw new AzException(AzInputNotValid, "AzTETrainer::resume", 
+              "This algorithm does not support checkpoints"); 
+  }
+
   //! Evaluate the tree ensemeble at the current stage of training.  
   virtual void 
   apply(AzTETrainer_TestData *td, /*!< test data */
@@ -113,10 +178,20 @@ protected:
                     const AzSvFeatInfo *featInfo, 
                     const char *eyec) const
   {
-    if (v_y->rowNum() != m_x->colNum()) {
+    check_data_consistency(m_x->colNum(), m_x->rowNum(), v_y, v_fixed_dw, featInfo, eyec); 
+  }
+  virtual void check_data_consistency(
+                    int data_num, 
+                    int feat_num, 
+                    const AzDvect *v_y, 
+                    const AzDvect *v_fixed_dw, 
+                    const AzSvFeatInfo *featInfo, 
+                    const char *eyec) const
+  {
+    if (v_y->rowNum() != data_num) {
       throw new AzException(AzInputError, eyec, "#data conflict"); 
     }
-    if (featInfo != NULL && featInfo->featNum() != m_x->rowNum()) {
+    if (featInfo != NULL && featInfo->featNum() != feat_num) {
       throw new AzException(AzInputError, eyec, "#feat conflict"); 
     }
     if (!AzDvect::isNull(v_fixed_dw)) {
@@ -30,6 +30,11 @@ public:
                               bool dontThrow=false
                               ) const = 0; 
 
+  //! Return a new trainer, which the caller must delete; for training in parallel. 
+  virtual AzTETrainer *newTrainer(const char *alg_name) const {
+    throw new AzException("AzTETselector::newTrainer", "Not supported:", alg_name); 
+  }
+
   virtual const char *dflt_name() const = 0; 
   virtual const char *another_name() const = 0; 
   virtual const AzStrArray *names() const = 0; 
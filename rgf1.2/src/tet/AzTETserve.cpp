@@ -0,0 +1,321 @@
+/* * * * *
+ *  AzTETserve.cpp
+ *  Copyright (C) 2011, 2012 Rie Johnson
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * */
+
+#include "AzTETserve.hpp"
+#include "AzSvDataStream.hpp"
+#include "AzPrint.hpp"
+#include "AzTools.hpp"
+
+#ifdef _WIN32
+#include <io.h>
+#define az_read _read
+#define az_write _write
+#else
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#define az_read read
+#define az_write write
+#endif
+
+/*------------------------------------------------------------------*/
+void AzTETserver::reset(const AzStrPool *inp_sp_model_fn,
+                        int inp_batch_size,
+                        int inp_num_threads,
+                        const AzOut &out)
+{
+  const char *eyec = "AzTETserver::reset"; 
+  sp_model_fn.reset(inp_sp_model_fn); 
+  batch_size = MAX(1, inp_batch_size); 
+  num_threads = inp_num_threads; 
+  int m_num = sp_model_fn.size(); 
+  if (m_num <= 0) {
+    throw new AzException(AzInputNotValid, eyec, "No model"); 
+  }
+  arr_flat.reset(m_num); 
+  f_num = -1; 
+  int mx; 
+  for (mx = 0; mx < m_num; ++mx) {
+    const char *model_fn = sp_model_fn.c_str(mx); 
+    AzTreeEnsembleFlat *flat = arr_flat.point_u(mx); 
+    if (AzTreeEnsembleFlat::isPacked(model_fn)) {
+      flat->map(model_fn); /* shared with the other processes using it */
+      if (flat->outNum() != 1) {
+        throw new AzException(AzInputNotValid, eyec, "A multi-output model is not supported:", model_fn); 
+      }
+    }
+    else {
+      AzTreeEnsemble ens(model_fn); 
+      flat->reset(&ens); 
+    }
+    if (flat->orgdim() <= 0) {
+      throw new AzException(AzInputNotValid, eyec, "#feature is unknown:", model_fn); 
+    }
+    if (f_num < 0) f_num = flat->orgdim(); 
+    else if (flat->orgdim() != f_num) {
+      AzBytArr s("#feature conflict: "); s.c(sp_model_fn.c_str(0)); s.c(" vs. "); s.c(model_fn); 
+      throw new AzException(AzInputNotValid, eyec, s.c_str()); 
+    }
+    if (!out.isNull()) {
+      AzTE_ModelInfo info; 
+      flat->info(&info); 
+      AzBytArr s(model_fn); s.c(": #tree="); s.cn(info.tree_num); 
+      s.c(", #node="); s.cn(flat->nodeNum()); 
+      AzPrint::writeln(out, s); 
+    }
+  }
+  arr_ifa.reset(batch_size); 
+}
+
+/*------------------------------------------------------------------*/
+void AzTETserver::serve_stdio(const AzOut &out)
+{
+  AzTimeLog::print("Serving on stdin ... ", out); 
+  int line_num = session(0, 1); 
+  AzTimeLog::print("End of input; #line=", line_num, out); 
+}
+
+/*------------------------------------------------------------------*/
+void AzTETserver::serve_socket(const char *path,
+                               int timeout, /* seconds; 0: none */
+                               const AzOut &out)
+{
+  const char *eyec = "AzTETserver::serve_socket"; 
+#ifdef _WIN32
+  throw new AzException(AzInputNotValid, eyec, "Unix domain sockets are not supported on this platform.  Use stdin."); 
+#else
+  struct sockaddr_un addr; 
+  if (strlen(path) >= sizeof(addr.sun_path)) {
+    throw new AzException(AzInputNotValid, eyec, "Socket path is too long:", path); 
+  }
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0); 
+  if (fd < 0) {
+    throw new AzException(AzFileIOError, eyec, "socket", strerror(errno)); 
+  }
+  memset(&addr, 0, sizeof(addr)); 
+  addr.sun_family = AF_UNIX; 
+  strcpy(addr.sun_path, path); 
+  struct stat st; 
+  if (lstat(path, &st) == 0) {
+    if (!S_ISSOCK(st.st_mode)) {
+      close(fd); 
+      throw new AzException(AzInputNotValid, eyec, "Not a socket; not removed:", path); 
+    }
+    unlink(path); /* left by a previous run */
+  }
+  if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 16) != 0) {
+    AzBytArr s(path); s.c(": "); s.c(strerror(errno)); 
+    close(fd); 
+    throw new AzException(AzFileIOError, eyec, "bind/listen", s.c_str()); 
+  }
+  signal(SIGPIPE, SIG_IGN); /* a client may go away before reading the response */
+  AzTimeLog::print("Listening on ", path, out); 
+  doShutdown = false; 
+  try {
+    for ( ; !doShutdown; ) {
+      int conn = accept(fd, NULL, NULL); 
+      if (conn < 0) {
+        if (errno == EINTR) continue; 
+        throw new AzException(AzFileIOError, eyec, "accept", strerror(errno)); 
+      }
+      if (timeout > 0) {
+        /*---  one client at a time; don't let an idle one stall the others  ---*/
+        struct timeval tv; 
+        tv.tv_sec = timeout; tv.tv_usec = 0; 
+        setsockopt(conn, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)); 
+        setsockopt(conn, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv)); 
+      }
+      try {
+        session(conn, conn); 
+      }
+      catch (AzException *e) {
+        /*---  the client has gone; keep serving  ---*/
+        AzPrint::writeln(out, e->getMessage().c_str()); 
+        delete e; 
+      }
+      close(conn); 
+    }
+  }
+  catch (AzException *e) {
+    close(fd); unlink(path); 
+    throw e; 
+  }
+  close(fd); 
+  unlink(path); 
+  AzTimeLog::print("Shut down", out); 
+#endif
+}
+
+/*------------------------------------------------------------------*/
+/* Read until the end of input or "#quit", scoring the complete lines */
+/* received so far batch_size lines at a time.                        */
+int AzTETserver::session(int fd_in, int fd_out)
+{
+  const char *eyec = "AzTETserver::session"; 
+  AzBytArr s_data; /* received but not processed yet */
+  AzBytArr ba_buff; 
+  AzByte *buff = ba_buff.reset(read_size, 0); 
+  int line_no = 0; 
+  bool isEnd = false; 
+  for ( ; !isEnd; ) {
+    int len = (int)az_read(fd_in, buff, read_size); 
+#ifndef _WIN32
+    if (len < 0 && errno == EINTR) continue; 
+    if (len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      throw new AzException(AzFileIOError, eyec, "No input within the time limit; disconnected"); 
+    }
+#endif
+    if (len < 0) {
+      throw new AzException(AzFileIOError, eyec, "read"); 
+    }
+    bool isEof = (len == 0); 
+    if (isEof) {
+      if (s_data.length() > 0) s_data.concat("\n"); /* last line without '\n' */
+    }
+    else {
+      s_data.concat(buff, len); 
+    }
+
+    /*---  find complete lines  ---*/
+    const AzByte *data = s_data.point(); 
+    int data_len = s_data.length(); 
+    int offs = 0; 
+    AzIntArr ia_begin_end; 
+    bool isQuit = false; 
+    for ( ; offs < data_len; ) {
+      const AzByte *nl = (const AzByte *)memchr(data+offs, '\n', data_len-offs); 
+      if (nl == NULL) break; 
+      int end = Az64::ptr_diff(nl-data); 
+      int line_len = end - offs; 
+      if (line_len > 0 && data[offs] == '#') { /* command */
+        AzBytArr s_cmd(data+offs, line_len); s_cmd.strip(); 
+        if (s_cmd.compare("#quit") == 0 || s_cmd.compare("#shutdown") == 0) {
+          if (s_cmd.compare("#shutdown") == 0) doShutdown = true; 
+          isQuit = true; 
+          offs = end + 1; 
+          break; 
+        }
+      }
+      ia_begin_end.put(offs); ia_begin_end.put(end); 
+      offs = end + 1; 
+      if (ia_begin_end.size()/2 >= batch_size) {
+        AzBytArr s_out; 
+        score(data, &ia_begin_end, line_no, &s_out); 
+        write_all(fd_out, &s_out); 
+        line_no += ia_begin_end.size()/2; 
+        ia_begin_end.reset(); 
+      }
+    }
+    if (ia_begin_end.size() > 0) {
+      AzBytArr s_out; 
+      score(data, &ia_begin_end, line_no, &s_out); 
+      write_all(fd_out, &s_out); 
+      line_no += ia_begin_end.size()/2; 
+    }
+    /*---  keep the incomplete line  ---*/
+    AzBytArr s_remain(data+offs, data_len-offs); 
+    s_data.reset(&s_remain); 
+    isEnd = (isEof || isQuit); 
+  }
+  return line_no; 
+}
+
+/*------------------------------------------------------------------*/
+void AzTETserver::score(const AzByte *data,
+                        const AzIntArr *ia_begin_end,
+                        int line_no,
+                        AzBytArr *s_out) /* output */
+{
+  int num = ia_begin_end->size() / 2; 
+  ia_isOk.reset(num, 0); 
+  sp_err.reset(); 
+  int ok_num = 0; 
+  int ix; 
+  for (ix = 0; ix < num; ++ix) {
+    int begin = ia_begin_end->get(ix*2), end = ia_begin_end->get(ix*2+1); 
+    const AzByte *line = data + begin; 
+    int len = end - begin; 
+    bool isSparse = (memchr(line, ':', len) != NULL); 
+    try {
+      /*---  make it a C string for the parser  ---*/
+      AzBytArr s_line(line, len); 
+      AzSvDataStream::parseLine(s_line.point(), s_line.length(), f_num, isSparse,
+                                "request", line_no+ix+1, arr_ifa.point_u(ok_num)); 
+      ia_isOk.update(ix, 1); 
+      ++ok_num; 
+    }
+    catch (AzException *e) {
+      AzBytArr s_err("error: "); s_err.c(e->getMessage().c_str()); 
+      s_err.replace('\n', ' '); s_err.replace("  ", " "); s_err.strip(); 
+      sp_err.put(&s_err); 
+      delete e; 
+    }
+  }
+
+  /*---  apply the models to the valid lines  ---*/
+  AzSmat m_x(f_num, ok_num); 
+  for (ix = 0; ix < ok_num; ++ix) m_x.load(ix, arr_ifa.point_u(ix)); 
+  int m_num = arr_flat.size(); 
+  AzDataArr<AzDvect> arr_p(m_num); 
+  int mx; 
+  for (mx = 0; mx < m_num; ++mx) {
+    arr_flat.point(mx)->apply(&m_x, arr_p.point_u(mx), num_threads); 
+  }
+
+  int width = 8; 
+  int dx = 0, ex = 0; 
+  for (ix = 0; ix < num; ++ix) {
+    if (ia_isOk.get(ix)) {
+      for (mx = 0; mx < m_num; ++mx) {
+        if (mx > 0) s_out->c(" "); 
+        s_out->concatFloat(arr_p.point(mx)->get(dx), width); 
+      }
+      ++dx; 
+    }
+    else {
+      s_out->c(sp_err.c_str(ex++)); 
+    }
+    s_out->nl(); 
+  }
+}
+
+/*------------------------------------------------------------------*/
+/* static */
+void AzTETserver::write_all(int fd, const AzBytArr *s)
+{
+  const AzByte *ptr = s->point(); 
+  int len = s->length(); 
+  for ( ; len > 0; ) {
+    int written = (int)az_write(fd, ptr, len); 
+#ifndef _WIN32
+    if (written < 0 && errno == EINTR) continue; 
+    if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      throw new AzException(AzFileIOError, "AzTETserver::write_all", "Output not taken within the time limit; disconnected"); 
+    }
+#endif
+    if (written <= 0) {
+      throw new AzException(AzFileIOError, "AzTETserver::write_all", "write"); 
+    }
+    ptr += written; 
+    len -= written; 
+  }
+}
@@ -0,0 +1,81 @@
+/* * * * *
+ *  AzTETserve.hpp
+ *  Copyright (C) 2011, 2012 Rie Johnson
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * */
+
+#ifndef _AZ_TET_SERVE_HPP_
+#define _AZ_TET_SERVE_HPP_
+
+#include "AzUtil.hpp"
+#include "AzSmat.hpp"
+#include "AzDmat.hpp"
+#include "AzStrPool.hpp"
+#include "AzTreeEnsemble.hpp"
+#include "AzTreeEnsembleFlat.hpp"
+
+//! Keep models in memory and score feature rows sent over stdin or a Unix domain socket.
+/*-------------------------------------------------------------------
+ *  Protocol: one data point per line, in the dense format
+ *  ("val val ...") or the sparse format ("fx:val fx:val ...").
+ *  For each line, one line is returned with the predictions of the
+ *  models separated by a space, or "error: <message>".
+ *  The complete lines received by one read are scored together,
+ *  up to batch_size lines at a time.
+ *  "#quit" closes the connection; "#shutdown" stops the server.
+ *  Socket clients are served one at a time, in the order of
+ *  connection; a client that neither sends nor reads for the
+ *  timeout is disconnected.
+ *-------------------------------------------------------------------*/
+class AzTETserver {
+protected:
+  AzStrPool sp_model_fn; 
+  AzDataArr<AzTreeEnsembleFlat> arr_flat; 
+  int f_num; 
+  int batch_size; 
+  int num_threads; 
+  bool doShutdown; 
+
+  /*---  work area for a batch  ---*/
+  AzDataArr<AzIFarr> arr_ifa; 
+  AzIntArr ia_isOk; 
+  AzStrPool sp_err; 
+
+  static const int read_size = 65536; 
+
+public:
+  AzTETserver() : f_num(0), batch_size(1000), num_threads(1), doShutdown(false) {}
+
+  /*---  load the models  ---*/
+  void reset(const AzStrPool *inp_sp_model_fn,
+             int inp_batch_size,
+             int inp_num_threads,
+             const AzOut &out); 
+
+  void serve_stdio(const AzOut &out); /* until the end of stdin */
+  void serve_socket(const char *path, int timeout, const AzOut &out); /* until "#shutdown" */
+
+  inline int modelNum() const { return arr_flat.size(); }
+  inline int featNum() const { return f_num; }
+
+protected:
+  int session(int fd_in, int fd_out); /* returns #line */
+  void score(const AzByte *data,
+             const AzIntArr *ia_begin_end, /* [begin,end) of each line */
+             int line_no,
+             AzBytArr *s_out); /* output */
+  static void write_all(int fd, const AzBytArr *s); 
+}; 
+#endif
@@ -27,6 +27,8 @@ void AzTrTree::_release()
   a_node.free(&nodes); nodes_used = 0; 
   a_split.free(&split); 
   a_sorted_arr.free(&sorted_arr); 
+  a_hist.free(&hist); 
+  ba_sample.reset(); 
 
   root_nx = AzNone; 
   curr_min_pop = curr_max_depth = -1; 
@@ -37,6 +39,18 @@ void AzTrTree::_releaseWork()
 {
   a_split.free(&split); 
   a_sorted_arr.free(&sorted_arr);
+  a_hist.free(&hist); 
+  ba_sample.reset(); 
+}
+
+/*--------------------------------------------------------*/
+void AzTrTree::_releaseHist()
+{
+  if (hist == NULL) return; 
+  int nx; 
+  for (nx = 0; nx < nodes_used; ++nx) {
+    delete hist[nx]; hist[nx] = NULL; 
+  }
 }
 
 /*--------------------------------------------------------*/
@@ -117,6 +131,7 @@ int AzTrTree::_newNode(int max_size)
     a_node.realloc(&nodes, node_max, eyec, "node"); 
     a_split.realloc(&split, node_max, eyec, "split"); 
     a_sorted_arr.realloc(&sorted_arr, node_max, eyec, "sorted_arr"); 
+    a_hist.realloc(&hist, node_max, eyec, "hist"); 
   } 
   else {
     /*---  initialize the new node  ---*/
@@ -186,7 +201,8 @@ void AzTrTree::_splitNode(const AzDataForTrTree *data,
                         bool doUseInternalNodes, 
                         int nx,
                         const AzTrTsplit *inp, 
-                        const AzOut &out)
+                        const AzOut &out, 
+                        bool doKeepHist)
 {
   _checkNode(nx, "AzTrTree::splitNode"); 
 
@@ -194,27 +210,34 @@ void AzTrTree::_splitNode(const AzDataForTrTree *data,
   nodes[nx].border_val = inp->border_val; 
 
   AzIntArr ia_le, ia_gt; 
-  const AzSortedFeatArr *s_arr = sorted_arr[nx]; 
-  if (s_arr == NULL) {
-    if (nx == root_nx) {
-      s_arr = data->sorted_array(); 
+  if (data->binned_feat() != NULL) {
+    /*---  no sorted array with data_management=Hist  ---*/
+    data->isLE(nodes[nx].data_indexes(), nodes[nx].dxs_num, inp->fx, inp->border_val, 
+               &ia_le, &ia_gt); 
+  }
+  else {
+    const AzSortedFeatArr *s_arr = sorted_arr[nx]; 
+    if (s_arr == NULL) {
+      if (nx == root_nx) {
+        s_arr = data->sorted_array(); 
+      }
+      else {
+        throw new AzException("AzTrTree::_splitNode", "sorted_arr[nx]=null"); 
+      }
+    }
+    const AzSortedFeat *sorted = s_arr->sorted(inp->fx); 
+    if (sorted == NULL) {
+      AzSortedFeatWork tmp; 
+      const AzSortedFeat *my_sorted = sorted_arr[nx]->sorted(data->sorted_array(), 
+                                      inp->fx, &tmp); 
+      my_sorted->getIndexes(nodes[nx].dxs, nodes[nx].dxs_num, inp->border_val, 
+                            &ia_le, &ia_gt); 
     }
     else {
-      throw new AzException("AzTrTree::_splitNode", "sorted_arr[nx]=null"); 
+      sorted->getIndexes(nodes[nx].dxs, nodes[nx].dxs_num, inp->border_val, 
+                         &ia_le, &ia_gt); 
     }
   }
-  const AzSortedFeat *sorted = s_arr->sorted(inp->fx); 
-  if (sorted == NULL) {
-    AzSortedFeatWork tmp; 
-    const AzSortedFeat *my_sorted = sorted_arr[nx]->sorted(data->sorted_array(), 
-                                    inp->fx, &tmp); 
-    my_sorted->getIndexes(nodes[nx].dxs, nodes[nx].dxs_num, inp->border_val, 
-                          &ia_le, &ia_gt); 
-  }
-  else {
-    sorted->getIndexes(nodes[nx].dxs, nodes[nx].dxs_num, inp->border_val, 
-                       &ia_le, &ia_gt); 
-  }
 
   int le_offset = nodes[nx].dxs_offset; 
   int gt_offset = le_offset + ia_le.size(); 
@@ -248,6 +271,19 @@ void AzTrTree::_splitNode(const AzDataForTrTree *data,
     nodes[nx].weight = 0; 
   }
 
+  /*---  keep the histogram so that the children's can be derived from it  ---*/
+  if (hist != NULL && hist[nx] != NULL) {
+    if (doKeepHist) {
+      /*---  targets of the children will be lowered by these  ---*/
+      double w_inc = nodes[nx].weight - org_weight; 
+      hist[nx]->keep_for_children(nodes[le_nx].weight + w_inc, 
+                                  nodes[gt_nx].weight + w_inc); 
+    }
+    else {
+      delete hist[nx]; hist[nx] = NULL; 
+    }
+  }
+
   /*------------------------------*/
   dump_split(inp, nx, org_weight, out); 
 
@@ -466,12 +502,21 @@ const
 }
 
 /*--------------------------------------------------------*/
-void AzTrTree::copy_nodes_from(const AzTrTree_ReadOnly *inp) 
+void AzTrTree::copy_nodes_from(const AzTrTree_ReadOnly *inp, 
+                               bool doShareDataIndexes) 
 {
   const char *eyec = "AzTrTree::copy_nodes_from"; 
   _release(); 
   root_nx = inp->root(); 
   nodes_used = inp->nodeNum(); 
+  if (doShareDataIndexes) {
+    a_node.alloc(&nodes, nodes_used, eyec); 
+    int nx; 
+    for (nx = 0; nx < nodes_used; ++nx) {
+      nodes[nx] = *inp->node(nx); /* dxs points inp's */
+    }
+    return; 
+  }
   ia_root_dx.reset(inp->root_dx()); 
   const int *root_dxs = ia_root_dx.point(); 
   a_node.alloc(&nodes, nodes_used, eyec); 
@@ -484,6 +529,91 @@ void AzTrTree::copy_nodes_from(const AzTrTree_ReadOnly *inp)
   }
 }
 
+/*--------------------------------------------------------*/
+/* The sorted arrays and histograms are not written; they are */
+/* rebuilt from the data indexes when the nodes are searched. */
+/*--------------------------------------------------------*/
+void AzTrTree::write_checkpoint(AzFile *file)
+{
+  file->writeInt(root_nx); 
+  file->writeInt(nodes_used); 
+  file->writeInt(curr_min_pop); 
+  file->writeInt(curr_max_depth); 
+  file->writeBool(isBagging); 
+  int nx; 
+  for (nx = 0; nx < nodes_used; ++nx) {
+    nodes[nx].write(file); 
+    file->writeInt(nodes[nx].depth); 
+    file->writeInt(nodes[nx].dxs_offset); 
+    file->writeInt(nodes[nx].dxs_num); 
+  }
+
+  /*---  the root has all the data indexes  ---*/
+  int dxs_num = (nodes_used > 0) ? nodes[root_nx].dxs_num : 0; 
+  file->writeInt(dxs_num); 
+  if (dxs_num > 0) {
+    file->writeBytes(nodes[root_nx].data_indexes(), (AZint8)sizeof(int)*dxs_num); 
+  }
+
+  file->writeBool(split != NULL); 
+  if (split != NULL) {
+    for (nx = 0; nx < nodes_used; ++nx) {
+      AzObjIOTools::write(split[nx], file); 
+    }
+  }
+  ba_sample.write(file); 
+}
+
+/*--------------------------------------------------------*/
+void AzTrTree::read_checkpoint(AzFile *file, 
+                               const AzDataForTrTree *data)
+{
+  const char *eyec = "AzTrTree::read_checkpoint"; 
+  _release(); 
+  root_nx = file->readInt(); 
+  int node_num = file->readInt(); 
+  curr_min_pop = file->readInt(); 
+  curr_max_depth = file->readInt(); 
+  isBagging = file->readBool(); 
+  a_node.alloc(&nodes, node_num, eyec, "nodes"); 
+  nodes_used = node_num; 
+  int nx; 
+  for (nx = 0; nx < nodes_used; ++nx) {
+    nodes[nx].read(file); 
+    nodes[nx].depth = file->readInt(); 
+    nodes[nx].dxs_offset = file->readInt(); 
+    nodes[nx].dxs_num = file->readInt(); 
+  }
+
+  int dxs_num = file->readInt(); 
+  ia_root_dx.reset(dxs_num, -1); 
+  if (dxs_num > 0) {
+    file->readBytes(ia_root_dx.point_u(), (AZint8)sizeof(int)*dxs_num); 
+  }
+  const int *root_dxs = ia_root_dx.point(); 
+  for (nx = 0; nx < nodes_used; ++nx) {
+    if (nodes[nx].dxs_offset < 0) continue; 
+    if (nodes[nx].dxs_offset+nodes[nx].dxs_num > dxs_num) {
+      throw new AzException(AzInputError, eyec, "conflict in data indexes"); 
+    }
+    nodes[nx].dxs = root_dxs + nodes[nx].dxs_offset; 
+  }
+
+  bool isSearchable = file->readBool(); 
+  if (isSearchable) {
+    a_split.alloc(&split, nodes_used, eyec, "split"); 
+    a_sorted_arr.alloc(&sorted_arr, nodes_used, eyec, "sorted_arr"); 
+    a_hist.alloc(&hist, nodes_used, eyec, "hist"); 
+    for (nx = 0; nx < nodes_used; ++nx) {
+      split[nx] = AzObjIOTools::read<AzTrTsplit>(file); 
+    }
+    if (nodes_used > 0 && data->binned_feat() == NULL) {
+      sorted_array(root_nx, data); /* the base for the others */
+    }
+  }
+  ba_sample.read(file); 
+}
+
 /*--------------------------------------------------------*/
 const int *AzTrTree::set_data_indexes(int offset, 
                      const int *dxs, 
@@ -541,7 +671,9 @@ void AzTrTree::warmup(const AzTreeNodes *inp,
       throw new AzException(eyec, "something is wrong with split order"); 
     }
 
-    sorted_array(split_nx, data); 
+    if (data->binned_feat() == NULL) {
+      sorted_array(split_nx, data); 
+    }
 
     const AzTreeNode *inp_np = inp->node(split_nx); 
     double dummy_gain = 1.0; 
@@ -602,6 +734,7 @@ void AzTrTree::quick_warmup(const AzTreeNodes *inp,
   a_node.alloc(&nodes, nodes_used, eyec, "nodes"); 
   a_split.free(&split); 
   a_sorted_arr.free(&sorted_arr); 
+  a_hist.free(&hist); 
   int nx; 
   for (nx = 0; nx < nodes_used; ++nx) {
     const AzTreeNode *inp_np = inp->node(nx); 
@@ -803,7 +936,8 @@ const AzSortedFeatArr *AzTrTree::sorted_array(int nx,
 
   const AzSortedFeatArr *inp = sorted_arr[px]; 
   if (inp == NULL) {
-    throw new AzException(eyec, "No input for separation"); 
+    /*---  resumed from a checkpoint: separate the ancestors first  ---*/
+    inp = sorted_array(px, data); 
   }
 
   /*---  make a new one and save it.  ---*/
@@ -827,3 +961,104 @@ const AzSortedFeatArr *AzTrTree::sorted_array(int nx,
   return sorted_arr[nx]; 
 }
 
+/*--------------------------------------------------------*/
+/* Histograms of the node's data for data_management=Hist. */
+/* If the parent's histogram was kept when it was split,   */
+/* only the smaller child is computed from scratch, and    */
+/* the other is obtained by subtraction.                   */
+/*--------------------------------------------------------*/
+const AzHistFeat *AzTrTree::histogram(int nx, 
+                             const AzDataForTrTree *data, 
+                             const AzTrTtarget *target) const
+{
+  const char *eyec = "AzTrTree::histogram"; 
+  _checkNode(nx, eyec); 
+  const AzBinnedFeat *binned = data->binned_feat(); 
+  if (binned == NULL) {
+    throw new AzException(eyec, "no binned features"); 
+  }
+  if (hist == NULL) {
+    throw new AzException(eyec, "no hist"); 
+  }
+
+  if (hist[nx] != NULL && hist[nx]->is_fresh()) {
+    /*---  derived when the sibling was searched  ---*/
+    hist[nx]->set_fresh(false); 
+    return hist[nx]; 
+  }
+
+  int px = nodes[nx].parent_nx; 
+  if (px >= 0 && hist[px] != NULL && hist[px]->canDerive()) {
+    int le_nx = nodes[px].le_nx, gt_nx = nodes[px].gt_nx; 
+    int small_nx = le_nx, large_nx = gt_nx; 
+    double small_shift = hist[px]->childShift(0), large_shift = hist[px]->childShift(1); 
+    if (nodes[gt_nx].dxs_num < nodes[le_nx].dxs_num) {
+      small_nx = gt_nx; large_nx = le_nx; 
+      small_shift = hist[px]->childShift(1); large_shift = hist[px]->childShift(0); 
+    }
+    if (hist[small_nx] == NULL) hist[small_nx] = new AzHistFeat(); 
+    if (hist[large_nx] == NULL) hist[large_nx] = new AzHistFeat(); 
+    AzIntArr ia_buff; 
+    int num; 
+    const int *dxs = sampled_dxs(sample_mask(), nodes[small_nx].data_indexes(), 
+                                 nodes[small_nx].dxs_num, &ia_buff, &num); 
+    hist[small_nx]->reset(binned, dxs, num, target); 
+    hist[large_nx]->reset_by_subtraction(hist[px], hist[small_nx], 
+                                         small_shift, large_shift); 
+    delete hist[px]; hist[px] = NULL; 
+
+    int sib_nx = (nx == le_nx) ? gt_nx : le_nx; 
+    hist[sib_nx]->set_fresh(true); 
+    return hist[nx]; 
+  }
+
+  /*---  from scratch  ---*/
+  if (hist[nx] == NULL) hist[nx] = new AzHistFeat(); 
+  AzIntArr ia_buff; 
+  int num; 
+  const int *dxs = sampled_dxs(sample_mask(), nodes[nx].data_indexes(), 
+                               nodes[nx].dxs_num, &ia_buff, &num); 
+  hist[nx]->reset(binned, dxs, num, target); 
+  return hist[nx]; 
+}
+
+/*--------------------------------------------------------*/
+/* Draw the rows used in node search.  A hash of the seed,  */
+/* the draw#, and the data# is used instead of rand() so    */
+/* that the same rows are drawn again after resuming from a */
+/* checkpoint, regardless of what else called rand().       */
+/*--------------------------------------------------------*/
+void AzTrTree::sample(double ratio, int data_num, int seed, int draw_no)
+{
+  ba_sample.reset(); 
+  if (ratio >= 1) return; 
+
+  unsigned int threshold = (unsigned int)(ratio * 4294967295.0); 
+  unsigned int key = AzTools::mix32((unsigned int)seed * 0x9e3779b9U + (unsigned int)draw_no); 
+  AzByte *mask = ba_sample.reset(data_num, 0); 
+  int dx; 
+  for (dx = 0; dx < data_num; ++dx) {
+    if (AzTools::mix32(key ^ (unsigned int)dx) <= threshold) mask[dx] = 1; 
+  }
+}
+
+/*--------------------------------------------------------*/
+const int *AzTrTree::sampled_dxs(const AzByte *mask, /* may be NULL */
+                                 const int *dxs, int dxs_num, 
+                                 AzIntArr *ia_buff, /* work */
+                                 int *out_num) /* output */
+{
+  if (mask == NULL) {
+    *out_num = dxs_num; 
+    return dxs; 
+  }
+  ia_buff->reset(dxs_num, -1); 
+  int *out_dxs = ia_buff->point_u(); 
+  int num = 0; 
+  int ix; 
+  for (ix = 0; ix < dxs_num; ++ix) {
+    if (mask[dxs[ix]]) out_dxs[num++] = dxs[ix]; 
+  }
+  *out_num = num; 
+  return out_dxs; 
+}
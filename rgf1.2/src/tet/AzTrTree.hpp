@@ -30,6 +30,7 @@
 #include "AzTrTtarget.hpp"
 #include "AzTrTreeNode.hpp"
 #include "AzTree.hpp"
+#include "AzDataIndexStore.hpp"
 
 /*---------------------------------------------*/
 /* Abstract class: Trainable Tree              */
@@ -54,12 +55,17 @@ protected:
   AzSortedFeatArr **sorted_arr; 
   AzObjPtrArray<AzSortedFeatArr> a_sorted_arr; 
 
+  AzHistFeat **hist;  /* used only with data_management=Hist */
+  AzObjPtrArray<AzHistFeat> a_hist; 
+
   int curr_min_pop, curr_max_depth; 
   bool isBagging; 
 
+  AzBytArr ba_sample; /* data# -> 1 if used in node search; empty: all */
+
 public:
   AzTrTree() : 
-    nodes_used(0), nodes(NULL), split(NULL), sorted_arr(NULL), root_nx(AzNone), 
+    nodes_used(0), nodes(NULL), split(NULL), sorted_arr(NULL), hist(NULL), root_nx(AzNone), 
     curr_min_pop(-1), curr_max_depth(-1), isBagging(false) {}
 
   /*---  derived classes must implement these             ---*/
@@ -74,6 +80,9 @@ public:
   /*---  for faster node search  ---*/
   virtual const AzSortedFeatArr *sorted_array(int nx, 
                              const AzDataForTrTree *data) const; 
+  virtual const AzHistFeat *histogram(int nx, 
+                             const AzDataForTrTree *data, 
+                             const AzTrTtarget *target) const; 
 
   /*---  information seeking ... ---*/
   inline int maxDepth() const {
@@ -121,7 +130,10 @@ public:
   void copy_to(AzTree *tree) const; 
 
   //! copy only nodes; no split.  
-  virtual void copy_nodes_from(const AzTrTree_ReadOnly *inp); 
+  /*! If doShareDataIndexes, point the data indexes of inp instead of copying */
+  /*! them; then, inp must not change while this is in use.                   */
+  virtual void copy_nodes_from(const AzTrTree_ReadOnly *inp, 
+                               bool doShareDataIndexes=false); 
 
   virtual void warmup(const AzTreeNodes *inp, 
                      const AzDataForTrTree *data, 
@@ -144,9 +156,29 @@ public:
     return &ia_root_dx; 
   }
 
+  /*---  row sampling for node search (sample_ratio=)  ---*/
+  /*---  splitting and weight optimization use all.    ---*/
+  void sample(double ratio, int data_num, int seed, int draw_no); 
+  inline void copy_sample_from(const AzTrTree *inp) {
+    ba_sample.reset(&inp->ba_sample); 
+  }
+  virtual const AzByte *sample_mask() const {
+    if (ba_sample.length() <= 0) return NULL; 
+    return ba_sample.point(); 
+  }
+  static const int *sampled_dxs(const AzByte *mask, /* may be NULL */
+                                const int *dxs, int dxs_num, 
+                                AzIntArr *ia_buff, /* work */
+                                int *out_num); /* output */
+
   /*---  to store data indexes to disk  ---*/
-  virtual void forStoringDataIndexes(AzFile *file) {}
-  virtual int estimateSizeofDataIndexes(int data_num) {return -1;}
+  virtual void forStoringDataIndexes(AzDataIndexStore *store) {}
+  virtual AZint8 estimateSizeofDataIndexes(int data_num) const {return -1;}
+
+  /*---  for checkpoints: nodes, data indexes, and split assessments  ---*/
+  virtual void write_checkpoint(AzFile *file); 
+  virtual void read_checkpoint(AzFile *file, 
+                               const AzDataForTrTree *data); 
 protected:
   /*---  tools for derived classes; for building a tree  ---*/
   void _release(); 
@@ -158,7 +190,9 @@ protected:
                  int max_size, bool doUseInternalNodes, 
                  int nx,
                  const AzTrTsplit *split, 
-                 const AzOut &out); 
+                 const AzOut &out, 
+                 bool doKeepHist=false); 
+  void _releaseHist(); 
 
   /*---  sub-routines for information seeking ... ---*/
   void _show(const AzSvFeatInfo *feat, 
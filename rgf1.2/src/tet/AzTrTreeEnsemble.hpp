@@ -31,21 +31,17 @@ template<class T>
 class AzTemp_forTrTreeEns {
 protected: 
   AzBytArr s_temp_prefix; 
-  AzDataPool<AzFile> pool_file; 
-  int unit_size; 
-  static const int max_size = 2000000000; 
+  AzDataIndexStore store; /* one file, no limit on its size */
 
 public:
-  AzTemp_forTrTreeEns() : unit_size(-1) {}
+  AzTemp_forTrTreeEns() {}
 
   bool isActive() const {
-    if (unit_size > 0) return true; 
-    return false; 
+    return store.isActive(); 
   }
   void reset() {
-    unit_size = -1; 
     s_temp_prefix.reset();
-    pool_file.reset(); 
+    store.reset(); 
   }
   void reset(T *tree, 
              int data_num, 
@@ -55,38 +51,17 @@ public:
       return; 
     }
     s_temp_prefix.reset(inp_s_temp_prefix); 
-    unit_size = tree->estimateSizeofDataIndexes(data_num); 
+    AZint8 unit_size = tree->estimateSizeofDataIndexes(data_num); 
     if (unit_size <= 0) {
       return; 
     }
-    if (unit_size > max_size) {
-      throw new AzException(AzInputError, "AzTemp_forTrTreeEns::reset", 
-                            "Data size is too large."); 
-    }
-    open_new_file(); 
+    AzBytArr s_fn; 
+    s_fn.reset(&s_temp_prefix); s_fn.c("--dxs--"); 
+    store.reset(s_fn.c_str(), unit_size); 
   }
-  AzFile *point_file() {
+  AzDataIndexStore *point_store() {
     if (!isActive()) return NULL; 
-    int fx = pool_file.size() - 1; 
-    if (fx < 0) {
-      throw new AzException("AzTemp_forTrTreeEns", "The temporary file is not ready"); 
-    }
-    AzFile *file = pool_file.point_u(fx); 
-    int remain = max_size - file->size_under2G("AzTrTreeEnsemble::point_file"); 
-    if (remain < unit_size) {
-      file = open_new_file(); 
-    }
-    return file; 
-  }
-protected:
-  AzFile *open_new_file() {
-    int idx; 
-    AzFile *file = pool_file.new_slot(&idx); 
-    AzBytArr s_fn; 
-    s_fn.reset(&s_temp_prefix); s_fn.c("--"); s_fn.cn(idx, 2, true); s_fn.c("--"); 
-    file->reset(s_fn.c_str()); 
-    file->open("w+b"); 
-    return file; 
+    return &store; 
   }
 }; 
 
@@ -168,7 +143,7 @@ public:
     }
     AzParam p(dt_param, false); 
     t[tx] = new T(p); 
-    t[tx]->forStoringDataIndexes(temp_files.point_file()); 
+    t[tx]->forStoringDataIndexes(temp_files.point_store()); 
     ++t_num; 
     if (out_tx != NULL) {
       *out_tx = tx; 
@@ -246,7 +221,8 @@ public:
   }
 
   //! copy nodes only; not split
-  void copy_nodes_from(const AzTrTreeEnsemble_ReadOnly *inp) {
+  void copy_nodes_from(const AzTrTreeEnsemble_ReadOnly *inp, 
+                       bool doShareDataIndexes=false) {
     reset(); 
     const_val = inp->constant(); 
     org_dim = inp->orgdim(); 
@@ -259,7 +235,7 @@ public:
     int tx; 
     for (tx = 0; tx < t_num; ++tx) {
       t[tx] = new T(p);
-      t[tx]->copy_nodes_from(inp->tree(tx)); 
+      t[tx]->copy_nodes_from(inp->tree(tx), doShareDataIndexes); 
     }
   }
 
@@ -312,7 +288,7 @@ public:
     int tx; 
     for (tx = 0; tx < t_num; ++tx) {
       t[tx] = new T(p); 
-      t[tx]->forStoringDataIndexes(temp_files.point_file()); 
+      t[tx]->forStoringDataIndexes(temp_files.point_store()); 
       if (search_t_num > 0 && tx < t_num-search_t_num) {
         t[tx]->quick_warmup(inp_ens->tree(tx), data, v_p, ia_tr_dx); 
       }
@@ -322,6 +298,38 @@ public:
     }    
   }
 
+  /*---  for checkpoints; read_checkpoint follows cold_start  ---*/
+  void write_checkpoint(AzFile *file) {
+    file->writeInt(t_num); 
+    file->writeDouble(const_val); 
+    file->writeInt(org_dim); 
+    int tx; 
+    for (tx = 0; tx < t_num; ++tx) {
+      t[tx]->write_checkpoint(file); 
+    }
+  }
+  void read_checkpoint(AzFile *file, 
+                       const AzDataForTrTree *data) {
+    const char *eyec = "AzTrTreeEnsemble::read_checkpoint"; 
+    if (t_num != 0) {
+      throw new AzException(eyec, "must be called right after cold_start"); 
+    }
+    int inp_t_num = file->readInt(); 
+    if (inp_t_num > a_tree.size()) {
+      throw new AzException(AzInputError, eyec, 
+                "maximum #tree is less than the #tree in the checkpoint"); 
+    }
+    const_val = file->readDouble(); 
+    int inp_org_dim = file->readInt(); 
+    if (inp_org_dim != org_dim) {
+      throw new AzException(AzInputError, eyec, "feature dimensionality mismatch"); 
+    }
+    int tx; 
+    for (tx = 0; tx < inp_t_num; ++tx) {
+      new_tree()->read_checkpoint(file, data); 
+    }
+  }
+
   void show(const AzSvFeatInfo *feat, //!< may be NULL 
             const AzOut &out, const char *header="") const {
     if (out.isNull()) return; 
@@ -61,6 +61,44 @@ void AzTrTreeFeat::reset(const AzTrTreeFeat *inp)
   out = inp->out; 
 }
 
+/*------------------------------------------------------------------*/
+void AzTrTreeFeat::write_checkpoint(AzFile *file)
+{
+  ip_featDef.write(file); 
+  sp_desc.write(file); 
+  int f_num = f_inf.cursor(); 
+  file->writeInt(f_num); 
+  int fx; 
+  for (fx = 0; fx < f_num; ++fx) {
+    const AzTrTreeFeatInfo *fp = f_inf.point(fx); 
+    file->writeBool(fp->isRemoved); 
+    file->writeInt(fp->tx); 
+    file->writeInt(fp->nx); 
+    fp->rule.write(file); 
+  }
+  pool_rules.write(file); 
+  pool_rules_rmved.write(file); 
+}
+
+/*------------------------------------------------------------------*/
+void AzTrTreeFeat::read_checkpoint(AzFile *file)
+{
+  ip_featDef.read(file); 
+  sp_desc.read(file); 
+  int f_num = file->readInt(); 
+  f_inf.reset(); 
+  int fx; 
+  for (fx = 0; fx < f_num; ++fx) {
+    AzTrTreeFeatInfo *fp = f_inf.new_slot(); 
+    fp->isRemoved = file->readBool(); 
+    fp->tx = file->readInt(); 
+    fp->nx = file->readInt(); 
+    fp->rule.read(file); 
+  }
+  pool_rules.read(file); 
+  pool_rules_rmved.read(file); 
+}
+
 /*------------------------------------------------------------------*/
 void AzTrTreeFeat::featIds(int tx, 
                           AzIIarr *iia_nx_fx) const 
@@ -202,6 +240,26 @@ void AzTrTreeFeat::_updateMatrix(const AzDataForTrTree *data,
     b_tran->resize(f_num); 
   }
 
+  AzDataArray<AzIntArr> aia_fx_dx; 
+  genMatrix(data, ens, old_f_num, &aia_fx_dx); 
+
+  /*---  load into the matrix  ---*/
+  int fx; 
+  for (fx = old_f_num; fx < f_num; ++fx) {
+    b_tran->load(fx, aia_fx_dx.point(fx-old_f_num)); 
+  }  
+}
+
+/*------------------------------------------------------------------*/
+void AzTrTreeFeat::genMatrix(const AzDataForTrTree *data, 
+                          const AzTrTreeEnsemble_ReadOnly *ens, 
+                          int old_f_num, 
+                          /*---  output  ---*/
+                          AzDataArray<AzIntArr> *aia_fx_dx) const
+{
+  int data_num = data->dataNum(); 
+  int f_num = featNum(); 
+
   /*---  which trees are referred in the new features?  ---*/
   AzIntArr ia_tx; 
   int fx; 
@@ -213,45 +271,76 @@ void AzTrTreeFeat::_updateMatrix(const AzDataForTrTree *data,
   const int *txs = ia_tx.point(&tx_num); 
 
   /*---  generate features  ---*/
-  AzDataArray<AzIntArr> aia_fx_dx(f_num-old_f_num); 
+  aia_fx_dx->reset(f_num-old_f_num); 
+  AzIntArr ia_all_dx; 
+  ia_all_dx.range(0, data_num); 
   int xx; 
   for (xx = 0; xx < tx_num; ++xx) {
     int tx = txs[xx]; 
-    int dx; 
-    for (dx = 0; dx < data_num; ++dx) {
-      genFeats(ens->tree(tx), tx, data, dx, 
-               old_f_num, &aia_fx_dx); 
-    }
+    const AzTrTree_ReadOnly *dtree = ens->tree(tx); 
+    genFeats(dtree, tx, data, dtree->root(), &ia_all_dx, 
+             old_f_num, aia_fx_dx); 
   }
+}
 
-  /*---  load into the matrix  ---*/
+/*------------------------------------------------------------------*/
+void AzTrTreeFeat::newMatrix(const AzDataForTrTree *data, 
+                             const AzTrTreeEnsemble_ReadOnly *ens, 
+                             const AzBmat *b_tran, 
+                             AzBmat *b_tran_new) /* output */
+                             const
+{
+  const char *eyec = "AzTrTreeFeat::newMatrix"; 
+  int data_num = data->dataNum(); 
+  int f_num = featNum(); 
+  if (ens->size() != treeNum()) {
+    throw new AzException(eyec, "size of tree ensemble and #feat should be the same"); 
+  }
+  int old_f_num = b_tran->colNum(); 
+  if (old_f_num > f_num) {
+    throw new AzException(eyec, "#col is bigger than #feat"); 
+  }
+  if (old_f_num > 0 && b_tran->rowNum() != data_num) {
+    throw new AzException(eyec, "b_tran has a wrong shape"); 
+  }
+
+  AzDataArray<AzIntArr> aia_fx_dx; 
+  genMatrix(data, ens, old_f_num, &aia_fx_dx); 
+  b_tran_new->reform(data_num, f_num-old_f_num); 
+  int fx; 
   for (fx = old_f_num; fx < f_num; ++fx) {
-    b_tran->load(fx, aia_fx_dx.point(fx-old_f_num)); 
-  }  
+    b_tran_new->load(fx-old_f_num, aia_fx_dx.point(fx-old_f_num)); 
+  }
 }
 
+/*------------------------------------------------------------------*/
+/* Push the data points down the tree all at once; the data points  */
+/* reaching node#nx are the ones that have the feature of node#nx.  */
 /*------------------------------------------------------------------*/
 void AzTrTreeFeat::genFeats(const AzTrTree_ReadOnly *dtree, 
                         int tx, 
                         const AzDataForTrTree *data, 
-                        int dx, 
+                        int nx, 
+                        const AzIntArr *ia_dx, /* data points at node#nx; sorted */
                         int fx_offs, 
                         /*---  output  ---*/
                         AzDataArray<AzIntArr> *aia_fx_dx)
 const
 {
-  AzIntArr ia_nx; 
-  dtree->apply(data, dx, &ia_nx); 
-
-  int num; 
-  const int *nx = ia_nx.point(&num); 
-  int ix; 
-  for (ix = 0; ix < num; ++ix) {
-    int feat_no = (ip_featDef.point(tx))[nx[ix]]; 
-    if (feat_no >= fx_offs) {     
-      aia_fx_dx->point_u(feat_no-fx_offs)->put(dx); 
-    }
+  if (ia_dx->size() <= 0) return; 
+  int feat_no = (ip_featDef.point(tx))[nx]; 
+  if (feat_no >= fx_offs) {
+    aia_fx_dx->point_u(feat_no-fx_offs)->concat(ia_dx); 
   }
+
+  const AzTreeNode *np = dtree->node(nx); 
+  if (np->isLeaf()) return; 
+
+  AzIntArr ia_le_dx, ia_gt_dx; 
+  data->isLE(ia_dx->point(), ia_dx->size(), np->fx, np->border_val, 
+             &ia_le_dx, &ia_gt_dx); 
+  genFeats(dtree, tx, data, np->le_nx, &ia_le_dx, fx_offs, aia_fx_dx); 
+  genFeats(dtree, tx, data, np->gt_nx, &ia_gt_dx, fx_offs, aia_fx_dx); 
 }
 
 /* can be used for both frontier and non-frontier */
@@ -92,6 +92,10 @@ public:
   ~AzTrTreeFeat() {}
   void reset(const AzTrTreeFeat *inp); 
 
+  /*---  for checkpoints; read_checkpoint follows reset(data,param,...)  ---*/
+  void write_checkpoint(AzFile *file); 
+  void read_checkpoint(AzFile *file); 
+
   void reset(const AzDataForTrTree *data, 
              AzParam &param, 
              const AzOut &out_req, 
@@ -128,6 +132,13 @@ public:
                   AzBmat *m_tran) /* inout */
                   const; 
 
+  /*---  generate only the columns that updateMatrix would add to m_tran  ---*/
+  void newMatrix(const AzDataForTrTree *data, 
+                 const AzTrTreeEnsemble_ReadOnly *ens, 
+                 const AzBmat *m_tran, 
+                 AzBmat *m_tran_new) /* output */
+                 const; 
+
   const AzTrTreeFeatInfo *featInfo(int fx) const {
     return f_inf.point(fx); 
   }
@@ -144,7 +155,8 @@ protected:
   void genFeats(const AzTrTree_ReadOnly *dtree, 
                 int tx, /* tree# of dtree */
                 const AzDataForTrTree *data, 
-                int dx, 
+                int nx, 
+                const AzIntArr *ia_dx, /* data points at node#nx; sorted */
                 int fx_offs, 
                 /*---  output  ---*/
                 AzDataArray<AzIntArr> *aia_fx_dx) const; 
@@ -166,6 +178,11 @@ protected:
                      int old_f_num, 
                      /*---  output  ---*/
                      AzBmat *m_tran) const; 
+  void genMatrix(const AzDataForTrTree *data, 
+                 const AzTrTreeEnsemble_ReadOnly *ens, 
+                 int old_f_num, 
+                 /*---  output  ---*/
+                 AzDataArray<AzIntArr> *aia_fx_dx) const; 
 
   void removeFeat(int removed_fx); 
   int countNonzeroNodup(const AzDvect *v_w) const; 
@@ -51,8 +51,13 @@ public:
   virtual const AzSortedFeatArr *sorted_array(int nx, 
                              const AzDataForTrTree *data) const = 0; 
                              /*--- (NOTE) this is const but changes sorted_arr[nx] ---*/
+  virtual const AzHistFeat *histogram(int nx, 
+                             const AzDataForTrTree *data, 
+                             const AzTrTtarget *target) const = 0; 
+                             /*--- (NOTE) this is const but changes hist[nx] ---*/
 
   virtual const AzIntArr *root_dx() const = 0; 
+  virtual const AzByte *sample_mask() const = 0; /* NULL if not sampling */
 
   /*---  apply ... ---*/
   virtual double apply(const AzDataForTrTree *data, int dx, 
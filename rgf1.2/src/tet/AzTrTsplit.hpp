@@ -62,6 +62,31 @@ header, fx, border_val, gain, bestP[0], bestP[1], tx, nx);
   AzTrTsplit(const AzTrTsplit *inp) { /* copy */
     copy(inp); 
   }
+  AzTrTsplit(AzFile *file) {
+    read(file); 
+  }
+
+  /*---  for checkpoints  ---*/
+  void write(AzFile *file) const {
+    file->writeInt(fx); 
+    file->writeDouble(border_val); 
+    file->writeDouble(gain); 
+    file->writeDouble(bestP[0]); 
+    file->writeDouble(bestP[1]); 
+    str_desc.write(file); 
+    file->writeInt(tx); 
+    file->writeInt(nx); 
+  }
+  void read(AzFile *file) {
+    fx = file->readInt(); 
+    border_val = file->readDouble(); 
+    gain = file->readDouble(); 
+    bestP[0] = file->readDouble(); 
+    bestP[1] = file->readDouble(); 
+    str_desc.read(file); 
+    tx = file->readInt(); 
+    nx = file->readInt(); 
+  }
   virtual 
   inline bool isEmpty() const {
     if (fx < 0) return true; 
@@ -83,6 +83,20 @@ public:
     }
   }
 
+  /*---  for checkpoints; read_checkpoint follows reset(v_y,v_fixed_dw)  ---*/
+  void write_checkpoint(AzFile *file) {
+    v_tar_dw.write(file); 
+    v_dw.write(file); 
+  }
+  void read_checkpoint(AzFile *file) {
+    v_tar_dw.read(file); 
+    v_dw.read(file); 
+    if (v_tar_dw.rowNum() != v_y.rowNum() || v_dw.rowNum() != v_y.rowNum()) {
+      throw new AzException(AzInputError, "AzTrTtarget::read_checkpoint", 
+                            "#data conflict"); 
+    }
+  }
+
   void resetTargetDw(const AzDvect *v_tar, const AzDvect *inp_v_dw) {
     v_tar_dw.set(v_tar); 
     v_dw.set(inp_v_dw); 
@@ -213,6 +213,94 @@ void AzTree::clean_up()
   }
 }
 
+/*--------------------------------------------------------*/
+void AzTree::compact()
+{
+  checkNodes("compact"); 
+  if (nodes_used <= 1) return; 
+  clean_up(); 
+
+  AzTreeNode *new_nodes = NULL; 
+  AzBaseArray<AzTreeNode> a_new; 
+  a_new.alloc(&new_nodes, nodes_used, "AzTree::compact", "new_nodes"); 
+  int new_num = 0; 
+  root_nx = _compact(root_nx, -1, new_nodes, &new_num); 
+  a_new.realloc(&new_nodes, new_num, "AzTree::compact", "new_nodes"); 
+  a_nodes.transfer_from(&a_new, &nodes, &new_nodes); 
+  nodes_used = new_num; 
+}
+
+/*--------------------------------------------------------*/
+/* Copy the subtree in depth-first order; returns the new node#. */
+int AzTree::_compact(int nx, int parent_nx, 
+                     AzTreeNode *new_nodes, /* output */
+                     int *new_num) /* inout */
+const
+{
+  for ( ; ; ) { /* skip the dead nodes */
+    int child_nx = decidedChild(nx); 
+    if (child_nx < 0) break; 
+    nx = child_nx; 
+  }
+  int new_nx = (*new_num)++; 
+  new_nodes[new_nx] = nodes[nx]; 
+  new_nodes[new_nx].parent_nx = parent_nx; 
+  if (nodes[nx].isLeaf()) return new_nx; 
+
+  int le_nx = _compact(nodes[nx].le_nx, new_nx, new_nodes, new_num); 
+  int gt_nx = _compact(nodes[nx].gt_nx, new_nx, new_nodes, new_num); 
+  if (new_nodes[le_nx].isLeaf() && new_nodes[gt_nx].isLeaf() && 
+      new_nodes[le_nx].weight == new_nodes[gt_nx].weight) {
+    /*---  the same prediction either way; make it a leaf  ---*/
+    double w = new_nodes[le_nx].weight; 
+    new_nodes[new_nx].reset(); 
+    new_nodes[new_nx].parent_nx = parent_nx; 
+    new_nodes[new_nx].weight = w; 
+    *new_num = new_nx + 1; /* the two leaves were the last ones */
+  }
+  else {
+    new_nodes[new_nx].le_nx = le_nx; 
+    new_nodes[new_nx].gt_nx = gt_nx; 
+  }
+  return new_nx; 
+}
+
+/*--------------------------------------------------------*/
+/* The child every data point reaching the node goes to, or -1. */
+/* x<=b above and b<=border, or x>b above and b>=border.        */
+int AzTree::decidedChild(int nx) const
+{
+  const AzTreeNode *np = &nodes[nx]; 
+  if (np->isLeaf()) return -1; 
+  int child_nx = nx; 
+  int px = np->parent_nx; 
+  for ( ; px >= 0; child_nx = px, px = nodes[px].parent_nx) {
+    const AzTreeNode *pp = &nodes[px]; 
+    if (pp->fx != np->fx) continue; 
+    if (child_nx == pp->le_nx) {
+      if (pp->border_val <= np->border_val) return np->le_nx; 
+    }
+    else {
+      if (pp->border_val >= np->border_val) return np->gt_nx; 
+    }
+  }
+  return -1; 
+}
+
+/*--------------------------------------------------------*/
+void AzTree::getRule(int nx, AzTreeRule *rule) const
+{
+  checkNode(nx, "getRule"); 
+  int child_nx = nx; 
+  int px = nodes[nx].parent_nx; 
+  for ( ; px >= 0; child_nx = px, px = nodes[px].parent_nx) {
+    /*---  feat#, isLE, border_val as in AzTrTree::getRule  ---*/
+    rule->append(nodes[px].fx, (child_nx == nodes[px].le_nx), 
+                 nodes[px].border_val); 
+  }
+  rule->finalize(); 
+}
+
 /*--------------------------------------------------------*/
 void AzTree::finfo(AzIFarr *ifa_fx_count, 
                    AzIFarr *ifa_fx_w) /* appended */
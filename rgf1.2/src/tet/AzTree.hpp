@@ -24,6 +24,7 @@
 #include "AzSmat.hpp"
 #include "AzSvFeatInfo.hpp"
 #include "AzTreeNodes.hpp"
+#include "AzTreeRule.hpp"
 
 //!  Untrainalbe regression tree.  
 /*------------------------------------------*/
@@ -88,6 +89,20 @@ public:
   int leafNum() const; 
   void clean_up(); 
 
+  //! Remove dead nodes and collapse the nodes whose children are leaves of the same weight.  
+  /*! Dead: the split is decided by the splits above on the same feature.  */
+  /*! The weights are moved to the leaves first (clean_up).  A subtree of */
+  /*! zero-weight leaves becomes one zero-weight leaf.                     */
+  void compact(); 
+  inline bool isZero() const { /* a single leaf of zero weight */
+    return (nodes_used <= 0 || (nodes_used == 1 && nodes[root_nx].weight == 0)); 
+  }
+  void getRule(int nx, AzTreeRule *rule) const; /* path from the node to the root */
+  inline void setWeight(int nx, double w) {
+    checkNode(nx, "setWeight"); 
+    nodes[nx].weight = w; 
+  }
+
   inline const AzTreeNode *node(int nx) const {
     checkNode(nx, "point"); 
     return &nodes[nx]; 
@@ -126,6 +141,10 @@ protected:
                     const AzOut &out) const; 
 
   void _release(); 
+  int _compact(int nx, int parent_nx, 
+               AzTreeNode *new_nodes, /* output */
+               int *new_num) const; /* inout */
+  int decidedChild(int nx) const; 
   virtual void _genDesc(const AzSvFeatInfo *feat, 
                       int nx, 
                       AzBytArr *s) /* output */
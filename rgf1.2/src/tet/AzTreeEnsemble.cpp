@@ -18,6 +18,7 @@
 
 #include "AzTreeEnsemble.hpp"
 #include "AzPrint.hpp"
+#include "AzStrPool.hpp"
 
 static int reserved_length = 256; 
 
@@ -141,6 +142,92 @@ int AzTreeEnsemble::leafNum(int tx0, int tx1) const
   return l_num; 
 }
 
+/*--------------------------------------------------------*/
+int AzTreeEnsemble::nodeNum() const
+{
+  int n_num = 0; 
+  int tx; 
+  for (tx = 0; tx < t_num; ++tx) {
+    if (t[tx] != NULL) {
+      n_num += t[tx]->nodeNum(); 
+    }
+  }
+  return n_num; 
+}
+
+/*--------------------------------------------------------*/
+int AzTreeEnsemble::compact()
+{
+  const char *eyec = "AzTreeEnsemble::compact"; 
+  int tx; 
+  for (tx = 0; tx < t_num; ++tx) {
+    if (t[tx] != NULL) t[tx]->compact(); 
+  }
+
+  /*---  merge the leaves of the same rule into the first one  ---*/
+  AzIntArr ia_tx, ia_nx; /* leaf# -> tree#, node# */
+  AzStrPool sp_rule; 
+  for (tx = 0; tx < t_num; ++tx) {
+    if (t[tx] == NULL) continue; 
+    int nx; 
+    for (nx = 0; nx < t[tx]->nodeNum(); ++nx) {
+      const AzTreeNode *np = t[tx]->node(nx); 
+      if (!np->isLeaf() || np->weight == 0) continue; 
+      AzTreeRule rule; 
+      t[tx]->getRule(nx, &rule); 
+      sp_rule.put(rule.bytarr()); 
+      ia_tx.put(tx); ia_nx.put(nx); 
+    }
+  }
+  sp_rule.commit(); 
+  AzIntArr ia_first; /* rule# -> leaf# */
+  ia_first.reset(sp_rule.size(), -1); 
+  int *first = ia_first.point_u(); 
+  int merged_num = 0; 
+  int lx; 
+  for (lx = 0; lx < ia_tx.size(); ++lx) {
+    AzTree *tree = t[ia_tx.get(lx)]; 
+    int nx = ia_nx.get(lx); 
+    AzTreeRule rule; 
+    tree->getRule(nx, &rule); 
+    int rx = sp_rule.find(rule.bytarr()); 
+    if (rx < 0) {
+      throw new AzException(eyec, "rule not found in the pool?!"); 
+    }
+    if (first[rx] < 0) {
+      first[rx] = lx; 
+      continue; 
+    }
+    AzTree *first_tree = t[ia_tx.get(first[rx])]; 
+    int first_nx = ia_nx.get(first[rx]); 
+    first_tree->setWeight(first_nx, first_tree->node(first_nx)->weight + tree->node(nx)->weight); 
+    tree->setWeight(nx, 0); 
+    ++merged_num; 
+  }
+
+  /*---  the leaves set to zero may make more nodes collapse  ---*/
+  if (merged_num > 0) {
+    for (tx = 0; tx < t_num; ++tx) {
+      if (t[tx] != NULL) t[tx]->compact(); 
+    }
+  }
+
+  /*---  remove zero trees; they are moved to the end and released  ---*/
+  int new_num = 0; 
+  for (tx = 0; tx < t_num; ++tx) {
+    if (t[tx] == NULL || t[tx]->isZero()) continue; 
+    AzTree *tmp = t[new_num]; 
+    t[new_num] = t[tx]; 
+    t[tx] = tmp; 
+    ++new_num; 
+  }
+  if (new_num < t_num) {
+    a_tree.realloc(&t, new_num, eyec, "t"); 
+    t_num = new_num; 
+  }
+  return merged_num; 
+}
+
 /*--------------------------------------------------------*/
 void AzTreeEnsemble::read(const char *fn) 
 {
@@ -83,6 +83,13 @@ public:
   }
   int leafNum(int tx0, int tx1) const; 
   inline int size() const { return t_num; } 
+  int nodeNum() const; 
+
+  //! Smaller model with the same predictions: see AzTree::compact.  
+  /*! Also, the weight of a leaf with the same rule (path) as a leaf of */
+  /*! an earlier tree is moved to that leaf, and zero trees are removed. */
+  /*! Returns the number of the leaves whose weights were moved.         */
+  int compact(); 
 
   void apply(const AzSmat *m_data, 
              AzDvect *v_pred) /* output */
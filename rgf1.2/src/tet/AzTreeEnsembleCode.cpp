@@ -0,0 +1,267 @@
+/* * * * *
+ *  AzTreeEnsembleCode.cpp
+ *  Copyright (C) 2011, 2012 Rie Johnson
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * */
+
+#include "AzTreeEnsembleCode.hpp"
+
+/*--------------------------------------------------------*/
+void AzTreeEnsembleCode::write(const AzTreeEnsemble *const *ens, /* [out_num] */
+                               int out_num, 
+                               int feat_num, 
+                               const char *name, 
+                               const char *model_fn, 
+                               const char *fn_prefix)
+{
+  const char *eyec = "AzTreeEnsembleCode::write"; 
+  if (!isName(name)) {
+    throw new AzException(AzInputNotValid, eyec, "Not a C identifier: ", name); 
+  }
+  AzBytArr s_NAME; 
+  upper(name, &s_NAME); 
+
+  /*---  header  ---*/
+  AzBytArr s_hpp_fn; 
+  header_fn(fn_prefix, false, &s_hpp_fn); 
+  AzFile hpp_file(s_hpp_fn.c_str()); 
+  hpp_file.open("wb"); 
+  AzBytArr s; 
+  s.c("/* Generated by \"compile_model\" from "); s.c(model_fn); s.c(".  Do not edit. */"); s.nl(); 
+  s.c("#ifndef _"); s.c(&s_NAME); s.c("_HPP_"); s.nl(); 
+  s.c("#define _"); s.c(&s_NAME); s.c("_HPP_"); s.nl(); s.nl(); 
+  s.c("#define "); s.c(&s_NAME); s.c("_FEAT_NUM "); s.cn(feat_num); s.nl(); 
+  s.c("#define "); s.c(&s_NAME); s.c("_OUT_NUM "); s.cn(out_num); s.nl(); s.nl(); 
+  s.c("#ifdef __cplusplus"); s.nl(); 
+  s.c("extern \"C\" {"); s.nl(); 
+  s.c("#endif"); s.nl(); 
+  s.c("/* x: "); s.c(&s_NAME); s.c("_FEAT_NUM feature values; out: "); 
+  s.c(&s_NAME); s.c("_OUT_NUM predictions */"); s.nl(); 
+  s.c("void "); s.c(name); s.c("_predict_row(const double *x, double *out);"); s.nl(); 
+  s.c("/* x: num rows of "); s.c(&s_NAME); s.c("_FEAT_NUM values; out: num rows of "); 
+  s.c(&s_NAME); s.c("_OUT_NUM */"); s.nl(); 
+  s.c("void "); s.c(name); s.c("_predict(const double *x, int num, double *out);"); s.nl(); 
+  s.c("#ifdef __cplusplus"); s.nl(); 
+  s.c("}"); s.nl(); 
+  s.c("#endif"); s.nl(); 
+  s.c("#endif"); s.nl(); 
+  s.writeText(&hpp_file); 
+  hpp_file.close(true); 
+
+  /*---  source: one function per tree  ---*/
+  AzBytArr s_cpp_fn(fn_prefix, ".cpp"), s_include; 
+  header_fn(fn_prefix, true, &s_include); 
+  AzFile cpp_file(s_cpp_fn.c_str()); 
+  cpp_file.open("wb"); 
+  s.reset(); 
+  s.c("/* Generated by \"compile_model\" from "); s.c(model_fn); s.c(".  Do not edit. */"); s.nl(); 
+  s.c("#include \""); s.c(&s_include); s.c("\""); s.nl(); 
+  s.writeText(&cpp_file); 
+  int ox; 
+  for (ox = 0; ox < out_num; ++ox) {
+    int tx; 
+    for (tx = 0; tx < ens[ox]->size(); ++tx) {
+      const AzTree *tree = ens[ox]->tree(tx); 
+      if (tree->nodeNum() <= 0) continue; /* skipped by apply too */
+      s.reset(); 
+      s.nl(); 
+      s.c("static double "); s.c(name); s.c("_"); s.cn(ox); s.c("_"); s.cn(tx); 
+      s.c("(const double *x)"); s.nl(); 
+      s.c("{"); s.nl(); 
+      write_tree(tree, tree->root(), 0, 0, &s); 
+      s.c("}"); s.nl(); 
+      s.writeText(&cpp_file); 
+    }
+  }
+
+  /*---  one row  ---*/
+  s.reset(); 
+  s.nl(); 
+  s.c("void "); s.c(name); s.c("_predict_row(const double *x, double *out)"); s.nl(); 
+  s.c("{"); s.nl(); 
+  for (ox = 0; ox < out_num; ++ox) {
+    s.c("  double v"); s.cn(ox); s.c(" = "); concat_val(ens[ox]->constant(), &s); s.c(";"); s.nl(); 
+    int tx; 
+    for (tx = 0; tx < ens[ox]->size(); ++tx) {
+      if (ens[ox]->tree(tx)->nodeNum() <= 0) continue; 
+      s.c("  v"); s.cn(ox); s.c(" += "); s.c(name); s.c("_"); s.cn(ox); s.c("_"); s.cn(tx); s.c("(x);"); s.nl(); 
+    }
+    s.c("  out["); s.cn(ox); s.c("] = v"); s.cn(ox); s.c(";"); s.nl(); 
+  }
+  s.c("}"); s.nl(); 
+
+  /*---  batch: tree by tree  ---*/
+  s.nl(); 
+  s.c("void "); s.c(name); s.c("_predict(const double *x, int num, double *out)"); s.nl(); 
+  s.c("{"); s.nl(); 
+  s.c("  int i;"); s.nl(); 
+  for (ox = 0; ox < out_num; ++ox) {
+    s.c("  for (i = 0; i < num; ++i) out[i*"); s.c(&s_NAME); s.c("_OUT_NUM+"); s.cn(ox); 
+    s.c("] = "); concat_val(ens[ox]->constant(), &s); s.c(";"); s.nl(); 
+    int tx; 
+    for (tx = 0; tx < ens[ox]->size(); ++tx) {
+      if (ens[ox]->tree(tx)->nodeNum() <= 0) continue; 
+      s.c("  for (i = 0; i < num; ++i) out[i*"); s.c(&s_NAME); s.c("_OUT_NUM+"); s.cn(ox); 
+      s.c("] += "); s.c(name); s.c("_"); s.cn(ox); s.c("_"); s.cn(tx); 
+      s.c("(x+i*"); s.c(&s_NAME); s.c("_FEAT_NUM);"); s.nl(); 
+    }
+  }
+  s.c("}"); s.nl(); 
+  s.writeText(&cpp_file); 
+  cpp_file.close(true); 
+}
+
+/*--------------------------------------------------------*/
+/* Nested comparisons as AzTree::apply goes down the tree. */
+void AzTreeEnsembleCode::write_tree(const AzTree *tree, 
+                                    int nx, 
+                                    double path_w, 
+                                    int depth, 
+                                    AzBytArr *s) /* output: appended */
+{
+  const AzTreeNode *np = tree->node(nx); 
+  path_w += np->weight; 
+  if (np->isLeaf()) {
+    concat_indent(depth, s); 
+    s->c("return "); concat_val(path_w, s); s->c(";"); s->nl(); 
+    return; 
+  }
+  concat_indent(depth, s); 
+  s->c("if (x["); s->cn(np->fx); s->c("] <= "); concat_val(np->border_val, s); s->c(") {"); s->nl(); 
+  write_tree(tree, np->le_nx, path_w, depth+1, s); 
+  concat_indent(depth, s); 
+  s->c("}"); s->nl(); 
+  write_tree(tree, np->gt_nx, path_w, depth, s); 
+}
+
+/*--------------------------------------------------------*/
+/* with enough digits to be read back as the same double */
+void AzTreeEnsembleCode::concat_val(double val, AzBytArr *s)
+{
+  if (val != val || val - val != 0) {
+    throw new AzException("AzTreeEnsembleCode::concat_val", "NaN or infinity in the model"); 
+  }
+  AzBytArr s_val; 
+  s_val.cn(val, 17); 
+  s->c(&s_val); 
+  /*---  make it a floating-point literal  ---*/
+  if (strchr(s_val.c_str(), '.') == NULL && strchr(s_val.c_str(), 'e') == NULL) s->c(".0"); 
+}
+
+/*--------------------------------------------------------*/
+void AzTreeEnsembleCode::write_test(const char *name, 
+                                    const char *fn_prefix)
+{
+  AzBytArr s_NAME, s_include; 
+  upper(name, &s_NAME); 
+  header_fn(fn_prefix, true, &s_include); 
+  AzBytArr s_fn(fn_prefix, "_test.cpp"); 
+  AzFile file(s_fn.c_str()); 
+  file.open("wb"); 
+  AzBytArr s; 
+  s.c("/* Generated by \"compile_model\".  Do not edit.                  */"); s.nl(); 
+  s.c("/* Usage: this  input  output                                  */"); s.nl(); 
+  s.c("/* input: one row per line; output: per row, the predictions of */"); s.nl(); 
+  s.c("/* _predict followed by those of _predict_row.                  */"); s.nl(); 
+  s.c("#include <stdio.h>"); s.nl(); 
+  s.c("#include <vector>"); s.nl(); 
+  s.c("#include \""); s.c(&s_include); s.c("\""); s.nl(); 
+  s.nl(); 
+  s.c("int main(int argc, char *argv[])"); s.nl(); 
+  s.c("{"); s.nl(); 
+  s.c("  if (argc != 3) return 1;"); s.nl(); 
+  s.c("  FILE *inp = fopen(argv[1], \"r\");"); s.nl(); 
+  s.c("  FILE *out = fopen(argv[2], \"w\");"); s.nl(); 
+  s.c("  if (inp == NULL || out == NULL) return 1;"); s.nl(); 
+  s.c("  std::vector<double> x;"); s.nl(); 
+  s.c("  double val;"); s.nl(); 
+  s.c("  while (fscanf(inp, \"%lf\", &val) == 1) x.push_back(val);"); s.nl(); 
+  s.c("  fclose(inp);"); s.nl(); 
+  s.c("  int num = (int)(x.size() / "); s.c(&s_NAME); s.c("_FEAT_NUM);"); s.nl(); 
+  s.c("  if (num <= 0) return 1;"); s.nl(); 
+  s.c("  std::vector<double> p((size_t)num*"); s.c(&s_NAME); s.c("_OUT_NUM), q("); s.c(&s_NAME); s.c("_OUT_NUM);"); s.nl(); 
+  s.c("  "); s.c(name); s.c("_predict(&x[0], num, &p[0]);"); s.nl(); 
+  s.c("  int i, o;"); s.nl(); 
+  s.c("  for (i = 0; i < num; ++i) {"); s.nl(); 
+  s.c("    "); s.c(name); s.c("_predict_row(&x[(size_t)i*"); s.c(&s_NAME); s.c("_FEAT_NUM], &q[0]);"); s.nl(); 
+  s.c("    for (o = 0; o < "); s.c(&s_NAME); s.c("_OUT_NUM; ++o) fprintf(out, \"%.17g \", p[(size_t)i*"); 
+  s.c(&s_NAME); s.c("_OUT_NUM+o]);"); s.nl(); 
+  s.c("    for (o = 0; o < "); s.c(&s_NAME); s.c("_OUT_NUM; ++o) fprintf(out, \" %.17g\", q[o]);"); s.nl(); 
+  s.c("    fprintf(out, \"\\n\");"); s.nl(); 
+  s.c("  }"); s.nl(); 
+  s.c("  return (fclose(out) == 0) ? 0 : 1;"); s.nl(); 
+  s.c("}"); s.nl(); 
+  s.writeText(&file); 
+  file.close(true); 
+}
+
+/*--------------------------------------------------------*/
+bool AzTreeEnsembleCode::isName(const char *name)
+{
+  if (name == NULL || *name == '\0') return false; 
+  const char *ptr; 
+  for (ptr = name; *ptr != '\0'; ++ptr) {
+    char ch = *ptr; 
+    if (ch == '_' || (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z')) continue; 
+    if (ptr != name && ch >= '0' && ch <= '9') continue; 
+    return false; 
+  }
+  return true; 
+}
+
+/*--------------------------------------------------------*/
+int AzTreeEnsembleCode::featNum(const AzTreeEnsemble *const *ens, int out_num)
+{
+  int feat_num = 0; 
+  int ox; 
+  for (ox = 0; ox < out_num; ++ox) {
+    feat_num = MAX(feat_num, ens[ox]->orgdim()); 
+    int tx; 
+    for (tx = 0; tx < ens[ox]->size(); ++tx) {
+      const AzTree *tree = ens[ox]->tree(tx); 
+      int nx; 
+      for (nx = 0; nx < tree->nodeNum(); ++nx) {
+        feat_num = MAX(feat_num, tree->node(nx)->fx + 1); 
+      }
+    }
+  }
+  return MAX(feat_num, 1); 
+}
+
+/*--------------------------------------------------------*/
+void AzTreeEnsembleCode::header_fn(const char *fn_prefix, 
+                                   bool doBaseOnly, /* without the directory */
+                                   AzBytArr *s)
+{
+  const char *base = fn_prefix; 
+  const char *ptr; 
+  for (ptr = fn_prefix; *ptr != '\0'; ++ptr) {
+    if (doBaseOnly && (*ptr == '/' || *ptr == '\\')) base = ptr + 1; 
+  }
+  s->reset(base); 
+  s->c(".hpp"); 
+}
+
+/*--------------------------------------------------------*/
+void AzTreeEnsembleCode::upper(const char *name, AzBytArr *s)
+{
+  s->reset(); 
+  const char *ptr; 
+  for (ptr = name; *ptr != '\0'; ++ptr) {
+    char ch = *ptr; 
+    if (ch >= 'a' && ch <= 'z') ch = ch - 'a' + 'A'; 
+    s->c((AzByte)ch); 
+  }
+}
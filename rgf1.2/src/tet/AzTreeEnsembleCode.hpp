@@ -0,0 +1,68 @@
+/* * * * *
+ *  AzTreeEnsembleCode.hpp
+ *  Copyright (C) 2011, 2012 Rie Johnson
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * */
+
+#ifndef _AZ_TREE_ENSEMBLE_CODE_HPP_
+#define _AZ_TREE_ENSEMBLE_CODE_HPP_
+
+#include "AzUtil.hpp"
+#include "AzTreeEnsemble.hpp"
+
+//! Generate C++ source code that scores data with a model ("compile_model").  
+/*-------------------------------------------------------------------
+ *  <prefix>.hpp declares, for name=NAME,
+ *    NAME_FEAT_NUM, NAME_OUT_NUM: #feature and #output (1 unless
+ *        multi-output), 
+ *    NAME_predict_row(x, out): x[NAME_FEAT_NUM] -> out[NAME_OUT_NUM], 
+ *    NAME_predict(x, num, out): num rows stored one after another. 
+ *  <prefix>.cpp has one function per tree: nested comparisons with
+ *  the borders and the leaf values as constants.  The leaf value is
+ *  the sum of the weights on the path and the trees are added to the
+ *  constant in order, as AzTreeEnsemble::apply does; therefore, the
+ *  predictions are the same.  NAME_predict goes tree by tree so that
+ *  the code of one tree stays in cache over the rows.
+ *  <prefix>_test.cpp (write_test) is a program that reads rows from a
+ *  text file and writes the predictions of both functions.
+ *-------------------------------------------------------------------*/
+class AzTreeEnsembleCode {
+public:
+  static void write(const AzTreeEnsemble *const *ens, /* [out_num] */
+                    int out_num, 
+                    int feat_num, 
+                    const char *name, 
+                    const char *model_fn, /* for the comment */
+                    const char *fn_prefix); 
+  static void write_test(const char *name, 
+                         const char *fn_prefix); 
+  static bool isName(const char *name); /* C identifier */
+  static int featNum(const AzTreeEnsemble *const *ens, int out_num); /* orgdim, or max feature# + 1 */
+
+protected:
+  static void write_tree(const AzTree *tree, 
+                         int nx, 
+                         double path_w, 
+                         int depth, 
+                         AzBytArr *s); /* output: appended */
+  static void concat_val(double val, AzBytArr *s); 
+  static void concat_indent(int depth, AzBytArr *s) {
+    int ix; 
+    for (ix = 0; ix < depth + 1; ++ix) s->c("  "); 
+  }
+  static void header_fn(const char *fn_prefix, bool doBaseOnly, AzBytArr *s); 
+  static void upper(const char *name, AzBytArr *s); 
+}; 
+#endif
@@ -0,0 +1,671 @@
+/* * * * *
+ *  AzTreeEnsembleFlat.cpp
+ *  Copyright (C) 2011, 2012 Rie Johnson
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * */
+
+#include "AzTreeEnsembleFlat.hpp"
+
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+static const char packed_magic[8] = { 'A','z','T','E','F','l','a','t' }; 
+
+/*--------------------------------------------------------*/
+void AzTreeEnsembleFlat::reset(const AzTreeEnsemble *const *ens, 
+                               int ens_num)
+{
+  unmap(); 
+  out_num = ens_num; 
+  v_const.reform(out_num); 
+  clear_info(); 
+  org_tree_num = org_leaf_num = 0; 
+  int max_t_num = 0, max_fx = -1; 
+  int ox; 
+  for (ox = 0; ox < out_num; ++ox) {
+    v_const.set(ox, ens[ox]->constant()); 
+    org_dim = MAX(org_dim, ens[ox]->orgdim()); 
+    org_tree_num += ens[ox]->size(); 
+    org_leaf_num += ens[ox]->leafNum(); 
+    max_t_num = MAX(max_t_num, ens[ox]->size()); 
+    int tx; 
+    for (tx = 0; tx < ens[ox]->size(); ++tx) {
+      const AzTree *tree = ens[ox]->tree(tx); 
+      int nx; 
+      for (nx = 0; nx < tree->nodeNum(); ++nx) {
+        max_fx = MAX(max_fx, tree->node(nx)->fx); 
+      }
+    }
+  }
+
+  /*---  group the trees at each position so that the others in a group  ---*/
+  /*---  are prefixes of the largest one, which is packed                ---*/
+  AzIntArr ia_grp(max_t_num*out_num, -1); /* position*out_num+output# -> group# */
+  AzIntArr ia_grp_tx, ia_grp_ox;  /* group# -> position, output# of the largest */
+  int tx; 
+  for (tx = 0; tx < max_t_num; ++tx) {
+    int grp_begin = ia_grp_ox.size(); 
+    for (ox = 0; ox < out_num; ++ox) {
+      if (tx >= ens[ox]->size()) continue; 
+      const AzTree *tree = ens[ox]->tree(tx); 
+      if (tree->nodeNum() <= 0) continue; /* empty tree */
+      int gx; 
+      for (gx = grp_begin; gx < ia_grp_ox.size(); ++gx) {
+        const AzTree *large = ens[ia_grp_ox.get(gx)]->tree(tx); 
+        if (isPrefix(tree, large)) break; 
+        if (isPrefix(large, tree)) {
+          ia_grp_ox.update(gx, ox); 
+          break; 
+        }
+      }
+      if (gx >= ia_grp_ox.size()) {
+        ia_grp_tx.put(tx); 
+        ia_grp_ox.put(ox); 
+      }
+      ia_grp.update(tx*out_num+ox, gx); 
+    }
+  }
+
+  int node_num = 0, path_num = 0; 
+  int gx; 
+  for (gx = 0; gx < ia_grp_ox.size(); ++gx) {
+    node_num += ens[ia_grp_ox.get(gx)]->tree(ia_grp_tx.get(gx))->nodeNum(); 
+  }
+  for (tx = 0; tx < max_t_num; ++tx) {
+    for (ox = 0; ox < out_num; ++ox) {
+      gx = ia_grp.get(tx*out_num+ox); 
+      if (gx >= 0) path_num += ens[ia_grp_ox.get(gx)]->tree(tx)->nodeNum(); 
+    }
+  }
+
+  ia_root.reset(); 
+  ia_ux.reset(); 
+  ia_gt.reset(); 
+  ia_ux2fx.reset(); 
+  ia_use_begin.reset(); 
+  ia_use_out.reset(); 
+  ia_use_offs.reset(); 
+  v_border.reform(node_num); 
+  v_path.reform(path_num); 
+  AzIntArr ia_fx2ux(max_fx+1, -1); 
+  int path_used = 0; 
+  for (gx = 0; gx < ia_grp_ox.size(); ++gx) { /* in the order of positions */
+    tx = ia_grp_tx.get(gx); 
+    const AzTree *packed = ens[ia_grp_ox.get(gx)]->tree(tx); 
+    ia_use_begin.put(ia_use_out.size()); 
+    addTree(packed, &ia_fx2ux); 
+    for (ox = 0; ox < out_num; ++ox) {
+      if (ia_grp.get(tx*out_num+ox) != gx) continue; 
+      addUse(packed, ens[ox]->tree(tx), ox, path_used); 
+      path_used += packed->nodeNum(); 
+    }
+  }
+  ia_use_begin.put(ia_use_out.size()); 
+  t_num = ia_root.size(); 
+  if (out_num > 0) {
+    AzTE_ModelInfo info; 
+    ens[0]->info(&info); 
+    s_sign.reset(&info.s_sign); 
+    s_config.reset(&info.s_config); 
+  }
+  set_pointers(); 
+}
+
+/*--------------------------------------------------------*/
+void AzTreeEnsembleFlat::set_pointers()
+{
+  node_num = ia_ux.size(); 
+  u_num = ia_ux2fx.size(); 
+  use_num = ia_use_out.size(); 
+  path_num = v_path.rowNum(); 
+  p_const = v_const.point(); 
+  p_root = ia_root.point(); 
+  p_use_begin = ia_use_begin.point(); 
+  p_ux = ia_ux.point(); 
+  p_gt = ia_gt.point(); 
+  p_border = v_border.point(); 
+  p_ux2fx = ia_ux2fx.point(); 
+  p_use_out = ia_use_out.point(); 
+  p_use_offs = ia_use_offs.point(); 
+  p_path = v_path.point(); 
+}
+
+/*--------------------------------------------------------*/
+void AzTreeEnsembleFlat::info(AzTE_ModelInfo *out_info) const
+{
+  if (out_info == NULL) return; 
+  out_info->tree_num = org_tree_num; 
+  out_info->leaf_num = org_leaf_num; 
+  out_info->s_sign.reset(&s_sign); 
+  out_info->s_config.reset(&s_config); 
+}
+
+/*--------------------------------------------------------*/
+/* true if large is tree with more nodes split */
+bool AzTreeEnsembleFlat::isPrefix(const AzTree *tree, 
+                                  const AzTree *large)
+{
+  if (tree->nodeNum() > large->nodeNum() || 
+      tree->root() != large->root()) {
+    return false; 
+  }
+  int nx; 
+  for (nx = 0; nx < tree->nodeNum(); ++nx) {
+    const AzTreeNode *np = tree->node(nx); 
+    if (np->isLeaf()) continue; 
+    const AzTreeNode *lp = large->node(nx); 
+    if (lp->isLeaf() || 
+        np->fx != lp->fx || np->border_val != lp->border_val || 
+        np->le_nx != lp->le_nx || np->gt_nx != lp->gt_nx) {
+      return false; 
+    }
+  }
+  return true; 
+}
+
+/*--------------------------------------------------------*/
+void AzTreeEnsembleFlat::addTree(const AzTree *tree,
+                                 AzIntArr *ia_fx2ux) /* inout */
+{
+  const char *eyec = "AzTreeEnsembleFlat::addTree"; 
+  if (tree->nodeNum() <= 0) {
+    throw new AzException(eyec, "empty tree"); 
+  }
+  ia_root.put(ia_ux.size()); 
+
+  /*---  depth-first; le-child right after its parent  ---*/
+  AzIntArr ia_stack_nx, ia_stack_parent; 
+  ia_stack_nx.put(tree->root()); 
+  ia_stack_parent.put(-1); 
+  for ( ; ia_stack_nx.size() > 0; ) {
+    int sz = ia_stack_nx.size() - 1; 
+    int nx = ia_stack_nx.get(sz); 
+    int parent = ia_stack_parent.get(sz); 
+    ia_stack_nx.cut(sz); 
+    ia_stack_parent.cut(sz); 
+    if (nx < 0 || ia_ux.size() >= v_border.rowNum()) {
+      throw new AzException(eyec, "broken tree"); 
+    }
+
+    const AzTreeNode *np = tree->node(nx); 
+    int node_no = ia_ux.size(); 
+    if (parent >= 0) ia_gt.update(parent, node_no); 
+    if (np->isLeaf()) {
+      ia_ux.put(-1); 
+      ia_gt.put(-1); 
+      v_border.set(node_no, 0); 
+      continue; 
+    }
+
+    int ux = ia_fx2ux->get(np->fx); 
+    if (ux < 0) {
+      ux = ia_ux2fx.size(); 
+      ia_ux2fx.put(np->fx); 
+      ia_fx2ux->update(np->fx, ux); 
+    }
+    ia_ux.put(ux); 
+    ia_gt.put(-1); /* set when the gt-child is added */
+    v_border.set(node_no, np->border_val); 
+
+    /*---  gt-child first so that le-child comes out next  ---*/
+    ia_stack_nx.put(np->gt_nx); ia_stack_parent.put(node_no); 
+    ia_stack_nx.put(np->le_nx); ia_stack_parent.put(-1); 
+  }
+}
+
+/*--------------------------------------------------------*/
+/* Set the value of each leaf of the packed tree for output ox: */
+/* the sum of the weights of tree from root to its leaf above.  */
+/* Called right after adding the packed tree.                   */
+/*--------------------------------------------------------*/
+void AzTreeEnsembleFlat::addUse(const AzTree *packed, 
+                                const AzTree *tree, /* packed or its prefix */
+                                int ox, 
+                                int path_offs) /* where the values go in v_path */
+{
+  int root_no = ia_root.get(ia_root.size()-1); 
+  ia_use_out.put(ox); 
+  ia_use_offs.put(path_offs - root_no); 
+  double *path = v_path.point_u() + path_offs; 
+
+  /*---  the same order as addTree  ---*/
+  AzIntArr ia_stack_nx, ia_stack_done; 
+  AzDvect v_stack_path(packed->nodeNum()); 
+  int sz = 0; 
+  ia_stack_nx.put(packed->root()); 
+  ia_stack_done.put(0); 
+  v_stack_path.set(sz++, 0); 
+  int node_no = 0; /* relative to the root */
+  for ( ; sz > 0; ++node_no) {
+    --sz; 
+    int nx = ia_stack_nx.get(sz); 
+    int isDone = ia_stack_done.get(sz); 
+    double val = v_stack_path.get(sz); 
+    ia_stack_nx.cut(sz); 
+    ia_stack_done.cut(sz); 
+
+    if (!isDone) {
+      const AzTreeNode *np = tree->node(nx); 
+      val += np->weight; 
+      if (np->isLeaf()) isDone = 1; /* the rest of the path is not in tree */
+    }
+    const AzTreeNode *pp = packed->node(nx); 
+    if (pp->isLeaf()) {
+      path[node_no] = val; 
+      continue; 
+    }
+    ia_stack_nx.put(pp->gt_nx); ia_stack_done.put(isDone); 
+    v_stack_path.set(sz++, val); 
+    ia_stack_nx.put(pp->le_nx); ia_stack_done.put(isDone); 
+    v_stack_path.set(sz++, val); 
+  }
+}
+
+/*--------------------------------------------------------*/
+void AzTreeEnsembleFlat::apply(const AzSmat *m_data,
+                               AzDvect *v_pred, /* output */
+                               int num_threads) const
+{
+  if (out_num != 1) {
+    throw new AzException("AzTreeEnsembleFlat::apply", "multi-output; use AzDmat for the output"); 
+  }
+  v_pred->reform(m_data->colNum()); 
+  apply_all(m_data, v_pred->point_u(), num_threads); 
+}
+
+/*--------------------------------------------------------*/
+void AzTreeEnsembleFlat::apply(const AzSmat *m_data,
+                               AzDmat *m_pred, /* output */
+                               int num_threads) const
+{
+  int data_num = m_data->colNum(); 
+  AzDvect v_pred(data_num*out_num); 
+  apply_all(m_data, v_pred.point_u(), num_threads); 
+  m_pred->reform(out_num, data_num); 
+  const double *pred = v_pred.point(); 
+  int dx; 
+  for (dx = 0; dx < data_num; ++dx) {
+    m_pred->col_u(dx)->set(pred + (AZint8)dx*out_num, out_num); 
+  }
+}
+
+/*--------------------------------------------------------*/
+void AzTreeEnsembleFlat::apply_all(const AzSmat *m_data,
+                                   double *pred, /* output: [data_num*out_num] */
+                                   int num_threads) const
+{
+  const char *eyec = "AzTreeEnsembleFlat::apply_all"; 
+  int data_num = m_data->colNum(); 
+  int f_num = m_data->rowNum(); 
+
+  AzIntArr ia_fx2ux(f_num, -1); 
+  int ux; 
+  for (ux = 0; ux < u_num; ++ux) {
+    int fx = p_ux2fx[ux]; 
+    if (fx >= f_num) {
+      throw new AzException(AzInputError, eyec, "the model uses a feature beyond the data dimensionality"); 
+    }
+    ia_fx2ux.update(fx, ux); 
+  }
+  const int *fx2ux = ia_fx2ux.point(); 
+
+  int block_size = MAX(1, MIN(data_num, block_entries / MAX(1, u_num))); 
+  int block_num = (data_num + block_size - 1) / block_size; 
+  int th_num = AzThreads::threadNum(num_threads, block_num); 
+  if (th_num <= 1) {
+    apply_range(m_data, fx2ux, 0, data_num, block_size, pred); 
+    return; 
+  }
+
+  /*---  each thread writes to its own range of pred[]  ---*/
+  AzThreadErr th_err; 
+  int thx; 
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(th_num) schedule(static,1)
+#endif
+  for (thx = 0; thx < th_num; ++thx) {
+    try {
+      int bx_begin, bx_end; 
+      AzThreads::range(th_num, thx, block_num, &bx_begin, &bx_end); 
+      int dx_end = MIN(data_num, bx_end*block_size); 
+      apply_range(m_data, fx2ux, bx_begin*block_size, dx_end, block_size, pred); 
+    }
+    catch (AzException *e) {
+      th_err.keep(e); 
+    }
+  }
+  th_err.throw_if(); 
+}
+
+/*--------------------------------------------------------*/
+void AzTreeEnsembleFlat::apply_range(const AzSmat *m_data,
+                                     const int *fx2ux,
+                                     int dx_begin, int dx_end,
+                                     int block_size,
+                                     double *pred) /* output: [data_num*out_num] */
+const
+{
+  AzDvect v_x(MAX(1, block_size*u_num)); 
+  double *x = v_x.point_u(); 
+  int dx0; 
+  for (dx0 = dx_begin; dx0 < dx_end; dx0 += block_size) {
+    int bsz = MIN(block_size, dx_end - dx0); 
+    /*---  densify the used features  ---*/
+    v_x.zeroOut(); 
+    int bx; 
+    for (bx = 0; bx < bsz; ++bx) {
+      const AzSvect *v_data = m_data->col(dx0+bx); 
+      double *xrow = x + (AZint8)bx*u_num; 
+      AzCursor cur; 
+      for ( ; ; ) {
+        double val; 
+        int fx = v_data->next(cur, val); 
+        if (fx < 0) break; 
+        int ux = fx2ux[fx]; 
+        if (ux >= 0) xrow[ux] = val; 
+      }
+    }
+    apply_block(x, bsz, pred+(AZint8)dx0*out_num); 
+  }
+}
+
+/*--------------------------------------------------------*/
+void AzTreeEnsembleFlat::apply_block(const double *x,
+                                     int block_size,
+                                     double *pred) /* output */
+const
+{
+  const int *ux = p_ux; 
+  const int *gt = p_gt; 
+  const double *border = p_border; 
+  const double *path = p_path; 
+  const int *use_begin = p_use_begin; 
+  const int *use_out = p_use_out; 
+  const int *use_offs = p_use_offs; 
+
+  int bx; 
+  for (bx = 0; bx < block_size; ++bx) {
+    int ox; 
+    for (ox = 0; ox < out_num; ++ox) pred[bx*out_num+ox] = p_const[ox]; 
+  }
+  int tx; 
+  for (tx = 0; tx < t_num; ++tx) {
+    int root = p_root[tx]; 
+    for (bx = 0; bx < block_size; ++bx) {
+      const double *xrow = x + (AZint8)bx*u_num; 
+      int nx = root; 
+      while (ux[nx] >= 0) {
+        if (xrow[ux[nx]] <= border[nx]) ++nx; 
+        else                            nx = gt[nx]; 
+      }
+      double *p = pred + bx*out_num; 
+      int uu; 
+      for (uu = use_begin[tx]; uu < use_begin[tx+1]; ++uu) {
+        p[use_out[uu]] += path[use_offs[uu]+nx]; 
+      }
+    }
+  }
+}
+
+/*--------------------------------------------------------*/
+AZint8 AzTreeEnsembleFlat::layout(const int *hd, /* [hd_num] */
+                                  AZint8 *offs, /* output: [sec_num] */
+                                  AZint8 *len) /* output: [sec_num] */
+{
+  AZint8 isz = sizeof(int), dsz = sizeof(double); 
+  len[sec_const] = dsz*hd[hd_out_num]; 
+  len[sec_root] = isz*hd[hd_t_num]; 
+  len[sec_use_begin] = isz*(hd[hd_t_num]+1); 
+  len[sec_ux] = isz*hd[hd_node_num]; 
+  len[sec_gt] = isz*hd[hd_node_num]; 
+  len[sec_border] = dsz*hd[hd_node_num]; 
+  len[sec_ux2fx] = isz*hd[hd_u_num]; 
+  len[sec_use_out] = isz*hd[hd_use_num]; 
+  len[sec_use_offs] = isz*hd[hd_use_num]; 
+  len[sec_path] = dsz*hd[hd_path_num]; 
+  len[sec_sign] = hd[hd_sign_len]; 
+  len[sec_config] = hd[hd_config_len]; 
+  AZint8 pos = header_size; 
+  int sx; 
+  for (sx = 0; sx < sec_num; ++sx) {
+    offs[sx] = pos; 
+    pos += (len[sx] + 7) / 8 * 8; 
+  }
+  return pos; /* file size */
+}
+
+/*--------------------------------------------------------*/
+void AzTreeEnsembleFlat::write(const char *fn) const
+{
+  int hd[hd_num]; 
+  hd[hd_version] = packed_version; 
+  hd[hd_endian] = endian_mark; 
+  hd[hd_out_num] = out_num; 
+  hd[hd_t_num] = t_num; 
+  hd[hd_node_num] = node_num; 
+  hd[hd_u_num] = u_num; 
+  hd[hd_use_num] = use_num; 
+  hd[hd_path_num] = path_num; 
+  hd[hd_orgdim] = org_dim; 
+  hd[hd_tree_num] = org_tree_num; 
+  hd[hd_leaf_num] = org_leaf_num; 
+  hd[hd_sign_len] = s_sign.length(); 
+  hd[hd_config_len] = s_config.length(); 
+  AZint8 offs[sec_num], len[sec_num]; 
+  AZint8 f_size = layout(hd, offs, len); 
+
+  const void *sec[sec_num]; 
+  sec[sec_const] = p_const; 
+  sec[sec_root] = p_root; 
+  sec[sec_use_begin] = p_use_begin; 
+  sec[sec_ux] = p_ux; 
+  sec[sec_gt] = p_gt; 
+  sec[sec_border] = p_border; 
+  sec[sec_ux2fx] = p_ux2fx; 
+  sec[sec_use_out] = p_use_out; 
+  sec[sec_use_offs] = p_use_offs; 
+  sec[sec_path] = p_path; 
+  sec[sec_sign] = s_sign.point(); 
+  sec[sec_config] = s_config.point(); 
+
+  AzFile file(fn); 
+  file.open("wb"); 
+  AzBytArr ba_head; 
+  AzByte *head = ba_head.reset(header_size, 0); 
+  memcpy(head, packed_magic, sizeof(packed_magic)); 
+  memcpy(head+sizeof(packed_magic), hd, sizeof(hd)); 
+  file.writeBytes(head, header_size); 
+  AzBytArr ba_pad; 
+  const AzByte *pad = ba_pad.reset(8, 0); 
+  int sx; 
+  for (sx = 0; sx < sec_num; ++sx) {
+    AZint8 end = (sx+1 < sec_num) ? offs[sx+1] : f_size; 
+    if (len[sx] > 0) file.writeBytes(sec[sx], len[sx]); 
+    if (end > offs[sx] + len[sx]) file.writeBytes(pad, end - offs[sx] - len[sx]); 
+  }
+  file.close(true); 
+}
+
+/*--------------------------------------------------------*/
+bool AzTreeEnsembleFlat::isPacked(const char *fn)
+{
+  AzFile file(fn); 
+  file.open("rb"); 
+  bool isPacked = false; 
+  if (file.size() >= header_size) {
+    char magic[sizeof(packed_magic)]; 
+    file.readBytes(magic, sizeof(magic)); 
+    isPacked = (memcmp(magic, packed_magic, sizeof(magic)) == 0); 
+  }
+  file.close(); 
+  return isPacked; 
+}
+
+/*--------------------------------------------------------*/
+void AzTreeEnsembleFlat::map(const char *fn)
+{
+  const char *eyec = "AzTreeEnsembleFlat::map"; 
+  unmap(); 
+  v_const.reform(0); ia_root.reset(); ia_ux.reset(); ia_gt.reset(); 
+  v_border.reform(0); ia_ux2fx.reset(); ia_use_begin.reset(); 
+  ia_use_out.reset(); ia_use_offs.reset(); v_path.reform(0); 
+#ifdef _WIN32
+  AzFile file(fn); 
+  file.open("rb"); 
+  map_len = file.size(); 
+  map_ptr = ba_map.reset(file.size_under2G(eyec), 0); 
+  file.readBytes(map_ptr, map_len); 
+  file.close(); 
+#else
+  int fd = open(fn, O_RDONLY); 
+  if (fd < 0) {
+    throw new AzException(AzFileIOError, eyec, fn, strerror(errno)); 
+  }
+  struct stat st; 
+  if (fstat(fd, &st) != 0) {
+    close(fd); 
+    throw new AzException(AzFileIOError, eyec, fn, strerror(errno)); 
+  }
+  map_len = st.st_size; 
+  if (map_len < header_size) {
+    close(fd); 
+    throw new AzException(AzInputError, eyec, "Not a packed model file: ", fn); 
+  }
+  void *ptr = mmap(NULL, (size_t)map_len, PROT_READ, MAP_SHARED, fd, 0); 
+  close(fd); /* the mapping stays */
+  if (ptr == MAP_FAILED) {
+    map_len = 0; 
+    throw new AzException(AzFileIOError, eyec, fn, strerror(errno)); 
+  }
+  map_ptr = (AzByte *)ptr; 
+#endif
+  s_map_fn.reset(fn); 
+
+  try {
+    check_packed(fn); 
+  }
+  catch (AzException *e) {
+    unmap(); 
+    throw e; 
+  }
+  const int *hd = (const int *)(map_ptr + sizeof(packed_magic)); 
+  AZint8 offs[sec_num], len[sec_num]; 
+  layout(hd, offs, len); 
+  out_num = hd[hd_out_num]; 
+  t_num = hd[hd_t_num]; 
+  node_num = hd[hd_node_num]; 
+  u_num = hd[hd_u_num]; 
+  use_num = hd[hd_use_num]; 
+  path_num = hd[hd_path_num]; 
+  org_dim = hd[hd_orgdim]; 
+  org_tree_num = hd[hd_tree_num]; 
+  org_leaf_num = hd[hd_leaf_num]; 
+  s_sign.reset(map_ptr+offs[sec_sign], hd[hd_sign_len]); 
+  s_config.reset(map_ptr+offs[sec_config], hd[hd_config_len]); 
+  p_const = (const double *)(map_ptr+offs[sec_const]); 
+  p_root = (const int *)(map_ptr+offs[sec_root]); 
+  p_use_begin = (const int *)(map_ptr+offs[sec_use_begin]); 
+  p_ux = (const int *)(map_ptr+offs[sec_ux]); 
+  p_gt = (const int *)(map_ptr+offs[sec_gt]); 
+  p_border = (const double *)(map_ptr+offs[sec_border]); 
+  p_ux2fx = (const int *)(map_ptr+offs[sec_ux2fx]); 
+  p_use_out = (const int *)(map_ptr+offs[sec_use_out]); 
+  p_use_offs = (const int *)(map_ptr+offs[sec_use_offs]); 
+  p_path = (const double *)(map_ptr+offs[sec_path]); 
+}
+
+/*--------------------------------------------------------*/
+/* The header, and every index so that a broken file can't */
+/* make apply() go out of range.  The values aren't read.  */
+/*--------------------------------------------------------*/
+void AzTreeEnsembleFlat::check_packed(const char *fn) const
+{
+  const char *eyec = "AzTreeEnsembleFlat::check_packed"; 
+  if (map_len < header_size || memcmp(map_ptr, packed_magic, sizeof(packed_magic)) != 0) {
+    throw new AzException(AzInputError, eyec, "Not a packed model file: ", fn); 
+  }
+  const int *hd = (const int *)(map_ptr + sizeof(packed_magic)); 
+  if (hd[hd_endian] != endian_mark) {
+    throw new AzException(AzInputError, eyec, "The packed model was written on a machine with another byte order: ", fn); 
+  }
+  if (hd[hd_version] != packed_version) {
+    throw new AzException(AzInputError, eyec, "Unknown version of packed model: ", fn); 
+  }
+  int hx; 
+  for (hx = hd_out_num; hx < hd_num; ++hx) {
+    if (hd[hx] < 0 && hx != hd_orgdim) {
+      throw new AzException(AzInputError, eyec, "Broken header: ", fn); 
+    }
+  }
+  AZint8 offs[sec_num], len[sec_num]; 
+  if (layout(hd, offs, len) != map_len) {
+    throw new AzException(AzInputError, eyec, "Wrong file size; broken or truncated: ", fn); 
+  }
+
+  int node_num = hd[hd_node_num], u_num = hd[hd_u_num], t_num = hd[hd_t_num]; 
+  int use_num = hd[hd_use_num], path_num = hd[hd_path_num], out_num = hd[hd_out_num]; 
+  const int *root = (const int *)(map_ptr+offs[sec_root]); 
+  const int *use_begin = (const int *)(map_ptr+offs[sec_use_begin]); 
+  const int *ux = (const int *)(map_ptr+offs[sec_ux]); 
+  const int *gt = (const int *)(map_ptr+offs[sec_gt]); 
+  const int *use_out = (const int *)(map_ptr+offs[sec_use_out]); 
+  const int *use_offs = (const int *)(map_ptr+offs[sec_use_offs]); 
+  const int *ux2fx = (const int *)(map_ptr+offs[sec_ux2fx]); 
+  bool isOk = (use_begin[0] == 0 && use_begin[t_num] == use_num); 
+  int ux_no; 
+  for (ux_no = 0; ux_no < u_num && isOk; ++ux_no) {
+    if (ux2fx[ux_no] < 0) isOk = false; 
+  }
+  int tx; 
+  for (tx = 0; tx < t_num && isOk; ++tx) {
+    int end = (tx+1 < t_num) ? root[tx+1] : node_num; 
+    if (root[tx] < 0 || root[tx] >= end || use_begin[tx] > use_begin[tx+1]) isOk = false; 
+    int nx; 
+    for (nx = root[tx]; nx < end && isOk; ++nx) {
+      if (ux[nx] >= u_num || 
+          (ux[nx] >= 0 && (nx+1 >= end || gt[nx] <= nx || gt[nx] >= end))) isOk = false; 
+    }
+    int uu; 
+    for (uu = use_begin[tx]; uu < use_begin[tx+1] && isOk; ++uu) {
+      AZint8 first = (AZint8)use_offs[uu] + root[tx], last = (AZint8)use_offs[uu] + end - 1; 
+      if (use_out[uu] < 0 || use_out[uu] >= out_num || first < 0 || last >= path_num) isOk = false; 
+    }
+  }
+  if (!isOk) {
+    throw new AzException(AzInputError, eyec, "Broken packed model: ", fn); 
+  }
+}
+
+/*--------------------------------------------------------*/
+void AzTreeEnsembleFlat::unmap()
+{
+  if (map_ptr == NULL) return; 
+#ifdef _WIN32
+  ba_map.reset(); 
+#else
+  munmap(map_ptr, (size_t)map_len); 
+#endif
+  map_ptr = NULL; 
+  map_len = 0; 
+  s_map_fn.reset(); 
+  t_num = out_num = 0; 
+  clear_info(); 
+  set_pointers(); 
+}
@@ -0,0 +1,186 @@
+/* * * * *
+ *  AzTreeEnsembleFlat.hpp
+ *  Copyright (C) 2011, 2012 Rie Johnson
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * */
+
+#ifndef _AZ_TREE_ENSEMBLE_FLAT_HPP_
+#define _AZ_TREE_ENSEMBLE_FLAT_HPP_
+
+#include "AzUtil.hpp"
+#include "AzSmat.hpp"
+#include "AzDmat.hpp"
+#include "AzTreeEnsemble.hpp"
+#include "AzThreads.hpp"
+
+//! Read-only copy of AzTreeEnsemble laid out for fast prediction.
+/*-------------------------------------------------------------------
+ *  The nodes of all the trees are packed into flat arrays in
+ *  depth-first order so that the le-child of node#i is node#(i+1).
+ *  Each leaf keeps the sum of the weights on its path, which is
+ *  what AzTree::apply adds up, in the same order; therefore, the
+ *  predictions are the same as AzTreeEnsemble::apply.
+ *  Data points are processed in blocks, one tree at a time, after
+ *  copying to a dense buffer the features used by the ensemble.
+ *  With multiple threads, each thread takes a contiguous range of
+ *  data points with its own buffer.
+ *  Given several ensembles (a multi-output model, or the models saved
+ *  at the check points of one training run), the trees of all of them
+ *  are packed together, and each data point is densified once for all
+ *  the outputs.  Moreover, the trees at the same position that share
+ *  structure (one is the other with more nodes split, as happens
+ *  between the snapshots of training) are packed once as the largest
+ *  of them, and each ensemble keeps only the value of each leaf of the
+ *  packed tree, i.e., the path sum of its own leaf above it.  A data
+ *  point goes down such a tree once, and then one value is added per
+ *  ensemble.
+ *  write() saves the arrays as they are (a packed model file), and
+ *  map() maps such a file into memory and scores from it directly,
+ *  so that loading is instant and the processes using the same model
+ *  share it through the page cache.
+ *-------------------------------------------------------------------*/
+class AzTreeEnsembleFlat {
+protected:
+  int t_num; 
+  int out_num; 
+  AzDvect v_const;   /* output# -> constant */
+  AzIntArr ia_root;  /* tree# -> node# of the root */
+  AzIntArr ia_ux;    /* node# -> used feature#; -1 if leaf */
+  AzIntArr ia_gt;    /* node# -> node# of the gt-child */
+  AzDvect v_border;  /* node# -> border value */
+  AzIntArr ia_ux2fx; /* used feature# -> feature# */
+
+  /*---  tree# -> the outputs using the tree: [ia_use_begin[tx], ia_use_begin[tx+1])  ---*/
+  AzIntArr ia_use_begin; 
+  AzIntArr ia_use_out;  /* use# -> output# */
+  AzIntArr ia_use_offs; /* use# -> offset into v_path so that v_path[offs+node#] is the leaf value */
+  AzDvect v_path;       /* sum of weights from root to the leaf of the output */
+
+  /*---  model info  ---*/
+  int org_dim, org_tree_num, org_leaf_num; 
+  AzBytArr s_sign, s_config; 
+
+  /*---  what apply() reads: the arrays above, or a packed file  ---*/
+  int node_num, u_num, use_num, path_num; 
+  const double *p_const, *p_border, *p_path; 
+  const int *p_root, *p_ux, *p_gt, *p_ux2fx, *p_use_begin, *p_use_out, *p_use_offs; 
+
+  /*---  packed file mapped by map()  ---*/
+  AzBytArr s_map_fn; 
+  AzByte *map_ptr; 
+  AZint8 map_len; 
+#ifdef _WIN32
+  AzBytArr ba_map; /* no mmap; read into memory */
+#endif
+
+  static const int block_entries = 32768; /* dense buffer size */
+
+  /*---  packed file: magic, header, and sections aligned to 8 bytes  ---*/
+  static const int packed_version = 1; 
+  static const int header_size = 128; 
+  static const int endian_mark = 0x01020304; 
+  enum { hd_version, hd_endian, hd_out_num, hd_t_num, hd_node_num, hd_u_num, 
+         hd_use_num, hd_path_num, hd_orgdim, hd_tree_num, hd_leaf_num, 
+         hd_sign_len, hd_config_len, hd_num }; 
+  enum { sec_const, sec_root, sec_use_begin, sec_ux, sec_gt, sec_border, 
+         sec_ux2fx, sec_use_out, sec_use_offs, sec_path, sec_sign, sec_config, 
+         sec_num }; 
+
+public:
+  AzTreeEnsembleFlat() : t_num(0), out_num(0), map_ptr(NULL), map_len(0) {
+    clear_info(); 
+    set_pointers(); 
+  }
+  AzTreeEnsembleFlat(const AzTreeEnsemble *ens) : t_num(0), out_num(0), map_ptr(NULL), map_len(0) {
+    reset(ens); 
+  }
+  AzTreeEnsembleFlat(const AzTreeEnsemble *const *ens, int ens_num) : t_num(0), out_num(0), map_ptr(NULL), map_len(0) {
+    reset(ens, ens_num); 
+  }
+  ~AzTreeEnsembleFlat() {
+    unmap(); 
+  }
+  void reset(const AzTreeEnsemble *ens) {
+    reset(&ens, 1); 
+  }
+  void reset(const AzTreeEnsemble *const *ens, /* [ens_num] */
+             int ens_num); 
+
+  //! Packed file: the arrays as they are, to be mapped into memory and used without copying.  
+  void write(const char *fn) const; 
+  void map(const char *fn); /* the file must not change while in use */
+  static bool isPacked(const char *fn); 
+
+  void apply(const AzSmat *m_data,
+             AzDvect *v_pred, /* output */
+             int num_threads=1) /* num_threads= */
+             const; 
+  void apply(const AzSmat *m_data,
+             AzDmat *m_pred, /* output: #output x #data */
+             int num_threads=1) /* num_threads= */
+             const; 
+
+  inline int outNum() const { return out_num; }
+  inline int treeNum() const { return t_num; } /* #distinct tree */
+  inline int nodeNum() const { return node_num; }
+  inline int usedFeatNum() const { return u_num; }
+  inline int orgdim() const { return org_dim; }
+  void info(AzTE_ModelInfo *out_info) const; /* of the ensembles given to reset() */
+
+  /*---  prohibit copy  ---*/
+  AzTreeEnsembleFlat(const AzTreeEnsembleFlat &inp) {
+    throw new AzException("AzTreeEnsembleFlat(const &)", "Don't copy"); 
+  }
+  AzTreeEnsembleFlat & operator =(const AzTreeEnsembleFlat &inp) {
+    if (this == &inp) return *this; 
+    throw new AzException("AzTreeEnsembleFlat:=", "Don't use ="); 
+  }
+
+protected:
+  void addTree(const AzTree *tree,
+               AzIntArr *ia_fx2ux); /* inout */
+  void addUse(const AzTree *packed, /* the tree added last */
+              const AzTree *tree, /* packed or its prefix */
+              int ox, 
+              int path_offs); 
+  static bool isPrefix(const AzTree *tree, 
+                       const AzTree *large); 
+  void apply_all(const AzSmat *m_data,
+                 double *pred, /* output: [data_num*out_num] */
+                 int num_threads) const; 
+
+  void apply_range(const AzSmat *m_data,
+                   const int *fx2ux,
+                   int dx_begin, int dx_end,
+                   int block_size,
+                   double *pred) /* output: [data_num*out_num] */
+                   const; 
+  void apply_block(const double *x, /* [block_size][usedFeatNum()] */
+                   int block_size,
+                   double *pred) /* output: [block_size*out_num] */
+                   const; 
+
+  void set_pointers(); /* to the arrays */
+  void clear_info() {
+    org_dim = org_tree_num = org_leaf_num = -1; 
+    s_sign.reset(); s_config.reset(); 
+  }
+  void unmap(); 
+  void check_packed(const char *fn) const; 
+  static AZint8 layout(const int *hd, /* [hd_num] */
+                       AZint8 *offs, /* output: [sec_num] */
+                       AZint8 *len); /* output: [sec_num] */
+}; 
+#endif
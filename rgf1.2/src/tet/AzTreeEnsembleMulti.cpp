@@ -0,0 +1,136 @@
+/* * * * *
+ *  AzTreeEnsembleMulti.cpp
+ *  Copyright (C) 2011, 2012 Rie Johnson
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * */
+
+
+#include "AzTreeEnsembleMulti.hpp"
+
+/*--------------------------------------------------------*/
+int AzTreeEnsembleMulti::orgdim() const
+{
+  int org_dim = -1; 
+  int ox; 
+  for (ox = 0; ox < outNum(); ++ox) {
+    org_dim = MAX(org_dim, ens(ox)->orgdim()); 
+  }
+  return org_dim; 
+}
+
+/*--------------------------------------------------------*/
+void AzTreeEnsembleMulti::info(AzTE_ModelInfo *out_info) const
+{
+  if (out_info == NULL) return; 
+  out_info->reset(); 
+  if (outNum() <= 0) return; 
+  ens(0)->info(out_info); 
+  int ox; 
+  for (ox = 1; ox < outNum(); ++ox) {
+    out_info->leaf_num += ens(ox)->leafNum(); 
+    out_info->tree_num += ens(ox)->size(); 
+  }
+}
+
+/*--------------------------------------------------------*/
+int AzTreeEnsembleMulti::nodeNum() const
+{
+  int n_num = 0; 
+  int ox; 
+  for (ox = 0; ox < outNum(); ++ox) {
+    n_num += ens(ox)->nodeNum(); 
+  }
+  return n_num; 
+}
+
+/*--------------------------------------------------------*/
+int AzTreeEnsembleMulti::compact()
+{
+  int merged_num = 0; 
+  int ox; 
+  for (ox = 0; ox < outNum(); ++ox) {
+    merged_num += ens_u(ox)->compact(); 
+  }
+  return merged_num; 
+}
+
+/*--------------------------------------------------------*/
+void AzTreeEnsembleMulti::write(const char *fn)
+{
+  AzFile file(fn); 
+  file.open("wb"); 
+  file.writeBinMarker(); 
+  file.writeByte(multi_flag); 
+  int ix; 
+  for (ix = 1; ix < reserved_length; ++ix) file.writeByte(0); 
+  file.writeInt(version); 
+  file.writeInt(outNum()); 
+  int ox; 
+  for (ox = 0; ox < outNum(); ++ox) {
+    ens_u(ox)->write(&file); 
+  }
+  file.close(true); 
+}
+
+/*--------------------------------------------------------*/
+void AzTreeEnsembleMulti::read(const char *fn)
+{
+  const char *eyec = "AzTreeEnsembleMulti::read"; 
+  AzFile file(fn); 
+  file.open("rb"); 
+  file.checkBinMarker(); 
+  if (file.readByte() != multi_flag) {
+    throw new AzException(AzInputNotValid, eyec, fn, "Not a multi-output model file"); 
+  }
+  int ix; 
+  for (ix = 1; ix < reserved_length; ++ix) {
+    AzByte byte = file.readByte(); 
+    if (byte != 0) {
+      throw new AzException(AzInputNotValid, eyec, fn,
+            "Error detected in the reserved field.  Broken file or version conflict"); 
+    }
+  }
+  int inp_version = file.readInt(); 
+  if (inp_version != version) {
+    throw new AzException(AzInputNotValid, eyec, fn, "Version conflict"); 
+  }
+  int out_num = file.readInt(); 
+  if (out_num <= 0) {
+    throw new AzException(AzInputNotValid, eyec, fn, "Broken file"); 
+  }
+  arr_ens.reset(out_num); 
+  int ox; 
+  for (ox = 0; ox < out_num; ++ox) {
+    arr_ens.point_u(ox)->read(&file); 
+  }
+  file.close(); 
+}
+
+/*--------------------------------------------------------*/
+bool AzTreeEnsembleMulti::isMultiOutput(const char *fn)
+{
+  AzFile file(fn); 
+  file.open("rb"); 
+  bool isMulti = false; 
+  try {
+    file.checkBinMarker(); 
+    isMulti = (file.readByte() == multi_flag); 
+  }
+  catch (AzException *e) {
+    delete e; /* not a model file; let the reader report it */
+  }
+  file.close(); 
+  return isMulti; 
+}
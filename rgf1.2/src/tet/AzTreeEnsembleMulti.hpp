@@ -0,0 +1,62 @@
+/* * * * *
+ *  AzTreeEnsembleMulti.hpp
+ *  Copyright (C) 2011, 2012 Rie Johnson
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * */
+
+
+#ifndef _AZ_TREE_ENSEMBLE_MULTI_HPP_
+#define _AZ_TREE_ENSEMBLE_MULTI_HPP_
+
+#include "AzUtil.hpp"
+#include "AzTreeEnsemble.hpp"
+
+//! Multi-output model: one tree ensemble per class (one-vs-rest).  
+/*-------------------------------------------------------------------
+ *  Written by "train" with num_class=.  The file starts with the
+ *  binary marker like AzTreeEnsemble, but the 1st reserved byte is
+ *  not zero so that it is not mistaken for a single model.
+ *-------------------------------------------------------------------*/
+class AzTreeEnsembleMulti {
+protected:
+  AzDataArr<AzTreeEnsemble> arr_ens; 
+
+  static const int version = 1; 
+  static const int reserved_length = 64; 
+  static const AzByte multi_flag = 'M'; /* the 1st reserved byte */
+
+public:
+  AzTreeEnsembleMulti() {}
+  AzTreeEnsembleMulti(const char *fn) {
+    read(fn); 
+  }
+  inline void reset(int out_num) {
+    arr_ens.reset(out_num); 
+  }
+  inline int outNum() const { return arr_ens.size(); }
+  inline const AzTreeEnsemble *ens(int ox) const { return arr_ens.point(ox); }
+  inline AzTreeEnsemble *ens_u(int ox) { return arr_ens.point_u(ox); }
+  int orgdim() const; 
+  void info(AzTE_ModelInfo *out_info) const; /* #tree and #leaf of all the outputs */
+  int nodeNum() const; 
+  int compact(); /* AzTreeEnsemble::compact on each output */
+
+  void read(const char *fn); 
+  void write(const char *fn); 
+
+  /*---  true if fn is a multi-output model file  ---*/
+  static bool isMultiOutput(const char *fn); 
+}; 
+#endif
@@ -28,7 +28,7 @@
 void help(int argc, const char *argv[])
 {
   cout << "Arguments: action  parameters" <<endl; 
-  cout << "   action: "<<kw_train<<"|"<<kw_predict<<"|"<<kw_train_test<<"|"<<kw_train_predict<<"|"<<kw_features<<endl; 
+  cout << "   action: "<<kw_train<<"|"<<kw_predict<<"|"<<kw_train_test<<"|"<<kw_train_predict<<"|"<<kw_features<<"|"<<kw_prepare_data<<"|"<<kw_serve<<"|"<<kw_sweep<<"|"<<kw_xv<<"|"<<kw_pack_model<<"|"<<kw_compact_model<<"|"<<kw_compile_model<<endl; 
   AzHelp h(log_out); 
   h.set_indent(11); 
   h.set_kw_width(17); 
@@ -43,6 +43,20 @@ void help(int argc, const char *argv[])
   h.item_noquotes(s_kw.c_str(), s_desc.c_str()); 
   s_kw.reset(kw_features); s_kw.c(" ..."); s_desc.reset(help_features); 
   h.item_noquotes(s_kw.c_str(), s_desc.c_str()); 
+  s_kw.reset(kw_prepare_data); s_kw.c(" ..."); s_desc.reset(help_prepare_data); 
+  h.item_noquotes(s_kw.c_str(), s_desc.c_str()); 
+  s_kw.reset(kw_serve); s_kw.c("      ..."); s_desc.reset(help_serve); 
+  h.item_noquotes(s_kw.c_str(), s_desc.c_str()); 
+  s_kw.reset(kw_sweep); s_kw.c("      ..."); s_desc.reset(help_sweep); 
+  h.item_noquotes(s_kw.c_str(), s_desc.c_str()); 
+  s_kw.reset(kw_xv); s_kw.c("         ..."); s_desc.reset(help_xv); 
+  h.item_noquotes(s_kw.c_str(), s_desc.c_str()); 
+  s_kw.reset(kw_pack_model); s_kw.c(" ..."); s_desc.reset(help_pack_model); 
+  h.item_noquotes(s_kw.c_str(), s_desc.c_str()); 
+  s_kw.reset(kw_compact_model); s_kw.c(" ..."); s_desc.reset(help_compact_model); 
+  h.item_noquotes(s_kw.c_str(), s_desc.c_str()); 
+  s_kw.reset(kw_compile_model); s_kw.c(" ..."); s_desc.reset(help_compile_model); 
+  h.item_noquotes(s_kw.c_str(), s_desc.c_str()); 
   cout << endl; 
   cout << "To get help on parameters, enter "<<argv[0]<<" action."<<endl; 
   cout << "For example:  "<<argv[0]<<" "<<kw_train_test<<endl; 
@@ -87,6 +101,27 @@ int main(int argc, const char *argv[])
     else if (strcmp(action, kw_features) == 0) {
       driver.features(argv, argc); 
     }
+    else if (strcmp(action, kw_prepare_data) == 0) {
+      driver.prepare_data(argv, argc); 
+    }
+    else if (strcmp(action, kw_serve) == 0) {
+      driver.serve(argv, argc); 
+    }
+    else if (strcmp(action, kw_sweep) == 0) {
+      driver.sweep(argv, argc); 
+    }
+    else if (strcmp(action, kw_xv) == 0) {
+      driver.xv(argv, argc); 
+    }
+    else if (strcmp(action, kw_pack_model) == 0) {
+      driver.pack_model(argv, argc); 
+    }
+    else if (strcmp(action, kw_compact_model) == 0) {
+      driver.compact_model(argv, argc); 
+    }
+    else if (strcmp(action, kw_compile_model) == 0) {
+      driver.compile_model(argv, argc); 
+    }
     else {
       help(argc, argv); 
       return -1; 